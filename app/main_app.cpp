@@ -7,6 +7,7 @@
 #include <vector>
 #include <string>
 #include <cmath>
+#include <random>
 
 // ImGui
 #include "imgui.h"
@@ -14,7 +15,14 @@
 #include "imgui_impl_opengl3.h"
 
 // Project Headers
-#include "Matrix4x4.hpp"
+#include "Scene.hpp"         // Transform, GameObject i Scene (arrays en preordre)
+#include "SceneStreamer.hpp" // Carrega de subarbres en segon pla
+#include "SceneEdit.hpp"     // Canvis de jerarquia en bloc (arrossegar nodes)
+#include "SceneBuilder.hpp"  // Jerarquies aleatories de prova
+#include "BVH.hpp"           // Arbre de caixes (AABB) del mon, per consultes espacials
+#include "FrustumCuller.hpp" // Descart dels nodes fora de la camera abans de dibuixar
+#include "Picker.hpp"        // Seleccio d'objectes amb el ratoli (raigs contra l'escena)
+#include "JobSystem.hpp"     // Treballs en parallel per frame (UpdateWorld)
 #include "Mesh.hpp"          // Cont la classe Mesh (Cube)
 #include "GraphicsUtils.hpp" // Cont helpers per OpenGL
 //necesito hacer un quat que sea donde esta mirando el objeto, donde tiene que rotat la matriz.
@@ -28,102 +36,6 @@ Vec3 Lerp(const Vec3& a, const Vec3& b, double t)
     };
 }
 
-Quat Slerp(const Quat& a, const Quat& b, double t)
-{
-    Quat q1 = a.Normalized();
-    Quat q2 = b.Normalized();
-
-    double dot = q1.s * q2.s + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
-
-    if (dot < 0.0)
-    {
-        q2.s = -q2.s;
-        q2.x = -q2.x;
-        q2.y = -q2.y;
-        q2.z = -q2.z;
-        dot = -dot;
-    }
-
-    const double DOT_THRESHOLD = 0.9995;
-    if (dot > DOT_THRESHOLD)
-    {
-        Quat result = {
-            q1.s + t * (q2.s - q1.s),
-            q1.x + t * (q2.x - q1.x),
-            q1.y + t * (q2.y - q1.y),
-            q1.z + t * (q2.z - q1.z)
-        };
-        return result.Normalized();
-    }
-
-    double theta_0 = acos(dot);
-    double theta = theta_0 * t;
-    double sin_theta = sin(theta);
-    double sin_theta_0 = sin(theta_0);
-
-    Quat result;
-    result.s = (cos(theta) - dot * sin_theta / sin_theta_0) * q1.s + (sin_theta / sin_theta_0) * q2.s;
-    result.x = (cos(theta) - dot * sin_theta / sin_theta_0) * q1.x + (sin_theta / sin_theta_0) * q2.x;
-    result.y = (cos(theta) - dot * sin_theta / sin_theta_0) * q1.y + (sin_theta / sin_theta_0) * q2.y;
-    result.z = (cos(theta) - dot * sin_theta / sin_theta_0) * q1.z + (sin_theta / sin_theta_0) * q2.z;
-
-    return result.Normalized();
-}
-// TODO: Placeholder
-class Transform {
-public:
-    Vec3 position = { 0.0, 0.0, 0.0 };
-    Vec3 rotation = { 0.0, 0.0, 0.0 }; 
-    Vec3 scale = { 1.0, 1.0, 1.0 };
-
-    Transform() {}
-
-    Matrix4x4 GetLocalMatrix() const {
-        const double rad = M_PI / 180.0;
-
-        // Graus a Radians
-        double radX = rotation.x * rad; 
-        double radY = rotation.y * rad; 
-        double radZ = rotation.z * rad; 
-
-        //Crear la Matriu de Rotaci
-        Matrix3x3 matrot = Matrix3x3::FromEulerZYX(radY, radX, radZ);
-
-        // Covertir a TRS
-        return Matrix4x4::FromTRS(position, matrot, scale);
-    }
-};
-class GameObject {
-public:
-    Transform transform;                  
-    GameObject* parent = nullptr;         
-    std::vector<GameObject*> children;    
-
-    GameObject() {}
-
-    // Construir jerarqua 
-    void AddChild(GameObject* child) {
-        if (child) {
-            child->parent = this;       
-            children.push_back(child);  
-        }
-    }
-
-    Matrix4x4 GetGlobalMatrix() {
-        // Matriu local de l'objecte
-        Matrix4x4 localMatrix = transform.GetLocalMatrix();
-
-        //si no es arrel
-        if (parent != nullptr) {
-            Matrix4x4 parentGlobal = parent->GetGlobalMatrix();
-
-            // M_global = M_parent_global * M_local
-            return parentGlobal.Multiply(localMatrix);
-        }
-        //si es arrel
-        return localMatrix;
-    }
-};
 class Camera
 {
 public:
@@ -143,8 +55,8 @@ public:
 
     Matrix4x4 GetViewMatrix()
     {
-        Matrix4x4 global = transform.GetLocalMatrix();
-        return global.InverseTR();
+        Affine3x4 global = transform.GetLocalAffine();
+        return global.InverseTR().ToMatrix4x4();
     }
 
     Matrix4x4 GetProjectionMatrix() const
@@ -226,33 +138,42 @@ GLuint CreateShaderProgram(const std::string& vertPath, const std::string& fragP
 // -----------------------------------------------------------------------------
 // UI: (TODO)
 // -----------------------------------------------------------------------------
+// La seleccio es guarda com a handles: donen null quan el node s'ha destruit.
+// selectedObject es torna a resoldre al principi de cada frame.
+GameObjectHandle selectedHandle;
+GameObjectHandle lastSelectedHandle;
 GameObject* selectedObject = nullptr;
-GameObject* lastSelectedObject = nullptr;
-Vec3 ExtractWorldScale(const Matrix4x4& m)
-{//me he dado cuenta que al escalar el padre, el focus n tiene cuenta la escala del padre cuando calcula la posicion de la camara del hijo
-  //asi que creo esta funcion para extraer la escala del objeto en el mundo
-    Vec3 xAxis(m.At(0, 0), m.At(1, 0), m.At(2, 0));
-    Vec3 yAxis(m.At(0, 1), m.At(1, 1), m.At(2, 1));
-    Vec3 zAxis(m.At(0, 2), m.At(1, 2), m.At(2, 2));
-
-    return Vec3(
-        xAxis.Norm(),
-        yAxis.Norm(),
-        zAxis.Norm()
-    );
+
+// Caixa de cada mesh en el seu espai, per index de GameObject::GetMesh(), i el BVH de
+// les caixes de l'escena al mon (reajustat despres de UpdateWorld a cada frame)
+std::vector<AABB> meshBounds;
+BVH bvh;
+// Visibilitat de cada node per la camera d'aquest frame (RenderNode salta la resta)
+FrustumCuller culler;
+// Triangles de cada mesh (mateixos index que meshBounds) per seleccionar al viewport.
+// Un clic (boto deixat anar a pocs pixels d'on s'ha premut) fora de la UI es resol
+// despres del reajust del BVH del frame seguent.
+std::vector<PickMesh> pickMeshes;
+Picker picker;
+bool pickRequested = false;
+float pickX = 0.0f, pickY = 0.0f;
+
+// Radi d'una esfera que conte la caixa del node al mon
+float WorldRadius(GameObject* node) {
+    const uint32_t m = node->GetMesh();
+    if (m >= meshBounds.size()) return 0.5f;
+    return (float)meshBounds[m].Transformed(node->GetGlobalAffine()).Extents().Norm();
 }
 void LookAtAll(GameObject* node, Camera& cam) {
 	if (node == nullptr) return;
     
     selectedObject = node;
-    Matrix4x4 objectWorld = selectedObject->GetGlobalMatrix();
-    Vec3 scale = ExtractWorldScale(objectWorld);
+    const Vec3 objectPosition = selectedObject->GetGlobalAffine().GetTranslation();
 
-    float objectRadius = 0.5f * sqrt(scale.x * scale.x + scale.y * scale.y + scale.z * scale.z);
+    float objectRadius = WorldRadius(selectedObject);
     float distance = objectRadius / tan(cam.fovY * 0.5 * M_PI / 180.0);
 
    
-    Vec3 objectPosition = objectWorld.GetTranslation();
     Vec3 cameraposition = cam.transform.position;
   
     Vec3 finalPos = {
@@ -294,7 +215,7 @@ void LookAtAll(GameObject* node, Camera& cam) {
     }
     Vec3 right = Vec3::Cross(worldUp, forward).Normalize();
     Vec3 up = Vec3::Cross(forward, right).Normalize();
-    Matrix4x4 m = Matrix4x4::Identity();;
+    Affine3x4 m = Affine3x4::Identity();
 
     // los vectores para la rotacion=??
     m.At(0, 0) = right.x;   m.At(1, 0) = right.y;   m.At(2, 0) = right.z;
@@ -306,18 +227,16 @@ void LookAtAll(GameObject* node, Camera& cam) {
     m.At(1, 3) = finalPos.y;
     m.At(2, 3) = finalPos.z + distance;
 
-    // fila d abajo para q sea afin
-    m.At(3, 0) = 0.0;
-    m.At(3, 1) = 0.0;
-    m.At(3, 2) = 0.0;
-    m.At(3, 3) = 1.0;
-
-    Quat lookRotation = Quat::FromMatrix3x3(m.GetRotation());
+    // Affine3x4: la fila de baix ja es (0, 0, 0, 1)
+    Vec3 lookPosition, lookScale;
+    Quat lookRotation;
+    m.Decompose(lookPosition, lookRotation, lookScale);
     cam.targetRotation = lookRotation;
-    cam.targetPosition = m.GetTranslation();
+    cam.targetPosition = lookPosition;
     cam.isMoving = true;
     cam.isRotating = true;
-    cam.currentRotation = Quat::FromMatrix3x3(cam.transform.GetLocalMatrix().GetRotation());
+    Vec3 camPosition, camScale;
+    cam.transform.GetLocalAffine().Decompose(camPosition, cam.currentRotation, camScale);
 
 
 
@@ -329,14 +248,11 @@ void LookAt(GameObject* node, Camera& cam) {
     if (node == nullptr) return;
 
     selectedObject = node;
-    Matrix4x4 objectWorld = selectedObject->GetGlobalMatrix();
-    Vec3 objectPosition = objectWorld.GetTranslation();
+    const Vec3 objectPosition = selectedObject->GetGlobalAffine().GetTranslation();
     Vec3 cameraposition = cam.transform.position;
-  
-    Vec3 scale = ExtractWorldScale(objectWorld);
 
   
-    float objectRadius = 0.5f * sqrt(scale.x * scale.x + scale.y * scale.y + scale.z * scale.z);
+    float objectRadius = WorldRadius(selectedObject);
     float distance = objectRadius / tan(cam.fovY * 0.5 * M_PI / 180.0);
     Vec3 finalPos = {
             objectPosition.x,
@@ -372,7 +288,7 @@ void LookAt(GameObject* node, Camera& cam) {
     }
     Vec3 right = Vec3::Cross(worldUp, forward).Normalize();
     Vec3 up = Vec3::Cross(forward, right).Normalize();
-    Matrix4x4 m = Matrix4x4::Identity();;
+    Affine3x4 m = Affine3x4::Identity();
 
     // los vectores para la rotacion=??
     m.At(0, 0) = right.x;   m.At(1, 0) = right.y;   m.At(2, 0) = right.z;
@@ -384,18 +300,16 @@ void LookAt(GameObject* node, Camera& cam) {
     m.At(1, 3) = finalPos.y;
     m.At(2, 3) = finalPos.z + distance;
 
-    // fila d abajo para q sea afin
-    m.At(3, 0) = 0.0;
-    m.At(3, 1) = 0.0;
-    m.At(3, 2) = 0.0;
-    m.At(3, 3) = 1.0;
-
-    Quat lookRotation = Quat::FromMatrix3x3(m.GetRotation());
+    // Affine3x4: la fila de baix ja es (0, 0, 0, 1)
+    Vec3 lookPosition, lookScale;
+    Quat lookRotation;
+    m.Decompose(lookPosition, lookRotation, lookScale);
     cam.targetRotation = lookRotation;
-    cam.targetPosition = m.GetTranslation();
+    cam.targetPosition = lookPosition;
     cam.isMoving = true;
     cam.isRotating = true;
-    cam.currentRotation = Quat::FromMatrix3x3(cam.transform.GetLocalMatrix().GetRotation());
+    Vec3 camPosition, camScale;
+    cam.transform.GetLocalAffine().Decompose(camPosition, cam.currentRotation, camScale);
 
 
 
@@ -406,7 +320,7 @@ void LookAt(GameObject* node, Camera& cam) {
 }
 
 bool wannaLookAt = false;
-void DrawHierarchyNode(GameObject* node, Camera& cam, bool& focusPosition, bool& focusRotation, bool& focusAll)
+void DrawHierarchyNode(GameObject* node, SceneEdit& edits, Camera& cam, bool& focusPosition, bool& focusRotation, bool& focusAll)
 {
     if (!node) return;
 
@@ -417,21 +331,42 @@ void DrawHierarchyNode(GameObject* node, Camera& cam, bool& focusPosition, bool&
     if (node == selectedObject)
         flags |= ImGuiTreeNodeFlags_Selected;
 
-    bool open = ImGui::TreeNodeEx((void*)node, flags, "GameObject");
+    // Els nodes sense nom mantenen l'etiqueta generica
+    const std::string_view name = node->GetName();
+    bool open = name.empty() ? ImGui::TreeNodeEx((void*)node, flags, "GameObject")
+        : ImGui::TreeNodeEx((void*)node, flags, "%.*s", (int)name.size(), name.data());
 
     if (ImGui::IsItemClicked())
     {
         selectedObject = node;
+        selectedHandle = node->GetHandle();
 
-        if (selectedObject != lastSelectedObject)
+        if (selectedHandle != lastSelectedHandle)
         {
            
         }
 
-        lastSelectedObject = selectedObject;
+        lastSelectedHandle = selectedHandle;
 
 
     }
+
+    // Arrossegar un node sobre un altre el fa fill seu sense moure'l del mon. Nomes es
+    // guarda a edits: l'arbre no pot canviar mentre el recorrem
+    if (ImGui::BeginDragDropSource())
+    {
+        const GameObjectHandle handle = node->GetHandle();
+        ImGui::SetDragDropPayload("GAMEOBJECT", &handle, sizeof(handle));
+        const std::string_view label = name.empty() ? std::string_view("GameObject") : name;
+        ImGui::Text("%.*s", (int)label.size(), label.data());
+        ImGui::EndDragDropSource();
+    }
+    if (ImGui::BeginDragDropTarget())
+    {
+        if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("GAMEOBJECT"))
+            edits.Reparent(*static_cast<const GameObjectHandle*>(payload->Data), node->GetHandle(), SceneEdit::Keep::World);
+        ImGui::EndDragDropTarget();
+    }
     if ((focusPosition || focusRotation) && wannaLookAt) {
         LookAt(selectedObject, cam);
         wannaLookAt = false;
@@ -459,7 +394,7 @@ void DrawHierarchyNode(GameObject* node, Camera& cam, bool& focusPosition, bool&
 
     if (cam.isRotating && (focusRotation|| focusAll)) {
 
-        cam.currentRotation = Slerp(cam.currentRotation, cam.targetRotation, 0.1);
+        cam.currentRotation = Quat::Slerp(cam.currentRotation, cam.targetRotation, 0.1, SlerpMode::Fast);
         double yaw, pitch, roll;
         cam.currentRotation.ToEulerZYX(yaw, pitch, roll);
         cam.transform.rotation = Vec3{ pitch * (180.0 / M_PI), yaw * (180.0 / M_PI), roll * (180.0 / M_PI) };
@@ -481,8 +416,8 @@ void DrawHierarchyNode(GameObject* node, Camera& cam, bool& focusPosition, bool&
 
     if (open)
     {
-        for (auto* c : node->children)
-            DrawHierarchyNode(c, cam, focusPosition, focusRotation, focusAll);
+        for (auto* c : node->GetChildren())
+            DrawHierarchyNode(c, edits, cam, focusPosition, focusRotation, focusAll);
         ImGui::TreePop();
     }
 }
@@ -490,24 +425,43 @@ void DrawHierarchyNode(GameObject* node, Camera& cam, bool& focusPosition, bool&
 // -----------------------------------------------------------------------------
 // RENDER (TODO)
 // -----------------------------------------------------------------------------
-void RenderNode(GameObject* node, GLuint shaderProgram, const Matrix4x4& view, const Matrix4x4& proj, Mesh& mesh) {
+// View i Projection s'envien un cop per frame abans del recorregut. Els nodes descartats
+// per culler no es dibuixen; els subarbres del tot fora del frustum no es visiten.
+void RenderNode(GameObject* node, GLuint shaderProgram, Mesh& mesh, const FrustumCuller& culler) {
     if (!node) return;
+    const std::size_t index = node->GetIndex();
+    if (culler.IsSubtreeCulled(index)) return;
 
     // TODO: Implementar el recorregut recursiu de renderitzat
-    Matrix4x4 model = node->GetGlobalMatrix();
-    // 1. Calcular la matriu Model (Global) de l'objecte actual.
-    GraphicsUtils::UploadMVP(shaderProgram, model, view, proj);
-    // 2. Enviar les matrius Model, View i Projection al shader (usant GraphicsUtils).
-    GraphicsUtils::UploadColor(shaderProgram, Vec3(1.0, 0.0, 0.0));
-    // 3. Enviar color (usant GraphicsUtils).
-    mesh.Draw();
-    // 4. Dibuixar la mesh.
-    for (auto* child : node->children) {
-        RenderNode(child, shaderProgram, view, proj, mesh);
+    if (culler.IsVisible(index)) {
+        Matrix4x4GL model = node->GetGlobalMatrix<float, MatrixLayout::ColumnMajor>();
+        // 1. Calcular la matriu Model (Global) de l'objecte actual.
+        GraphicsUtils::UploadMatrix4(shaderProgram, "u_Model", model);
+        // 2. Enviar les matrius Model, View i Projection al shader (usant GraphicsUtils).
+        GraphicsUtils::UploadColor(shaderProgram, Vec3(1.0, 0.0, 0.0));
+        // 3. Enviar color (usant GraphicsUtils).
+        mesh.Draw();
+        // 4. Dibuixar la mesh.
+    }
+    for (auto* child : node->GetChildren()) {
+        RenderNode(child, shaderProgram, mesh, culler);
     }
     // 5. Cridar recursivament RenderNode pels fills.
 }
 
+// Jerarquia aleatoria de n nodes petits, per provar escenes grans (s'executa al fil de
+// carrega: nomes toca la seva propia escena)
+void BuildTestSubtree(Scene& s, std::size_t n) {
+    const std::size_t first = s.Size();
+    RandomHierarchy(s, n, std::random_device{}(), { .rootSpread = 2.0, .childSpread = 2.0, .rotation = 45.0,
+        .rootScale = 0.8, .childScale = 0.8, .maxDepth = 16 });
+    for (std::size_t i = 0; i < n; ++i) {
+        GameObject* node = s.Object(first + i);
+        node->SetName("Node " + std::to_string(i));
+        node->SetTag("Test");
+    }
+}
+
 // -----------------------------------------------------------------------------
 // MAIN (TODO)
 // -----------------------------------------------------------------------------
@@ -553,14 +507,31 @@ int main(int argc, char** argv) {
     // 3. Inicialitzaci de recursos
     Mesh cubeMesh;
     cubeMesh.InitCube();
+    meshBounds = { cubeMesh.triangles.Bounds() };   // Mesh 0
+    pickMeshes = { cubeMesh.triangles };
 
     // TODO: Assegureu-vos de tenir els fitxers vs.glsl i fs.glsl al mateix nivell de l'executable
     GLuint shaderProgram = CreateShaderProgram("vs.glsl", "fs.glsl");
     if (shaderProgram == 0) std::cerr << "Warning: Shaders not loaded properly." << std::endl;
 
     // 4. TODO: Preparar escena Inicial
-    GameObject* rootObject = new GameObject();
-    std::vector<GameObject*> sceneRoots = { rootObject };
+    // Escena desada (Save Scene) o, si no n'hi ha, un objecte arrel
+    const char* sceneFile = "scene.bin";
+    Scene scene;
+    try {
+        scene.Load(sceneFile);
+    }
+    catch (const std::exception&) {
+        scene.CreateObject();   // Objecte arrel
+    }
+    JobSystem jobs;         // Tots els fils del processador
+    SceneStreamer streamer(scene);
+    SceneEdit hierarchyEdits(scene);    // Reparents de la jerarquia, aplicats un cop per frame
+    std::shared_ptr<const StreamRequest> import;    // Ultima importacio, per la barra de progres
+    // Cerca a la jerarquia: prefix del nom o de l'etiqueta, amb els index de l'escena
+    char searchText[128] = "";
+    int searchByTag = 0;
+    std::vector<GameObjectHandle> searchResults;
 
 	Camera mainCamera; //TODO: Inicialitzar la cmera
     mainCamera.transform.position.z = 5.0;
@@ -580,8 +551,15 @@ int main(int argc, char** argv) {
             if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN) {
 
 				mouseclicked = true;
+                if (event.button.button == SDL_BUTTON_LEFT) { pickX = event.button.x; pickY = event.button.y; }
+            }
+			if (event.type == SDL_EVENT_MOUSE_BUTTON_UP) {
+                mouseclicked = false;
+                // Clic, no arrossegament de la camera: seleccio al viewport
+                if (event.button.button == SDL_BUTTON_LEFT && !io.WantCaptureMouse &&
+                    std::fabs(event.button.x - pickX) < 4.0f && std::fabs(event.button.y - pickY) < 4.0f)
+                    pickRequested = true;
             }
-			if (event.type == SDL_EVENT_MOUSE_BUTTON_UP) { mouseclicked = false; }
                 if (event.type==SDL_EVENT_MOUSE_MOTION && mouseclicked && !ImGui::IsAnyItemActive())
                 {
                     float dx = event.motion.xrel;
@@ -624,67 +602,176 @@ int main(int argc, char** argv) {
         }
 
 
+        // --- STREAMING ---
+        // Subarbres carregats en segon pla: s'afegeixen entre frames, 2 ms per frame com a maxim
+        streamer.Update(2.0);
+
         // --- UPDATE UI ---
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplSDL3_NewFrame();
         ImGui::NewFrame();
 
+        selectedObject = scene.Resolve(selectedHandle);
+
         // UI: Jerarquia
         ImGui::Begin("Hierarchy");
         if (ImGui::Button("Add Object to Root")) 
         {
 			//TODO: Afegir un nou GameObject a l'arrel de l'escena
         }
+        if (ImGui::Button("Save Scene"))
+        {
+            try { scene.Save(sceneFile); }
+            catch (const std::exception& e) { std::cerr << e.what() << std::endl; }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Load Scene"))
+        {
+            try { scene.Load(sceneFile); }
+            catch (const std::exception& e) { std::cerr << e.what() << std::endl; }
+        }
+        // Sota l'objecte seleccionat, o a l'arrel
+        if (ImGui::Button("Import Scene"))
+            import = streamer.RequestFile(sceneFile, selectedObject);
+        ImGui::SameLine();
+        if (ImGui::Button("Stream 100k Test Nodes"))
+            import = streamer.Request([](Scene& s) { BuildTestSubtree(s, 100000); }, selectedObject);
+        if (import) {
+            const std::size_t total = import->NodeCount();
+            switch (import->GetState()) {
+            case StreamRequest::State::Queued:
+            case StreamRequest::State::Building: ImGui::Text("Loading..."); break;
+            case StreamRequest::State::Splicing:
+            case StreamRequest::State::Done:
+                ImGui::ProgressBar(total ? float(import->NodesSpliced()) / float(total) : 1.0f);
+                break;
+            case StreamRequest::State::Failed: ImGui::Text("Import failed: %s", import->Error().c_str()); break;
+            case StreamRequest::State::Canceled: ImGui::Text("Import canceled"); break;
+            }
+        }
+        const SceneStreamer::Progress stream = streamer.GetProgress();
+        ImGui::Text("Streaming: %zu nodes pending, %.2f ms last frame, %.2f ms max",
+            stream.nodesPending, stream.lastUpdateMs, stream.maxUpdateMs);
         ImGui::Separator();
-        for (auto* obj : sceneRoots) DrawHierarchyNode(obj, mainCamera, focusPosition, focusRotation, focusAll);
+        ImGui::InputText("Search", searchText, sizeof(searchText));
+        ImGui::RadioButton("Name", &searchByTag, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("Tag", &searchByTag, 1);
+        if (searchText[0]) {
+            // Llista plana dels resultats en lloc de l'arbre (com a molt 200)
+            const std::size_t maxResults = 200;
+            searchResults.clear();
+            if (searchByTag) scene.SearchByTag(searchText, searchResults, maxResults);
+            else scene.SearchByName(searchText, searchResults, maxResults);
+            for (const GameObjectHandle& h : searchResults) {
+                GameObject* node = scene.Resolve(h);
+                const std::string_view name = node->GetName(), tag = node->GetTag();
+                ImGui::PushID((int)h.slot);
+                if (ImGui::Selectable("##result", node == selectedObject)) {
+                    selectedHandle = h;
+                    selectedObject = node;
+                }
+                ImGui::SameLine();
+                ImGui::Text("%.*s  [%.*s]", (int)name.size(), name.data(), (int)tag.size(), tag.data());
+                ImGui::PopID();
+            }
+            if (searchResults.size() == maxResults) ImGui::TextDisabled("(more results)");
+            else if (searchResults.empty()) ImGui::TextDisabled("(no results)");
+        }
+        else {
+            for (auto* obj : scene.Roots()) DrawHierarchyNode(obj, hierarchyEdits, mainCamera, focusPosition, focusRotation, focusAll);
+            ImGui::TextDisabled("(drop here to make it a root)");
+            if (ImGui::BeginDragDropTarget())
+            {
+                if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("GAMEOBJECT"))
+                    hierarchyEdits.Reparent(*static_cast<const GameObjectHandle*>(payload->Data), {}, SceneEdit::Keep::World);
+                ImGui::EndDragDropTarget();
+            }
+            // Tots els canvis de l'arbre en un sol pas. Deixar anar un node sobre el seu
+            // propi subarbre no fa res
+            try {
+                hierarchyEdits.Apply();
+            }
+            catch (const std::invalid_argument&) {
+            }
+        }
+        ImGui::Separator();
+        const Scene::MemoryStats mem = scene.GetMemoryStats();
+        ImGui::Text("%zu nodes, %zu B/node, %zu KiB", mem.nodes, mem.bytesPerNode, mem.reservedBytes / 1024);
+        ImGui::Text("Allocations: %zu pool, %zu arrays", mem.poolAllocations, mem.arrayAllocations);
+        const BVH::Stats tree = bvh.GetStats();
+        ImGui::Text("BVH: %zu leaves, %zu refitted, %zu in, %zu out%s", tree.leaves, tree.updated, tree.inserted, tree.removed, tree.rebuilt ? " (rebuilt)" : "");
+        const FrustumCuller::Stats cull = culler.GetStats();
+        ImGui::Text("Culling: %zu drawn, %zu culled (%zu subtrees outside, %zu inside)",
+            cull.visible, cull.culled, cull.subtreesOutside, cull.subtreesInside);
+        const Picker::Stats pick = picker.GetStats();
+        ImGui::Text("Pick: %.3f ms, %zu objects, %zu triangles tested", pick.ms, pick.objectsTested, pick.trianglesTested);
         ImGui::End();
 
         // UI: Inspector
         ImGui::Begin("Inspector");
         if (selectedObject) {
-            ImGui::Text("Selected: %s", "TODO: <Nom Objecte>");
+            const std::string_view name = selectedObject->GetName();
+            const std::string_view label = name.empty() ? std::string_view("GameObject") : name;
+            ImGui::Text("Selected: %.*s", (int)label.size(), label.data());
+            // Nom i etiqueta: s'apliquen amb Enter (cada text diferent queda a la taula de strings
+            // fins que es torna a carregar l'escena)
+            char nameText[128], tagText[128];
+            std::snprintf(nameText, sizeof(nameText), "%.*s", (int)name.size(), name.data());
+            const std::string_view tag = selectedObject->GetTag();
+            std::snprintf(tagText, sizeof(tagText), "%.*s", (int)tag.size(), tag.data());
+            if (ImGui::InputText("Name", nameText, sizeof(nameText), ImGuiInputTextFlags_EnterReturnsTrue))
+                selectedObject->SetName(nameText);
+            if (ImGui::InputText("Tag", tagText, sizeof(tagText), ImGuiInputTextFlags_EnterReturnsTrue))
+                selectedObject->SetTag(tagText);
             ImGui::Separator();    
 
             float pos[3] = {
-                (float)selectedObject->transform.position.x,
-                (float)selectedObject->transform.position.y,
-                (float)selectedObject->transform.position.z
+                (float)selectedObject->GetTransform().position.x,
+                (float)selectedObject->GetTransform().position.y,
+                (float)selectedObject->GetTransform().position.z
             }; // TODO: Agafar la posici del selectedObject
             if (ImGui::DragFloat3("Position", pos, 0.1f))
             {
-                selectedObject->transform.position = { (double)pos[0], (double)pos[1], (double)pos[2] };
+                selectedObject->SetPosition({ (double)pos[0], (double)pos[1], (double)pos[2] });
 				//TODO: Actualitzar la posici del selectedObject
             }
 
             float rot[3] = {
-                (float)selectedObject->transform.rotation.x,
-                (float)selectedObject->transform.rotation.y,
-                (float)selectedObject->transform.rotation.z
+                (float)selectedObject->GetTransform().rotation.x,
+                (float)selectedObject->GetTransform().rotation.y,
+                (float)selectedObject->GetTransform().rotation.z
             };  // TODO: Agafar la rotaci del selectedObject
             if (ImGui::DragFloat3("Rotation (Euler)", rot, 0.5f))
             {
-                selectedObject->transform.rotation = { (double)rot[0], (double)rot[1], (double)rot[2] };
+                selectedObject->SetRotation({ (double)rot[0], (double)rot[1], (double)rot[2] });
 				// TODO: Actualitzar la rotaci del selectedObject
             }
 
             float scl[3] = {
-                (float)selectedObject->transform.scale.x,
-                (float)selectedObject->transform.scale.y,
-                (float)selectedObject->transform.scale.z
+                (float)selectedObject->GetTransform().scale.x,
+                (float)selectedObject->GetTransform().scale.y,
+                (float)selectedObject->GetTransform().scale.z
             }; // TODO: Agafar l'escala del selectedObject
             if (ImGui::DragFloat3("Scale", scl, 0.1f))
             {
-                selectedObject->transform.scale = { (double)scl[0], (double)scl[1], (double)scl[2] };
+                selectedObject->SetScale({ (double)scl[0], (double)scl[1], (double)scl[2] });
 				// TODO: Actualitzar l'escala del selectedObject
             }
 
             ImGui::Separator();
             if (ImGui::Button("Add Child")) 
             {
-                GameObject* child = new GameObject();
-                selectedObject->AddChild(child);
+                scene.CreateObject(selectedObject);
 				// TODO: Afegir un nou GameObject com a fill del selectedObject
             }
+            ImGui::SameLine();
+            if (ImGui::Button("Delete"))
+            {
+                // Amb tot el seu subarbre; el handle seleccionat queda invalid
+                scene.Destroy(selectedObject);
+                selectedObject = nullptr;
+            }
 
         }
         else {
@@ -748,10 +835,26 @@ int main(int argc, char** argv) {
             // TODO: Clculs de Cmera (View i Projection)
             Matrix4x4 view = mainCamera.GetViewMatrix();
             Matrix4x4 proj = mainCamera.GetProjectionMatrix();
+            GraphicsUtils::UploadViewProjection(shaderProgram,
+                view.Cast<float, MatrixLayout::ColumnMajor>(), proj.Cast<float, MatrixLayout::ColumnMajor>());
 
 			// TODO: Recorregut de l'escena i renderitzat (RenderNode)
-            for (auto* obj : sceneRoots) {
-                RenderNode(obj, shaderProgram, view, proj, cubeMesh);
+            // Matrius de mon: la part bruta de l'escena, repartida entre els fils de treball
+            scene.UpdateWorld(jobs);
+            bvh.Refit(scene, meshBounds);
+            culler.Update(scene, meshBounds);
+            const Matrix4x4 viewProjection = proj.Multiply(view);
+            culler.Cull(Frustum::FromViewProjection(viewProjection));
+            if (pickRequested && w > 0 && h > 0) {
+                // Seleccio amb el ratoli; un clic al buit deselecciona
+                Picker::Hit hit;
+                const Ray ray = Picker::ScreenRay(viewProjection.Inverse(), pickX, pickY, w, h);
+                selectedHandle = picker.Pick(scene, bvh, pickMeshes, ray, 1.0, hit) ? hit.object : GameObjectHandle{};
+                selectedObject = scene.Resolve(selectedHandle);
+            }
+            pickRequested = false;
+            for (auto* obj : scene.Roots()) {
+                RenderNode(obj, shaderProgram, cubeMesh, culler);
             }
         }
 
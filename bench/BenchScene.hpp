@@ -0,0 +1,59 @@
+#pragma once
+#include "SceneBuilder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// Helpers shared by the scene benchmarks: timing, arguments and comparisons. The
+// random scenes come from the library (SceneBuilder.hpp).
+
+// Removes flag (e.g. "--quick") from the arguments if it is there, so that the
+// positional ones keep their place
+inline bool TakeFlag(int& argc, char** argv, std::string_view flag)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (argv[i] != flag) continue;
+        std::copy(argv + i + 1, argv + argc, argv + i);
+        --argc;
+        return true;
+    }
+    return false;
+}
+
+inline double Ms(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Same nodes in the same order: hierarchy, transforms, meshes, names, tags and world
+// matrices, bit for bit (call UpdateWorld on both first)
+inline bool SameScene(const Scene& a, const Scene& b)
+{
+    const std::size_t n = a.Size();
+    if (b.Size() != n) return false;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (a.SubtreeSize(i) != b.SubtreeSize(i)) return false;
+        const GameObject* x = a.Object(i);
+        const GameObject* y = b.Object(i);
+        if (x->GetName() != y->GetName() || x->GetTag() != y->GetTag()) return false;
+    }
+    return std::memcmp(a.Transforms().data(), b.Transforms().data(), n * sizeof(Transform)) == 0
+        && std::memcmp(a.Parents().data(), b.Parents().data(), n * sizeof(int32_t)) == 0
+        && std::memcmp(a.Meshes().data(), b.Meshes().data(), n * sizeof(uint32_t)) == 0
+        && std::memcmp(a.World().data(), b.World().data(), n * sizeof(Affine3x4)) == 0;
+}
+
+// Same handles in any order (sorts both)
+inline bool SameSet(std::vector<GameObjectHandle>& a, std::vector<GameObjectHandle>& b)
+{
+    auto less = [](const GameObjectHandle& x, const GameObjectHandle& y) {
+        return x.slot != y.slot ? x.slot < y.slot : x.generation < y.generation;
+    };
+    std::sort(a.begin(), a.end(), less);
+    std::sort(b.begin(), b.end(), less);
+    return a == b;
+}
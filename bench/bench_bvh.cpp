@@ -0,0 +1,218 @@
+// BVH: build, refit and query times over the world AABBs of a large scene, and the
+// queries against testing every node.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_bvh.cpp -o bench_bvh -pthread
+//
+// Usage: bench_bvh [--quick] [nodes]     (default: 100k and 1M; --quick: 20k)
+//
+// Every node has the unit cube as mesh. Refit is timed after moving 1% of the nodes
+// (with their subtrees), after moving every root (the whole scene), and after
+// destroying and creating some subtrees. After each step the query results must match
+// the brute force ones.
+#include "BVH.hpp"
+#include "BenchScene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Roots spread over the whole world, children around their parent
+static const HierarchyShape shape = { .rootSpread = 200.0, .childSpread = 2.0, .rootScale = 0.5 };
+
+struct Queries {
+    Frustum frustum;
+    std::vector<AABB> boxes;
+    std::vector<Sphere> spheres;
+    std::vector<Ray> rays;
+};
+
+// Boxes and spheres anywhere in the world; rays from far away towards random nodes
+static Queries MakeQueries(const std::vector<AABB>& world, std::size_t count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    Queries q;
+
+    // Camera at z = 150 looking down -z, 60 degrees, as Camera in the app
+    const double fovY = 60.0 * 3.14159265358979323846 / 180.0, aspect = 16.0 / 9.0, n = 0.1, f = 400.0;
+    const double t = std::tan(fovY / 2.0) * n, r = t * aspect;
+    Matrix4x4 P{};
+    P.At(0, 0) = n / r;
+    P.At(1, 1) = n / t;
+    P.At(2, 2) = -(f + n) / (f - n);
+    P.At(2, 3) = -(2.0 * f * n) / (f - n);
+    P.At(3, 2) = -1.0;
+    const Matrix4x4 V = Matrix4x4::Translate({ 0.0, 0.0, -150.0 });
+    q.frustum = Frustum::FromViewProjection(P.Multiply(V));
+
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const Vec3 c{ 200.0 * u(rng), 200.0 * u(rng), 200.0 * u(rng) };
+        q.boxes.push_back(AABB::FromCenterExtents(c, { 10.0, 10.0, 10.0 }));
+        q.spheres.push_back({ c, 10.0 });
+        const Vec3 from = Vec3{ u(rng), u(rng), u(rng) }.Normalize();
+        const Vec3 o{ 400.0 * from.x, 400.0 * from.y, 400.0 * from.z };
+        const Vec3 target = world[rng() % world.size()].Center();
+        q.rays.push_back(Ray::FromOriginDirection(o, Vec3{ target.x - o.x, target.y - o.y, target.z - o.z }.Normalize()));
+    }
+    return q;
+}
+
+// Runs every query on the tree and by testing all the world boxes; false on a mismatch
+static bool Check(const BVH& bvh, const Scene& scene, const std::vector<AABB>& world, const Queries& q, std::size_t count)
+{
+    std::vector<GameObjectHandle> a, b;
+    auto brute = [&](auto&& test) {
+        b.clear();
+        for (std::size_t i = 0; i < world.size(); ++i)
+            if (!world[i].IsEmpty() && test(world[i])) b.push_back(scene.Object(i)->GetHandle());
+    };
+
+    a.clear();
+    bvh.QueryFrustum(q.frustum, a);
+    brute([&](const AABB& box) { return q.frustum.Classify(box) != Containment::Outside; });
+    if (!SameSet(a, b)) return false;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        a.clear();
+        bvh.QueryAABB(q.boxes[k], a);
+        brute([&](const AABB& box) { return box.Overlaps(q.boxes[k]); });
+        if (!SameSet(a, b)) return false;
+
+        a.clear();
+        bvh.QuerySphere(q.spheres[k], a);
+        brute([&](const AABB& box) { return q.spheres[k].Overlaps(box); });
+        if (!SameSet(a, b)) return false;
+
+        BVH::RayHit hit;
+        const bool found = bvh.Raycast(q.rays[k], 1e9, hit);
+        double best = 1e9;
+        for (const AABB& box : world)
+        {
+            double t;
+            if (!box.IsEmpty() && q.rays[k].Intersects(box, best, t)) best = std::min(best, t);
+        }
+        if (found != (best < 1e9) || (found && hit.t != best)) return false;
+    }
+    return true;
+}
+
+static bool Run(std::size_t n)
+{
+    Scene scene;
+    RandomHierarchy(scene, n, 42, shape);
+    scene.UpdateWorld();
+    const std::vector<AABB> meshBounds = { AABB::FromCenterExtents({ 0.0, 0.0, 0.0 }, { 0.5, 0.5, 0.5 }) };
+    const std::size_t checks = (n > 200000) ? 5 : 20;
+    std::printf("%zu nodes\n", n);
+
+    std::vector<AABB> world(n);
+    auto t0 = std::chrono::steady_clock::now();
+    BVH::ComputeWorldBounds(scene, meshBounds, world);
+    std::printf("  %-28s %9.2f ms  (%.1f ns/node)\n", "World AABBs", Ms(t0), Ms(t0) * 1e6 / n);
+    const Queries q = MakeQueries(world, 1000, 7);
+
+    BVH bvh;
+    t0 = std::chrono::steady_clock::now();
+    bvh.Build(scene, meshBounds);
+    const double build = Ms(t0);
+    const BVH::Quality quality = bvh.GetQuality();
+    std::printf("  %-28s %9.2f ms  (height %zu, SAH cost %.1f)\n", "Build", build, quality.height, quality.sahCost);
+    bool ok = Check(bvh, scene, world, q, checks);
+
+    // Refits. Each one is checked against the brute force over fresh world boxes.
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    auto refit = [&](const char* what) {
+        scene.UpdateWorld();
+        const auto r0 = std::chrono::steady_clock::now();
+        bvh.Refit(scene, meshBounds);
+        const double ms = Ms(r0);
+        const BVH::Stats st = bvh.GetStats();
+        std::printf("  %-28s %9.2f ms  (%zu refitted, %zu in, %zu out%s, height %zu)\n", what, ms, st.updated,
+            st.inserted, st.removed, st.rebuilt ? ", rebuilt" : "", bvh.GetQuality().height);
+        world.resize(scene.Size());
+        BVH::ComputeWorldBounds(scene, meshBounds, world);
+        ok = Check(bvh, scene, world, q, checks) && ok;
+    };
+
+    refit("Refit, nothing moved");
+
+    for (std::size_t k = 0; k < n / 100; ++k)
+    {
+        GameObject* node = scene.Object(rng() % scene.Size());
+        const Vec3 p = node->GetTransform().position;
+        node->SetPosition({ p.x + u(rng), p.y + u(rng), p.z + u(rng) });
+    }
+    refit("Refit, 1% of nodes moved");
+
+    for (GameObject* root : scene.Roots())
+    {
+        const Vec3 p = root->GetTransform().position;
+        root->SetPosition({ p.x + 2.0 * u(rng), p.y + 2.0 * u(rng), p.z + 2.0 * u(rng) });
+    }
+    refit("Refit, every root moved");
+
+    for (int k = 0; k < 100; ++k) scene.Destroy(scene.Object(rng() % scene.Size()));
+    Scene extra;
+    RandomHierarchy(extra, n / 100, 9, shape);
+    scene.InsertNodes(nullptr, extra.Transforms(), extra.Parents(), extra.Meshes());
+    refit("Refit, subtrees in and out");
+
+    // Queries: the tree against testing every node (fewer of those, they are slow)
+    const Queries timed = MakeQueries(world, 1000, 11);
+    std::vector<GameObjectHandle> out;
+    auto timeQuery = [&](const char* what, std::size_t count, auto&& tree, auto&& brute) {
+        std::size_t found = 0;
+        auto q0 = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < count; ++k) { out.clear(); tree(k); found += out.size(); }
+        const double treeUs = Ms(q0) * 1e3 / count;
+        const std::size_t bruteCount = std::max<std::size_t>(1, count / 50);
+        q0 = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < bruteCount; ++k) { out.clear(); brute(k); }
+        const double bruteUs = Ms(q0) * 1e3 / bruteCount;
+        std::printf("  %-28s %9.2f us  brute force %9.2f us  (%.0fx, %.1f hits)\n", what, treeUs, bruteUs,
+            bruteUs / treeUs, double(found) / count);
+    };
+    auto all = [&](auto&& test) {
+        for (std::size_t i = 0; i < world.size(); ++i)
+            if (!world[i].IsEmpty() && test(world[i])) out.push_back(scene.Object(i)->GetHandle());
+    };
+
+    timeQuery("Frustum", 20,
+        [&](std::size_t) { bvh.QueryFrustum(timed.frustum, out); },
+        [&](std::size_t) { all([&](const AABB& b) { return timed.frustum.Classify(b) != Containment::Outside; }); });
+    timeQuery("AABB", timed.boxes.size(),
+        [&](std::size_t k) { bvh.QueryAABB(timed.boxes[k], out); },
+        [&](std::size_t k) { all([&](const AABB& b) { return b.Overlaps(timed.boxes[k]); }); });
+    timeQuery("Sphere", timed.spheres.size(),
+        [&](std::size_t k) { bvh.QuerySphere(timed.spheres[k], out); },
+        [&](std::size_t k) { all([&](const AABB& b) { return timed.spheres[k].Overlaps(b); }); });
+    timeQuery("Ray (nearest)", timed.rays.size(),
+        [&](std::size_t k) { BVH::RayHit hit; if (bvh.Raycast(timed.rays[k], 1e9, hit)) out.push_back(hit.object); },
+        [&](std::size_t k) {
+            double best = 1e9, t;
+            std::size_t nearest = 0;
+            for (std::size_t i = 0; i < world.size(); ++i)
+                if (!world[i].IsEmpty() && timed.rays[k].Intersects(world[i], best, t) && t < best) { best = t; nearest = i; }
+            if (best < 1e9) out.push_back(scene.Object(nearest)->GetHandle());
+        });
+
+    if (!ok) std::printf("  MISMATCH between the tree and the brute force queries\n");
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = TakeFlag(argc, argv, "--quick");
+    std::vector<std::size_t> sizes = { 100000, 1000000 };
+    if (quick) sizes = { 20000 };
+    if (argc > 1) sizes = { std::strtoull(argv[1], nullptr, 10) };
+    bool ok = true;
+    for (std::size_t n : sizes) ok = Run(n) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// FrustumCuller: update and cull times of a large scene for a few camera views, against
+// testing the box of every node, at every SIMD level.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_culling.cpp -o bench_culling -pthread
+//
+// Usage: bench_culling [--quick] [nodes]     (default: 1M; --quick: 20k)
+//
+// Every node has the unit cube as mesh. The visible set must be the same as the one of
+// the brute force test at every level.
+#include "FrustumCuller.hpp"
+#include "Simd.hpp"
+#include "BenchScene.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Roots spread over the whole world, children around their parent
+static const HierarchyShape shape = { .rootSpread = 200.0, .childSpread = 2.0, .rootScale = 0.5 };
+
+// Camera at eye looking down -z turned by yawDegrees around y, 60 degrees, as Camera in
+// the app
+static Frustum View(const Vec3& eye, double yawDegrees, double farPlane)
+{
+    const double fovY = 60.0 * 3.14159265358979323846 / 180.0, aspect = 16.0 / 9.0, n = 0.1, f = farPlane;
+    const double t = std::tan(fovY / 2.0) * n, r = t * aspect;
+    Matrix4x4 P{};
+    P.At(0, 0) = n / r;
+    P.At(1, 1) = n / t;
+    P.At(2, 2) = -(f + n) / (f - n);
+    P.At(2, 3) = -(2.0 * f * n) / (f - n);
+    P.At(3, 2) = -1.0;
+    // View = inverse(Translate(eye) * RotateY(yaw))
+    const double yaw = yawDegrees * 3.14159265358979323846 / 180.0, c = std::cos(yaw), s = std::sin(yaw);
+    Matrix4x4 R = Matrix4x4::Identity();
+    R.At(0, 0) = c;  R.At(0, 2) = -s;
+    R.At(2, 0) = s;  R.At(2, 2) = c;
+    const Matrix4x4 V = R.Multiply(Matrix4x4::Translate({ -eye.x, -eye.y, -eye.z }));
+    return Frustum::FromViewProjection(P.Multiply(V));
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = TakeFlag(argc, argv, "--quick");
+    const std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : quick ? 20000 : 1000000;
+    Scene scene;
+    RandomHierarchy(scene, n, 42, shape);
+    scene.UpdateWorld();
+    const std::vector<AABB> meshBounds = { AABB::FromCenterExtents({ 0.0, 0.0, 0.0 }, { 0.5, 0.5, 0.5 }) };
+
+    std::printf("%zu nodes\n", n);
+    FrustumCuller culler;
+    auto t0 = std::chrono::steady_clock::now();
+    culler.Update(scene, meshBounds);
+    std::printf("  %-30s %9.2f ms\n", "Update, all nodes", Ms(t0));
+    t0 = std::chrono::steady_clock::now();
+    culler.Update(scene, meshBounds);
+    std::printf("  %-30s %9.2f ms\n", "Update, nothing moved", Ms(t0));
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    for (std::size_t k = 0; k < n / 100; ++k)
+    {
+        GameObject* node = scene.Object(rng() % scene.Size());
+        const Vec3 p = node->GetTransform().position;
+        node->SetPosition({ p.x + u(rng), p.y + u(rng), p.z + u(rng) });
+    }
+    scene.UpdateWorld();
+    t0 = std::chrono::steady_clock::now();
+    culler.Update(scene, meshBounds);
+    std::printf("  %-30s %9.2f ms\n", "Update, 1% of nodes moved", Ms(t0));
+
+    // Own world boxes for the brute force test
+    std::vector<AABB> boxes(n);
+    const std::span<const Affine3x4> world = scene.World();
+    for (std::size_t i = 0; i < n; ++i) boxes[i] = meshBounds[0].Transformed(world[i]);
+
+    struct Case {
+        const char* name;
+        Frustum frustum;
+    };
+    const Case cases[] = {
+        { "whole world", View({ 0.0, 0.0, 450.0 }, 0.0, 1000.0) },
+        { "inside, looking at a corner", View({ 0.0, 0.0, 0.0 }, 45.0, 100.0) },
+        { "close up", View({ 0.0, 0.0, 60.0 }, 0.0, 40.0) },
+        { "looking away", View({ 0.0, 0.0, 450.0 }, 180.0, 1000.0) },
+    };
+
+    const Simd::Level best = Simd::Detect();
+    bool ok = true;
+    for (const Case& c : cases)
+    {
+        t0 = std::chrono::steady_clock::now();
+        std::vector<uint8_t> expected(n);
+        std::size_t visible = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            expected[i] = c.frustum.Classify(boxes[i]) != Containment::Outside;
+            visible += expected[i];
+        }
+        const double brute = Ms(t0);
+        std::printf("  %-30s brute force %8.2f ms, %zu visible\n", c.name, brute, visible);
+
+        for (Simd::Level level : { Simd::Level::Scalar, Simd::Level::SSE2, Simd::Level::AVX2 })
+        {
+            if (level > best) continue;
+            Simd::SetActive(level);
+            const int reps = 10;
+            t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; ++r) culler.Cull(c.frustum);
+            const double ms = Ms(t0) / reps;
+            std::size_t mismatches = 0;
+            for (std::size_t i = 0; i < n; ++i) mismatches += (culler.IsVisible(i) != (expected[i] != 0));
+            const FrustumCuller::Stats& st = culler.GetStats();
+            std::printf("    %-8s %8.2f ms (%5.1fx)  %zu boxes tested, %zu subtrees out, %zu in%s\n",
+                Simd::Name(level), ms, brute / ms, st.boxesTested, st.subtreesOutside, st.subtreesInside,
+                mismatches ? "  MISMATCH" : "");
+            ok = ok && mismatches == 0;
+        }
+        Simd::SetActive(best);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+// Rigid chain composition: DualQuat against Matrix4x4 and Affine3x4, cost and drift.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_dualquat.cpp -o bench_dualquat
+//
+// Usage: bench_dualquat [chain length]
+#include "DualQuat.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+template<typename F>
+static double TimeNs(F&& body)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+static void Report(const char* name, double ns, std::size_t ops, double checksum)
+{
+    std::printf("  %-36s %8.2f ns/op  (checksum %.6e)\n", name, ns / static_cast<double>(ops), checksum);
+}
+
+// max |R^T R - I| of a rotation block
+template<typename T>
+static double OrthoError(const TMatrix3x3<T>& R)
+{
+    double e = 0.0;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+        {
+            double d = 0.0;
+            for (int k = 0; k < 3; ++k) d += double(R.m[k * 3 + i]) * double(R.m[k * 3 + j]);
+            e = std::max(e, std::fabs(d - (i == j ? 1.0 : 0.0)));
+        }
+    return e;
+}
+
+// max(| |real| - 1 |, |real . dual|)
+template<typename T>
+static double UnitError(const TDualQuat<T>& D)
+{
+    const TQuat<T>& r = D.real;
+    const TQuat<T>& d = D.dual;
+    const double n = std::sqrt(double(r.s) * r.s + double(r.x) * r.x + double(r.y) * r.y + double(r.z) * r.z);
+    const double k = double(r.s) * d.s + double(r.x) * d.x + double(r.y) * d.y + double(r.z) * d.z;
+    return std::max(std::fabs(n - 1.0), std::fabs(k));
+}
+
+template<typename T>
+static void Run(const char* type, std::size_t n)
+{
+    std::mt19937 rng(1234);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+
+    // Small joint-like steps so that the chain stays bounded
+    std::vector<TDualQuat<T>> d(n);
+    std::vector<TAffine3x4<T>> a(n);
+    std::vector<TMatrix4x4<T>> m(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Quat q = Quat{ gauss(rng), gauss(rng), gauss(rng), gauss(rng) }.Normalized();
+        const Vec3 t{ 0.01 * gauss(rng), 0.01 * gauss(rng), 0.01 * gauss(rng) };
+        d[i] = DualQuat::FromTR(t, q).template Cast<T>();
+        a[i] = d[i].ToAffine3x4();
+        m[i] = d[i].ToMatrix4x4();
+    }
+    std::printf("%s, chain of %zu rigid transforms\n", type, n);
+
+    TMatrix4x4<T> M = TMatrix4x4<T>::Identity();
+    TAffine3x4<T> A = TAffine3x4<T>::Identity();
+    TDualQuat<T> D = TDualQuat<T>::Identity(), Dn = D;
+
+    double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) M = M.Multiply(m[i]); });
+    Report("Matrix4x4::Multiply", ns, n, M.m[3]);
+    ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) A = A.Multiply(a[i]); });
+    Report("Affine3x4::Multiply", ns, n, A.m[3]);
+    ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) D = D.Multiply(d[i]); });
+    Report("DualQuat::Multiply", ns, n, D.dual.x);
+    ns = TimeNs([&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            Dn = Dn.Multiply(d[i]);
+            if ((i & 63) == 63) Dn = Dn.Normalized();
+        }
+    });
+    Report("DualQuat::Multiply + Normalized/64", ns, n, Dn.dual.x);
+
+    TMatrix3x3<T> R;
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c) R.m[r * 3 + c] = A.m[r * 4 + c];
+    std::printf("  drift: Affine3x4 |R^T R - I| %.2e, DualQuat %.2e, normalized every 64 %.2e\n",
+        OrthoError(R), UnitError(D), UnitError(Dn));
+
+    const Vec3 p{ 0.3, -1.0, 2.0 };
+    const TVec3<T> pt{ T(p.x), T(p.y), T(p.z) };
+    double sum = 0.0;
+    ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += a[i].TransformPoint(pt).x; });
+    Report("Affine3x4::TransformPoint", ns, n, sum);
+    sum = 0.0;
+    ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += d[i].TransformPoint(pt).x; });
+    Report("DualQuat::TransformPoint", ns, n, sum);
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::printf("SIMD level: %s\n", Simd::Name(Simd::Active()));
+    Run<double>("double", n);
+    Run<float>("float", n);
+    return 0;
+}
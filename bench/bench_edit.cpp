@@ -0,0 +1,172 @@
+// SceneEdit: a batch of hierarchy edits applied in one pass, against the same edits as
+// single Scene calls (each SetParent or insertion in the middle reorders the arrays).
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_edit.cpp -o bench_edit -pthread
+//
+// Usage: bench_edit [--quick] [nodes]     (default: 100k and 1M; --quick: 20k)
+//
+// The edits are a scripted restructuring: destroy 0.1% of the nodes (with their
+// subtrees), add 100 group roots and move 1% of the nodes under them. On a 20k node
+// scene the batch must give the same hierarchy and world matrices as the single calls,
+// and moving with Keep::World must keep every world matrix.
+#include "SceneEdit.hpp"
+#include "BenchScene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// Uniform scales, so that Keep::World is exact
+static const HierarchyShape shape = { .rootSpread = 5.0, .childSpread = 5.0, .rotation = 90.0, .scaleJitter = 0.1 };
+
+// The edits, as indices of the scene they were made for
+struct Script {
+    std::vector<std::size_t> destroyed;
+    std::size_t groups = 0;
+    std::vector<std::pair<std::size_t, std::size_t>> moves;    // node, group
+};
+
+// Destroyed subtrees do not overlap and no moved node is in one of them
+static Script MakeScript(const Scene& scene, std::size_t destroys, std::size_t groups, std::size_t moves, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    const std::size_t n = scene.Size();
+    std::vector<uint8_t> gone(n, 0);
+    Script s;
+    s.groups = groups;
+    for (std::size_t k = 0; k < destroys; ++k)
+    {
+        const std::size_t i = rng() % n;
+        if (gone[i]) continue;
+        s.destroyed.push_back(i);
+        std::fill(gone.begin() + i, gone.begin() + i + scene.SubtreeSize(i), uint8_t(1));
+    }
+    while (s.moves.size() < moves)
+    {
+        const std::size_t i = rng() % n;
+        if (!gone[i]) s.moves.push_back({ i, rng() % groups });
+    }
+    return s;
+}
+
+static void RecordScript(const Scene& scene, const Script& s, SceneEdit& edit, SceneEdit::Keep keep)
+{
+    std::vector<GameObjectHandle> group;
+    for (std::size_t i : s.destroyed) edit.Destroy(scene.Object(i)->GetHandle());
+    for (std::size_t g = 0; g < s.groups; ++g) group.push_back(edit.Insert({}, Transform(), 0, "Group " + std::to_string(g)));
+    for (const auto& [i, g] : s.moves) edit.Reparent(scene.Object(i)->GetHandle(), group[g], keep);
+}
+
+// The same edits one call at a time, in the same order
+static void RunScript(Scene& scene, const Script& s)
+{
+    std::vector<GameObject*> node(scene.Size()), group;
+    for (std::size_t i = 0; i < scene.Size(); ++i) node[i] = scene.Object(i);
+    for (std::size_t i : s.destroyed) scene.Destroy(node[i]);
+    for (std::size_t g = 0; g < s.groups; ++g)
+    {
+        group.push_back(scene.CreateObject());
+        group.back()->SetName("Group " + std::to_string(g));
+    }
+    for (const auto& [i, g] : s.moves) scene.SetParent(node[i], group[g]);
+}
+
+static bool Check()
+{
+    const std::size_t n = 20000;
+    Scene batch, single;
+    RandomHierarchy(batch, n, 42, shape);
+    RandomHierarchy(single, n, 42, shape);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        batch.Object(i)->SetName("Node " + std::to_string(i));
+        single.Object(i)->SetName("Node " + std::to_string(i));
+    }
+    const Script script = MakeScript(batch, n / 1000, 100, n / 10, 7);
+
+    SceneEdit edit(batch);
+    RecordScript(batch, script, edit, SceneEdit::Keep::Local);
+    edit.Apply();
+    RunScript(single, script);
+    batch.UpdateWorld();
+    single.UpdateWorld();
+    bool ok = SameScene(batch, single);
+    if (!ok) std::printf("  MISMATCH between the batch and the single calls\n");
+
+    // Keep::World: every node ends where it was
+    Scene moved;
+    RandomHierarchy(moved, n, 42, shape);
+    moved.UpdateWorld();
+    std::vector<Affine3x4> before(moved.World().begin(), moved.World().end());
+    std::vector<GameObject*> node(n);
+    for (std::size_t i = 0; i < n; ++i) node[i] = moved.Object(i);
+    const Script keep = MakeScript(moved, 0, 100, n / 10, 8);
+    SceneEdit worldEdit(moved);
+    RecordScript(moved, keep, worldEdit, SceneEdit::Keep::World);
+    worldEdit.Apply();
+    moved.UpdateWorld();
+    double err = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+        for (int k = 0; k < 12; ++k)
+            err = std::max(err, std::fabs(moved.World()[node[i]->GetIndex()].m[k] - before[i].m[k]));
+    std::printf("Check on %zu nodes: batch %s the single calls, Keep::World max error %.2e\n", n,
+        ok ? "matches" : "DIFFERS from", err);
+    if (err > 1e-9)
+    {
+        std::printf("  Keep::World moved some nodes\n");
+        ok = false;
+    }
+    return ok;
+}
+
+static void Run(std::size_t n)
+{
+    Scene scene;
+    RandomHierarchy(scene, n, 42, shape);
+    scene.UpdateWorld();
+    std::printf("%zu nodes\n", n);
+
+    for (SceneEdit::Keep keep : { SceneEdit::Keep::Local, SceneEdit::Keep::World })
+    {
+        const Script script = MakeScript(scene, n / 1000, 100, n / 100, 7);
+        const std::size_t edits = script.destroyed.size() + script.groups + script.moves.size();
+        SceneEdit edit(scene);
+        auto t0 = std::chrono::steady_clock::now();
+        RecordScript(scene, script, edit, keep);
+        const double record = Ms(t0);
+        t0 = std::chrono::steady_clock::now();
+        edit.Apply();
+        const double apply = Ms(t0);
+        std::printf("  Batch, Keep::%-5s %6zu edits  record %7.2f ms  apply %8.2f ms  (%.2f us/edit)\n",
+            keep == SceneEdit::Keep::Local ? "Local" : "World", edits, record, apply, (record + apply) * 1e3 / edits);
+        scene.UpdateWorld();
+    }
+
+    // A few single calls of each kind: each one is a pass over the arrays
+    std::mt19937 rng(3);
+    const std::size_t calls = 10;
+    GameObject* group = scene.CreateObject();
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < calls; ++k) scene.SetParent(scene.Object(rng() % (scene.Size() - 1)), group);
+    const double reparent = Ms(t0) / calls;
+    t0 = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < calls; ++k) scene.CreateObject(scene.Object(rng() % (scene.Size() / 2)));
+    const double insert = Ms(t0) / calls;
+    std::printf("  Single calls: SetParent %.2f ms, CreateObject (mid-scene) %.2f ms per edit\n", reparent, insert);
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = TakeFlag(argc, argv, "--quick");
+    std::vector<std::size_t> sizes = { 100000, 1000000 };
+    if (quick) sizes = { 20000 };
+    if (argc > 1) sizes = { std::strtoull(argv[1], nullptr, 10) };
+    const bool ok = Check();
+    for (std::size_t n : sizes) Run(n);
+    return ok ? 0 : 1;
+}
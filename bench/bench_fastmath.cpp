@@ -0,0 +1,93 @@
+// FastMath (SinCos, Acos, Rsqrt) against libm: accuracy and throughput, scalar and bulk.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_fastmath.cpp -o bench_fastmath
+//
+// Usage: bench_fastmath [count]
+#include "FastMath.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+template<typename F>
+static double TimeNs(F&& body)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+// |got - ref| in ULP of max(|ref|, floor)
+template<typename T>
+static double Ulp(T got, long double ref, long double floor = 0)
+{
+    int e;
+    std::frexp(static_cast<double>(std::max(std::fabs(ref), floor)), &e);
+    const long double ulp = std::ldexp(1.0L, e - std::numeric_limits<T>::digits);
+    return static_cast<double>(std::fabs(static_cast<long double>(got) - ref) / ulp);
+}
+
+template<typename T>
+static void Run(const char* type, std::size_t n)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> ang(-3.2, 3.2);
+    std::uniform_real_distribution<double> wide(-static_cast<double>(FastMath::SinCosMax<T>), static_cast<double>(FastMath::SinCosMax<T>));
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::uniform_real_distribution<double> norm2(0.25, 4.0);
+
+    std::vector<T> x(n), w(n), a(n), r(n), s(n), c(n), o(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        x[i] = static_cast<T>(ang(rng));
+        w[i] = static_cast<T>(wide(rng));
+        a[i] = static_cast<T>(unit(rng));
+        r[i] = static_cast<T>(norm2(rng));
+    }
+
+    // Accuracy, bulk path (the scalar path shares the polynomials)
+    const long double floor = std::is_same_v<T, double> ? std::ldexp(1.0L, -26) : std::ldexp(1.0L, -12);
+    double eSin = 0.0, eAcos = 0.0, eRsqrt = 0.0;
+    FastMath::SinCos(std::span<const T>(w), std::span<T>(s), std::span<T>(c));
+    for (std::size_t i = 0; i < n; ++i) {
+        eSin = std::max({ eSin, Ulp(s[i], std::sin(static_cast<long double>(w[i])), floor),
+            Ulp(c[i], std::cos(static_cast<long double>(w[i])), floor) });
+    }
+    FastMath::Acos(std::span<const T>(a), std::span<T>(o));
+    for (std::size_t i = 0; i < n; ++i) eAcos = std::max(eAcos, Ulp(o[i], std::acos(static_cast<long double>(a[i]))));
+    FastMath::Rsqrt(std::span<const T>(r), std::span<T>(o));
+    for (std::size_t i = 0; i < n; ++i) eRsqrt = std::max(eRsqrt, Ulp(o[i], 1.0L / std::sqrt(static_cast<long double>(r[i]))));
+    std::printf("%s: max error SinCos %.2f ULP, Acos %.2f ULP, Rsqrt %.2f ULP\n", type, eSin, eAcos, eRsqrt);
+
+    auto report = [&](const char* name, double ns) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < n; i += 64) sum += s[i] + c[i] + o[i];
+        std::printf("  %-22s %7.2f ns/op  (checksum %.6e)\n", name, ns / static_cast<double>(n), sum);
+    };
+
+    report("libm sin + cos", TimeNs([&] { for (std::size_t i = 0; i < n; ++i) { s[i] = std::sin(x[i]); c[i] = std::cos(x[i]); } }));
+    report("SinCos", TimeNs([&] { for (std::size_t i = 0; i < n; ++i) FastMath::SinCos(x[i], s[i], c[i]); }));
+    report("SinCos (bulk)", TimeNs([&] { FastMath::SinCos(std::span<const T>(x), std::span<T>(s), std::span<T>(c)); }));
+    report("libm acos", TimeNs([&] { for (std::size_t i = 0; i < n; ++i) o[i] = std::acos(a[i]); }));
+    report("Acos", TimeNs([&] { for (std::size_t i = 0; i < n; ++i) o[i] = FastMath::Acos(a[i]); }));
+    report("Acos (bulk)", TimeNs([&] { FastMath::Acos(std::span<const T>(a), std::span<T>(o)); }));
+    report("1 / sqrt", TimeNs([&] { for (std::size_t i = 0; i < n; ++i) o[i] = T(1) / std::sqrt(r[i]); }));
+    report("Rsqrt", TimeNs([&] { for (std::size_t i = 0; i < n; ++i) o[i] = FastMath::Rsqrt(r[i]); }));
+    report("Rsqrt (bulk)", TimeNs([&] { FastMath::Rsqrt(std::span<const T>(r), std::span<T>(o)); }));
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::printf("count: %zu, SIMD level: %s\n", n, Simd::Name(Simd::Active()));
+    Run<double>("double", n);
+    Run<float>("float", n);
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Header-inline (constexpr) math core against the out-of-line build.
+//
+// Build both variants and compare (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_inline.cpp -o bench_inline
+//   g++ -O2 -std=c++20 -Iinclude -DMATH_INLINE_CORE=0 src/*.cpp bench/bench_inline.cpp -o bench_inline_outofline
+//
+// Usage: bench_inline [count]
+#include "Matrix4x4.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#if MATH_INLINE_CORE
+// Constant transforms fold at compile time
+constexpr Matrix4x4 kPivot = Matrix4x4::Translate({ 0.0, 1.0, 0.0 })
+    .Multiply(Matrix4x4::Scale({ 2.0, 2.0, 2.0 }))
+    .Multiply(Matrix4x4::Translate({ 0.0, -1.0, 0.0 }));
+static_assert(kPivot.At(1, 3) == -1.0 && kPivot.At(1, 1) == 2.0);
+
+constexpr Quat kQuarterX{ 0.7071067811865476, 0.7071067811865476, 0.0, 0.0 };
+static_assert((kQuarterX * kQuarterX).x > 0.99999);
+static_assert(Vec3::Dot(Vec3::Cross({ 1, 0, 0 }, { 0, 1, 0 }), { 0, 0, 1 }) == 1.0);
+#endif
+
+template<typename F>
+static double TimeNs(F&& body)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+static void Report(const char* name, double ns, std::size_t ops, double checksum)
+{
+    std::printf("  %-28s %8.2f ns/op  %8.2f Mops/s  (checksum %.6e)\n",
+        name, ns / static_cast<double>(ops), static_cast<double>(ops) / ns * 1e3, checksum);
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> pos(-10.0, 10.0);
+    std::uniform_real_distribution<double> ang(-3.14159, 3.14159);
+    std::uniform_real_distribution<double> scl(0.5, 2.0);
+
+    std::vector<Vec3> a(n), b(n), t(n), s(n);
+    std::vector<Quat> q(n);
+    std::vector<Matrix3x3> R(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = { pos(rng), pos(rng), pos(rng) };
+        b[i] = { pos(rng), pos(rng), pos(rng) };
+        t[i] = { pos(rng), pos(rng), pos(rng) };
+        s[i] = { scl(rng), scl(rng), scl(rng) };
+        R[i] = Matrix3x3::FromEulerZYX(ang(rng), ang(rng), ang(rng));
+        q[i] = Quat::FromMatrix3x3(R[i]);
+    }
+
+    std::printf("count: %zu, build: %s\n", n, MATH_INLINE_CORE ? "header-inline (constexpr)" : "out-of-line");
+
+    {
+        double sum = 0.0;
+        double ns = TimeNs([&] {
+            for (std::size_t i = 0; i < n; ++i) sum += Vec3::Dot(a[i], Vec3::Cross(b[i], t[i]));
+        });
+        Report("Dot(a, Cross(b, c))", ns, n, sum);
+    }
+
+    {
+        Quat acc;
+        double ns = TimeNs([&] {
+            for (std::size_t i = 0; i < n; ++i) acc = acc * q[i];
+        });
+        Report("Quat * Quat", ns, n, acc.s + acc.x + acc.y + acc.z);
+    }
+
+    {
+        Matrix3x3 acc = Matrix3x3::Identity();
+        double sum = 0.0;
+        double ns = TimeNs([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                acc = R[i].Multiply(acc.Transposed());
+                sum += acc.Multiply(a[i]).x;
+            }
+        });
+        Report("Matrix3x3 Multiply", ns, n, sum);
+    }
+
+    // Same TRS build the scene traversal does for each node, composed down chains of 8 nodes
+    {
+        Matrix4x4 parent = Matrix4x4::Identity();
+        double sum = 0.0;
+        double ns = TimeNs([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                Matrix4x4 local = Matrix4x4::FromTRS(t[i], R[i], s[i]);
+                Matrix4x4 global = parent.Multiply(local);
+                sum += global.At(0, 3);
+                parent = ((i & 7) == 7) ? Matrix4x4::Identity() : global;
+            }
+        });
+        Report("FromTRS + parent Multiply", ns, n, sum);
+    }
+
+    {
+        double sum = 0.0;
+        double ns = TimeNs([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                Matrix4x4 M = Matrix4x4::Translate(t[i]).Multiply(Matrix4x4::Scale(s[i]));
+                sum += M.Multiply(Vec4(a[i], 1.0)).x;
+            }
+        });
+        Report("Translate * Scale * Vec4", ns, n, sum);
+    }
+
+    return 0;
+}
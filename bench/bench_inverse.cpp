@@ -0,0 +1,129 @@
+// General Matrix4x4::Inverse against the specialized inverses, one run per SIMD level.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_inverse.cpp -o bench_inverse
+//
+// Usage: bench_inverse [count]
+#include "Affine3x4.hpp"
+#include "Matrix4x4.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+template<typename F>
+static double TimeNs(F&& body)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+static void Report(const char* level, const char* name, double ns, std::size_t ops, double checksum)
+{
+    std::printf("  %-8s %-26s %8.2f ns/op  (checksum %.6e)\n",
+        level, name, ns / static_cast<double>(ops), checksum);
+}
+
+// max |A * inv(A) - I|
+static double Residual(const Matrix4x4& A, const Matrix4x4& inv)
+{
+    Matrix4x4 P = A.Multiply(inv);
+    double worst = 0.0;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            worst = std::max(worst, std::fabs(P.At(i, j) - (i == j ? 1.0 : 0.0)));
+    return worst;
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> pos(-10.0, 10.0);
+    std::uniform_real_distribution<double> ang(-3.14159, 3.14159);
+    std::uniform_real_distribution<double> scl(0.5, 2.0);
+
+    // TR, TRS and a perspective * TRS mix (the last one only the general inverse handles)
+    std::vector<Matrix4x4> tr(n), trs(n), proj(n);
+    std::vector<Affine3x4> aff(n);
+    Matrix4x4 P{};
+    P.At(0, 0) = 1.2; P.At(1, 1) = 1.6; P.At(2, 2) = -1.002; P.At(2, 3) = -0.2002; P.At(3, 2) = -1.0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        Matrix3x3 R = Matrix3x3::FromEulerZYX(ang(rng), ang(rng), ang(rng));
+        Vec3 t{ pos(rng), pos(rng), pos(rng) };
+        tr[i] = Matrix4x4::FromTRS(t, R, { 1.0, 1.0, 1.0 });
+        trs[i] = Matrix4x4::FromTRS(t, R, { scl(rng), scl(rng), scl(rng) });
+        proj[i] = P.Multiply(trs[i]);
+        aff[i] = Affine3x4::FromMatrix4x4(trs[i]);
+    }
+
+    const Simd::Level best = Simd::Detect();
+    std::printf("count: %zu, best SIMD level: %s\n", n, Simd::Name(best));
+
+    std::vector<Matrix4x4> out(n);
+    std::vector<double> det(n);
+    for (int l = 0; l <= static_cast<int>(best); ++l)
+    {
+        Simd::SetActive(static_cast<Simd::Level>(l));
+        const char* level = Simd::Name(Simd::Active());
+
+        double worst = 0.0;
+        for (std::size_t i = 0; i < n; i += 97) worst = std::max(worst, Residual(proj[i], proj[i].Inverse()));
+        std::printf("  %-8s max |A * Inverse(A) - I| on projective: %.2e\n", level, worst);
+
+        {
+            double sum = 0.0;
+            double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += trs[i].Inverse().m[3]; });
+            Report(level, "Inverse (TRS input)", ns, n, sum);
+        }
+        {
+            double sum = 0.0;
+            double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += proj[i].Inverse().m[3]; });
+            Report(level, "Inverse (projective)", ns, n, sum);
+        }
+        {
+            double sum = 0.0;
+            double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += trs[i].InverseTransposed().m[12]; });
+            Report(level, "InverseTransposed", ns, n, sum);
+        }
+        {
+            double ns = TimeNs([&] { Matrix4x4::InverseBatch(proj, out, det); });
+            double sum = 0.0;
+            for (std::size_t i = 0; i < n; ++i) sum += out[i].m[3] + det[i];
+            Report(level, "InverseBatch (projective)", ns, n, sum);
+        }
+    }
+
+    // The specialized inverses don't go through the SIMD table
+    std::printf("specialized:\n");
+    {
+        double sum = 0.0;
+        double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += tr[i].InverseTR().m[3]; });
+        Report("", "Matrix4x4::InverseTR", ns, n, sum);
+    }
+    {
+        double sum = 0.0;
+        double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += trs[i].InverseTRS().m[3]; });
+        Report("", "Matrix4x4::InverseTRS", ns, n, sum);
+    }
+    {
+        double sum = 0.0;
+        double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += aff[i].Inverse().m[3]; });
+        Report("", "Affine3x4::Inverse", ns, n, sum);
+    }
+    {
+        double sum = 0.0;
+        double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += trs[i].NormalMatrix().m[0]; });
+        Report("", "NormalMatrix", ns, n, sum);
+    }
+
+    return 0;
+}
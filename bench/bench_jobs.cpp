@@ -0,0 +1,94 @@
+// Scene::UpdateWorld on the JobSystem: scaling with the thread count.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_jobs.cpp -o bench_jobs -pthread
+//
+// Usage: bench_jobs [--quick] [nodes] [max threads]     (default: 500k nodes; --quick: 20k)
+//
+// Two cases per thread count, both over the whole scene:
+//   world   every root moved: all world matrices recomputed, locals cached
+//   local   every node rotated: locals (Euler -> matrix) and world matrices recomputed
+// Every run is compared bit for bit with the serial UpdateWorld().
+#include "JobSystem.hpp"
+#include "Scene.hpp"
+#include "BenchScene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Random hierarchy with its world matrices
+static void Build(Scene& scene, std::size_t n, unsigned seed)
+{
+    RandomHierarchy(scene, n, seed, { .scaleJitter = 0.01 });
+    scene.UpdateWorld();
+}
+
+static void MoveRoots(Scene& scene, double t)
+{
+    for (GameObject* root : scene.Roots()) root->SetPosition({ t, 0.0, 0.0 });
+}
+
+static void RotateAll(Scene& scene, double t)
+{
+    for (std::size_t i = 0; i < scene.Size(); ++i)
+    {
+        GameObject* node = scene.Object(i);
+        Vec3 r = node->GetTransform().rotation;
+        r.z = t;
+        node->SetRotation(r);
+    }
+}
+
+// Best of a few frames; the edit (marking) is not timed
+template<typename Edit>
+static double TimeUpdate(Scene& scene, JobSystem* jobs, Edit&& edit)
+{
+    double best = 1e30;
+    for (int frame = 0; frame < 7; ++frame)
+    {
+        edit(scene, 0.25 * frame);
+        auto t0 = std::chrono::steady_clock::now();
+        if (jobs) scene.UpdateWorld(*jobs);
+        else scene.UpdateWorld();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = TakeFlag(argc, argv, "--quick");
+    const std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : quick ? 20000 : 500000;
+    unsigned maxThreads = (argc > 2) ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+    if (maxThreads == 0) maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    Scene serial, parallel;
+    Build(serial, n, 42);
+    Build(parallel, n, 42);
+    std::printf("Scene of %zu nodes, %u hardware threads\n", n, std::thread::hardware_concurrency());
+
+    const double worldSerial = TimeUpdate(serial, nullptr, MoveRoots);
+    const double localSerial = TimeUpdate(serial, nullptr, RotateAll);
+    std::printf("  %-8s %10s %10s %10s %10s\n", "threads", "world ms", "speedup", "local ms", "speedup");
+    std::printf("  %-8s %10.3f %10s %10.3f %10s\n", "serial", worldSerial, "1.00", localSerial, "1.00");
+
+    // The serial scene ends in the state of the last frame of RotateAll
+    bool ok = true;
+    for (unsigned threads = 1; threads <= maxThreads; threads = (threads == maxThreads) ? threads + 1 : std::min(2 * threads, maxThreads))
+    {
+        JobSystem jobs(threads);
+        const double world = TimeUpdate(parallel, &jobs, MoveRoots);
+        const double local = TimeUpdate(parallel, &jobs, RotateAll);
+        const bool same = SameScene(serial, parallel);
+        ok = ok && same;
+        std::printf("  %-8u %10.3f %10.2f %10.3f %10.2f%s\n", threads, world, worldSerial / world,
+            local, localSerial / local, same ? "" : "  MISMATCH");
+    }
+    return ok ? 0 : 1;
+}
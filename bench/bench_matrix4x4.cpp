@@ -0,0 +1,138 @@
+// Matrix4x4::Multiply benchmark on random scene hierarchies, one run per SIMD level.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_matrix4x4.cpp -o bench_matrix4x4
+//
+// Usage: bench_matrix4x4 [nodes]
+#include "Matrix4x4.hpp"
+#include "Simd.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct Hierarchy
+{
+    std::vector<int> parent;
+    std::vector<Matrix4x4> local;
+};
+
+static Hierarchy MakeHierarchy(std::size_t n, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> pos(-10.0, 10.0);
+    std::uniform_real_distribution<double> ang(-3.14159, 3.14159);
+    std::uniform_real_distribution<double> scl(0.5, 2.0);
+
+    Hierarchy h;
+    h.parent.resize(n);
+    h.local.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        h.parent[i] = (i == 0) ? -1 : static_cast<int>(rng() % i);
+        Matrix3x3 R = Matrix3x3::FromEulerZYX(ang(rng), ang(rng), ang(rng));
+        h.local[i] = Matrix4x4::FromTRS({ pos(rng), pos(rng), pos(rng) }, R, { scl(rng), scl(rng), scl(rng) });
+    }
+    return h;
+}
+
+// Same shape as GameObject::GetGlobalMatrix: every node walks up to the root
+static Matrix4x4 Global(const Hierarchy& h, int i, std::size_t& multiplies)
+{
+    if (h.parent[i] < 0) return h.local[i];
+    ++multiplies;
+    return Global(h, h.parent[i], multiplies).Multiply(h.local[i]);
+}
+
+// Max error in units of u * sum_k |a_ik * b_kj| (see the bound in Simd.hpp)
+static double MaxScaledError(const Matrix4x4& A, const Matrix4x4& B, const Matrix4x4& ref, const Matrix4x4& got)
+{
+    const double u = std::ldexp(1.0, -53);
+    double worst = 0.0;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            double mag = 0.0;
+            for (int k = 0; k < 4; ++k) mag += std::fabs(A.At(i, k) * B.At(k, j));
+            if (mag == 0.0) continue;
+            worst = std::max(worst, std::fabs(ref.At(i, j) - got.At(i, j)) / (u * mag));
+        }
+    }
+    return worst;
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t nodes = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    Hierarchy h = MakeHierarchy(nodes, 1234);
+
+    const Simd::Level best = Simd::Detect();
+    std::printf("nodes: %zu, best SIMD level: %s\n", nodes, Simd::Name(best));
+
+    // Accuracy on random products, against the scalar reference
+    {
+        std::mt19937 rng(42);
+        for (int l = 0; l <= static_cast<int>(best); ++l)
+        {
+            Simd::SetActive(static_cast<Simd::Level>(l));
+            double worst = 0.0;
+            for (int it = 0; it < 100000; ++it)
+            {
+                const Matrix4x4& A = h.local[rng() % nodes];
+                const Matrix4x4& B = h.local[rng() % nodes];
+                Matrix4x4 ref;
+                Simd::Mat4MulScalar(A.m, B.m, ref.m);
+                worst = std::max(worst, MaxScaledError(A, B, ref, A.Multiply(B)));
+            }
+            std::printf("  %-8s max error: %.2f u * sum|a*b| (bound 8)\n", Simd::Name(Simd::Active()), worst);
+        }
+    }
+
+    double scalarNs = 0.0;
+    for (int l = 0; l <= static_cast<int>(best); ++l)
+    {
+        Simd::SetActive(static_cast<Simd::Level>(l));
+
+        double checksum = 0.0;
+        std::size_t multiplies = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < nodes; ++i)
+        {
+            Matrix4x4 g = Global(h, static_cast<int>(i), multiplies);
+            checksum += g.m[3];
+        }
+        auto t1 = std::chrono::steady_clock::now();
+
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        const double nsPerMul = ns / static_cast<double>(multiplies);
+        if (l == 0) scalarNs = ns;
+        std::printf("  %-8s %10.2f ms  %6.2f ns/multiply  %7.2fx  (checksum %.6e)\n",
+            Simd::Name(Simd::Active()), ns * 1e-6, nsPerMul, scalarNs / ns, checksum);
+    }
+
+    // Matrix x Vec4
+    for (int l = 0; l <= static_cast<int>(best); ++l)
+    {
+        Simd::SetActive(static_cast<Simd::Level>(l));
+        Vec4 acc(0, 0, 0, 0);
+        const int reps = 20;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+        {
+            for (std::size_t i = 0; i < nodes; ++i)
+            {
+                Vec4 v = h.local[i].Multiply(Vec4(1.0, 2.0, 3.0, 1.0));
+                acc.x += v.x; acc.y += v.y; acc.z += v.z; acc.w += v.w;
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        std::printf("  %-8s Multiply(Vec4): %6.2f ns/op  (checksum %.6e)\n",
+            Simd::Name(Simd::Active()), ns / (static_cast<double>(nodes) * reps), acc.x + acc.y + acc.z + acc.w);
+    }
+
+    return 0;
+}
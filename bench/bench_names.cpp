@@ -0,0 +1,150 @@
+// Scene names and tags: naming, lookup, prefix search and upkeep times over a large
+// scene, against comparing the strings of every node.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_names.cpp -o bench_names -pthread
+//
+// Usage: bench_names [--quick] [nodes]     (default: 1M; --quick: 20k)
+//
+// Node i is named "Node <i>" and tagged "Tag <i % 16>". After renaming 1% of the
+// nodes, destroying some subtrees and a Save / Load round trip, every lookup must give
+// the same nodes as the brute force one.
+#include "Scene.hpp"
+#include "BenchScene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// Every node whose name (or tag) passes test
+template<typename F>
+static void Brute(const Scene& scene, bool byTag, F&& test, std::vector<GameObjectHandle>& out)
+{
+    for (std::size_t i = 0; i < scene.Size(); ++i)
+    {
+        const GameObject* node = scene.Object(i);
+        if (test(byTag ? node->GetTag() : node->GetName())) out.push_back(node->GetHandle());
+    }
+}
+
+// The lookups of queries against the brute force ones; false on a mismatch
+static bool Check(const Scene& scene, const std::vector<std::string>& queries)
+{
+    std::vector<GameObjectHandle> a, b;
+    for (const std::string& q : queries)
+    {
+        a.clear(); b.clear();
+        scene.FindAllByName(q, a);
+        Brute(scene, false, [&](std::string_view s) { return !s.empty() && s == q; }, b);
+        if (!SameSet(a, b)) return false;
+        const GameObject* any = scene.FindByName(q);
+        if ((any == nullptr) != b.empty() || (any && any->GetName() != q)) return false;
+
+        a.clear(); b.clear();
+        scene.SearchByName(q, a);
+        Brute(scene, false, [&](std::string_view s) { return !s.empty() && s.starts_with(q); }, b);
+        if (!SameSet(a, b)) return false;
+    }
+    for (int k = 0; k < 16; ++k)
+    {
+        const std::string tag = "Tag " + std::to_string(k);
+        a.clear(); b.clear();
+        scene.FindAllByTag(tag, a);
+        Brute(scene, true, [&](std::string_view s) { return s == tag; }, b);
+        if (!SameSet(a, b)) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = TakeFlag(argc, argv, "--quick");
+    const std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : quick ? 20000 : 1000000;
+    Scene scene;
+    RandomHierarchy(scene, n, 42, { .transforms = false });
+    std::printf("%zu nodes\n", n);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        scene.Object(i)->SetName("Node " + std::to_string(i));
+        scene.Object(i)->SetTag("Tag " + std::to_string(i % 16));
+    }
+    std::printf("  %-30s %9.2f ms  (%.0f ns/node, %zu strings)\n", "SetName + SetTag", Ms(t0), Ms(t0) * 1e6 / n,
+        scene.Strings().Size());
+    t0 = std::chrono::steady_clock::now();
+    std::vector<GameObjectHandle> first;
+    scene.SearchByName("Node", first, 1);
+    std::printf("  %-30s %9.2f ms  (sorts the new strings)\n", "First search", Ms(t0));
+
+    // Queries: exact names, and prefixes from 1 to 3 digits short of a full name
+    std::mt19937 rng(7);
+    std::vector<std::string> queries;
+    for (int k = 0; k < 1000; ++k)
+    {
+        const std::string name = "Node " + std::to_string(rng() % n);
+        queries.push_back(name.substr(0, name.size() - k % 4));
+    }
+    std::vector<std::string> checked(queries.begin(), queries.begin() + 8);
+    checked.push_back("Missing");
+    bool ok = Check(scene, checked);
+
+    std::vector<GameObjectHandle> out;
+    auto timeQuery = [&](const char* what, auto&& indexed, auto&& brute) {
+        std::size_t found = 0;
+        auto q0 = std::chrono::steady_clock::now();
+        for (const std::string& q : queries) { out.clear(); indexed(q); found += out.size(); }
+        const double indexedUs = Ms(q0) * 1e3 / queries.size();
+        const std::size_t bruteCount = 10;
+        q0 = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < bruteCount; ++k) { out.clear(); brute(queries[k]); }
+        const double bruteUs = Ms(q0) * 1e3 / bruteCount;
+        std::printf("  %-30s %9.2f us  brute force %9.2f us  (%.0fx, %.1f found)\n", what, indexedUs, bruteUs,
+            bruteUs / indexedUs, double(found) / queries.size());
+    };
+    timeQuery("FindAllByName",
+        [&](const std::string& q) { scene.FindAllByName(q, out); },
+        [&](const std::string& q) { Brute(scene, false, [&](std::string_view s) { return s == q; }, out); });
+    timeQuery("SearchByName (prefix, 200)",
+        [&](const std::string& q) { scene.SearchByName(q, out, 200); },
+        [&](const std::string& q) {
+            Brute(scene, false, [&](std::string_view s) { return s.starts_with(q); }, out);
+            if (out.size() > 200) out.resize(200);
+        });
+    timeQuery("FindAllByTag",
+        [&](const std::string&) { scene.FindAllByTag("Tag 3", out); },
+        [&](const std::string&) { Brute(scene, true, [&](std::string_view s) { return s == "Tag 3"; }, out); });
+
+    // Upkeep: renames, then subtrees destroyed
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    t0 = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < n / 100; ++k)
+        scene.Object(rng() % scene.Size())->SetName("Renamed " + std::to_string(k % 1000));
+    std::printf("  %-30s %9.2f ms\n", "Rename 1% of nodes", Ms(t0));
+    t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < 10; ++k) scene.Destroy(scene.Object(rng() % scene.Size()));
+    std::printf("  %-30s %9.2f ms  (%zu nodes left; moves the arrays)\n", "Destroy 10 subtrees", Ms(t0), scene.Size());
+    checked.push_back("Renamed 1");
+    checked.push_back("Renamed");
+    ok = Check(scene, checked) && ok;
+
+    // Round trip through a snapshot
+    const char* path = "bench_names.bin";
+    t0 = std::chrono::steady_clock::now();
+    scene.Save(path);
+    const double save = Ms(t0);
+    Scene loaded;
+    t0 = std::chrono::steady_clock::now();
+    loaded.Load(path);
+    std::printf("  %-30s %9.2f ms  load %.2f ms\n", "Save (with names)", save, Ms(t0));
+    std::remove(path);
+    for (std::size_t i = 0; i < scene.Size() && ok; ++i)
+        ok = loaded.Object(i)->GetName() == scene.Object(i)->GetName() && loaded.Object(i)->GetTag() == scene.Object(i)->GetTag();
+    ok = Check(loaded, checked) && ok;
+
+    if (!ok) std::printf("  MISMATCH between the indexes and the brute force lookups\n");
+    return ok ? 0 : 1;
+}
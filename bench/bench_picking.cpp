@@ -0,0 +1,147 @@
+// Picker: mouse picking times over a large scene (BVH + SIMD ray / triangle tests), and
+// the picks against testing the triangles of every node.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_picking.cpp -o bench_picking -pthread
+//
+// Usage: bench_picking [--quick] [nodes]     (default: 100k and 1M; --quick: 20k)
+//
+// Every node has the unit cube as mesh (12 triangles). Half of the rays go through
+// random pixels, the other half through the center of a random node. Each pick must
+// hit at the same distance as the brute force one, at every SIMD level.
+#include "Picker.hpp"
+#include "Simd.hpp"
+#include "BenchScene.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Roots spread over the whole world, children around their parent
+static const HierarchyShape shape = { .rootSpread = 200.0, .childSpread = 2.0, .rootScale = 0.5 };
+
+// Unit cube centered at the origin, 12 triangles
+static PickMesh Cube()
+{
+    std::vector<float> positions;
+    for (int k = 0; k < 8; ++k)
+        for (int axis = 0; axis < 3; ++axis) positions.push_back(((k >> axis) & 1) ? 0.5f : -0.5f);
+    const std::vector<unsigned> indices = {
+        0, 2, 3, 0, 3, 1,   4, 5, 7, 4, 7, 6,   // -z, +z
+        0, 1, 5, 0, 5, 4,   2, 6, 7, 2, 7, 3,   // -y, +y
+        0, 4, 6, 0, 6, 2,   1, 3, 7, 1, 7, 5,   // -x, +x
+    };
+    return PickMesh::FromIndexed(positions, indices);
+}
+
+static bool Run(std::size_t n)
+{
+    Scene scene;
+    RandomHierarchy(scene, n, 42, shape);
+    scene.UpdateWorld();
+    const std::vector<PickMesh> meshes = { Cube() };
+    const std::vector<AABB> meshBounds = { meshes[0].Bounds() };
+    std::printf("%zu nodes\n", n);
+
+    BVH bvh;
+    auto t0 = std::chrono::steady_clock::now();
+    bvh.Build(scene, meshBounds);
+    std::printf("  %-24s %9.2f ms\n", "BVH build", Ms(t0));
+
+    // Camera at z = 450 looking down -z, 60 degrees, 1280 x 720, as Camera in the app
+    const double fovY = 60.0 * 3.14159265358979323846 / 180.0, aspect = 1280.0 / 720.0, near = 0.1, far = 1000.0;
+    const double t = std::tan(fovY / 2.0) * near, r = t * aspect;
+    Matrix4x4 P{};
+    P.At(0, 0) = near / r;
+    P.At(1, 1) = near / t;
+    P.At(2, 2) = -(far + near) / (far - near);
+    P.At(2, 3) = -(2.0 * far * near) / (far - near);
+    P.At(3, 2) = -1.0;
+    const Matrix4x4 VP = P.Multiply(Matrix4x4::Translate({ 0.0, 0.0, -450.0 }));
+    const Matrix4x4 inverseVP = VP.Inverse();
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<Ray> rays;
+    const std::span<const Affine3x4> world = scene.World();
+    for (int k = 0; k < 1000; ++k)
+    {
+        if (k % 2 == 0)
+        {
+            rays.push_back(Picker::ScreenRay(inverseVP, 1280.0 * u(rng), 720.0 * u(rng), 1280.0, 720.0));
+            continue;
+        }
+        const Affine3x4& m = world[rng() % n];
+        const Vec3 ndc = VP.TransformPoint({ m.m[3], m.m[7], m.m[11] });
+        rays.push_back(Picker::ScreenRay(inverseVP, ndc.x, ndc.y));
+    }
+
+    // Brute force: the triangles of every node, nearest hit
+    auto brute = [&](const Ray& ray, double& best) {
+        best = 1.0;
+        bool found = false;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const Affine3x4 inverse = world[i].Inverse();
+            const Ray local = Ray::FromOriginDirection(inverse.TransformPoint(ray.origin),
+                inverse.TransformVector(ray.direction));
+            std::size_t triangle;
+            found = meshes[0].Raycast(local, best, triangle) || found;
+        }
+        return found;
+    };
+    const std::size_t bruteCount = (n > 200000) ? 5 : 20;
+    std::vector<double> expected(bruteCount);
+    std::vector<bool> expectedHit(bruteCount);
+    t0 = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < bruteCount; ++k)
+    {
+        double best;
+        expectedHit[k] = brute(rays[k], best);
+        expected[k] = best;
+    }
+    const double bruteMs = Ms(t0) / bruteCount;
+    std::printf("  %-24s %9.2f ms/pick\n", "Brute force", bruteMs);
+
+    const Simd::Level best = Simd::Detect();
+    bool ok = true;
+    Picker picker;
+    for (Simd::Level level : { Simd::Level::Scalar, Simd::Level::SSE2, Simd::Level::AVX2 })
+    {
+        if (level > best) continue;
+        Simd::SetActive(level);
+        std::size_t mismatches = 0, hits = 0, objects = 0, triangles = 0;
+        double worst = 0.0;
+        t0 = std::chrono::steady_clock::now();
+        for (std::size_t k = 0; k < rays.size(); ++k)
+        {
+            Picker::Hit hit;
+            const bool found = picker.Pick(scene, bvh, meshes, rays[k], 1.0, hit);
+            hits += found;
+            objects += picker.GetStats().objectsTested;
+            triangles += picker.GetStats().trianglesTested;
+            worst = std::max(worst, picker.GetStats().ms);
+            if (k < bruteCount && (found != expectedHit[k] || (found && hit.t != expected[k]))) ++mismatches;
+        }
+        const double ms = Ms(t0) / rays.size();
+        std::printf("  Pick, %-18s %9.4f ms/pick (worst %.4f ms, %.0fx)  %.1f objects, %.0f triangles, %zu/%zu hit%s\n",
+            Simd::Name(level), ms, worst, bruteMs / ms, double(objects) / rays.size(), double(triangles) / rays.size(),
+            hits, rays.size(), mismatches ? "  MISMATCH" : "");
+        ok = ok && mismatches == 0;
+    }
+    Simd::SetActive(best);
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = TakeFlag(argc, argv, "--quick");
+    std::vector<std::size_t> sizes = { 100000, 1000000 };
+    if (quick) sizes = { 20000 };
+    if (argc > 1) sizes = { std::strtoull(argv[1], nullptr, 10) };
+    bool ok = true;
+    for (std::size_t n : sizes) ok = Run(n) && ok;
+    return ok ? 0 : 1;
+}
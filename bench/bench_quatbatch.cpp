@@ -0,0 +1,95 @@
+// QuatBatch / Vec3Batch (SoA) against loops over Quat / Vec3 (AoS), one run per SIMD level.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_quatbatch.cpp -o bench_quatbatch
+//
+// Usage: bench_quatbatch [count]   (default 4096, cache resident; repeated to ~8M ops)
+#include "QuatBatch.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static std::size_t reps = 1;
+
+// Runs body once to warm up (first touch of the outputs), then times reps runs
+template<typename F>
+static double TimeNs(F&& body)
+{
+    body();
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < reps; ++r) body();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(reps);
+}
+
+static void Report(const char* level, const char* name, double ns, std::size_t ops, double checksum)
+{
+    std::printf("  %-8s %-22s %8.2f ns/op  (checksum %.6e)\n", level, name, ns / static_cast<double>(ops), checksum);
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    reps = std::max<std::size_t>(1, 8000000 / n);
+
+    std::mt19937 rng(1234);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::vector<Quat> a(n), b(n), q(n);
+    std::vector<Vec3> v(n), r(n);
+    std::vector<Matrix3x3> m(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = Quat{ gauss(rng), gauss(rng), gauss(rng), gauss(rng) }.Normalized();
+        b[i] = Quat{ gauss(rng), gauss(rng), gauss(rng), gauss(rng) }.Normalized();
+        v[i] = { gauss(rng), gauss(rng), gauss(rng) };
+    }
+    std::printf("count: %zu x %zu runs, best SIMD level: %s\n", n, reps, Simd::Name(Simd::Detect()));
+
+    // AoS baseline
+    {
+        double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) q[i] = a[i] * b[i]; });
+        Report("AoS", "Multiply", ns, n, q[n / 2].x);
+        ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) r[i] = a[i].Rotate(v[i]); });
+        Report("AoS", "Rotate", ns, n, r[n / 2].x);
+        ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) q[i] = b[i].Normalized(); });
+        Report("AoS", "Normalized", ns, n, q[n / 2].x);
+        ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) m[i] = a[i].ToMatrix3x3Unchecked(); });
+        Report("AoS", "ToMatrix3x3Unchecked", ns, n, m[n / 2].m[1]);
+    }
+
+    QuatBatch A, B, Q;
+    Vec3Batch V, R;
+    {
+        double ns = TimeNs([&] { A = QuatBatch::Gather(a); B = QuatBatch::Gather(b); V = Vec3Batch::Gather(v); });
+        Report("", "Gather (3 arrays)", ns, 3 * n, A.x[n / 2]);
+    }
+
+    for (int l = 0; l <= static_cast<int>(Simd::Detect()); ++l)
+    {
+        Simd::SetActive(static_cast<Simd::Level>(l));
+        const char* level = Simd::Name(Simd::Active());
+
+        double ns = TimeNs([&] { A.Multiply(B, Q); });
+        Report(level, "Multiply", ns, n, Q.x[n / 2]);
+        ns = TimeNs([&] { QuatBatch::Multiply(a[0], B, Q); });
+        Report(level, "Multiply (broadcast)", ns, n, Q.x[n / 2]);
+        ns = TimeNs([&] { A.Rotate(V, R); });
+        Report(level, "Rotate", ns, n, R.x[n / 2]);
+        ns = TimeNs([&] { B.Normalize(Q); });
+        Report(level, "Normalize", ns, n, Q.x[n / 2]);
+        ns = TimeNs([&] { A.Conjugate(Q); });
+        Report(level, "Conjugate", ns, n, Q.x[n / 2]);
+        ns = TimeNs([&] { A.ToMatrix3x3(m); });
+        Report(level, "ToMatrix3x3", ns, n, m[n / 2].m[1]);
+    }
+
+    {
+        double ns = TimeNs([&] { Q.Scatter(q); });
+        Report("", "Scatter", ns, n, q[n / 2].x);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Scene::Save / Scene::Load: binary snapshot throughput at 10k, 100k and 1M nodes.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_scenefile.cpp -o bench_scenefile -pthread
+//
+// Usage: bench_scenefile [--quick] [file] [max nodes]     (default: up to 1M; --quick: 10k)
+//
+// Per size: Save, Load (file -> arrays + handles) and Load followed by the first
+// UpdateWorld. The file is left in the page cache by the Save before it, so Load
+// measures the mapping and the copies, not the disk. Every load is checked against the
+// saved scene.
+#include "Scene.hpp"
+#include "BenchScene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+template<typename F>
+static double BestMs(int runs, F&& body)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        body();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = TakeFlag(argc, argv, "--quick");
+    const std::string path = (argc > 1) ? argv[1] : "bench_scene.bin";
+    const std::size_t maxNodes = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : quick ? 10000 : 1000000;
+
+    std::printf("Scene snapshot %s: best of 5 runs\n", path.c_str());
+    std::printf("  %-9s %9s %10s %10s %10s %14s\n", "nodes", "file MB", "save ms", "load ms", "+world ms", "load ns/node");
+    bool ok = true;
+    for (std::size_t n = 10000; n <= maxNodes; n *= 10)
+    {
+        Scene scene;
+        RandomHierarchy(scene, n, 42, { .meshes = 4 });
+        scene.UpdateWorld();
+
+        const double save = BestMs(5, [&] { scene.Save(path); });
+        Scene loaded;
+        const double load = BestMs(5, [&] { loaded.Load(path); });
+        const double loadWorld = BestMs(5, [&] { loaded.Load(path); loaded.UpdateWorld(); });
+        const bool same = SameScene(scene, loaded);
+        ok = ok && same;
+
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        long bytes = 0;
+        if (f) { std::fseek(f, 0, SEEK_END); bytes = std::ftell(f); std::fclose(f); }
+        std::printf("  %-9zu %9.2f %10.3f %10.3f %10.3f %14.2f%s\n", n, bytes / 1048576.0, save, load, loadWorld,
+            1e6 * load / static_cast<double>(n), same ? "" : "  MISMATCH");
+    }
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+// Quat::Slerp modes, SlerpBatch and SlerpStepper: angular error and throughput.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_slerp.cpp -o bench_slerp
+//
+// Usage: bench_slerp [count]
+#include "Quat.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+template<typename F>
+static double TimeNs(F&& body)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+static void Report(const char* name, double ns, std::size_t ops, double checksum)
+{
+    std::printf("  %-28s %8.2f ns/op  (checksum %.6e)\n", name, ns / static_cast<double>(ops), checksum);
+}
+
+// Reference: long double, libm
+static Quat SlerpReference(const Quat& a, Quat b, double t)
+{
+    long double dot = (long double)a.s * b.s + (long double)a.x * b.x + (long double)a.y * b.y + (long double)a.z * b.z;
+    if (dot < 0) { b = { -b.s, -b.x, -b.y, -b.z }; dot = -dot; }
+    dot = std::min(dot, 1.0L);
+    const long double theta = std::acos(dot);
+    if (theta < 1e-12L) return a;
+    const long double wb = std::sin(theta * t) / std::sin(theta);
+    const long double wa = std::cos(theta * t) - dot * wb;
+    return { double(wa * a.s + wb * b.s), double(wa * a.x + wb * b.x), double(wa * a.y + wb * b.y), double(wa * a.z + wb * b.z) };
+}
+
+// Rotation angle between two unit quaternions
+static double AngleBetween(const Quat& p, const Quat& q)
+{
+    Quat d = Quat{ p.s, -p.x, -p.y, -p.z } * q;
+    return 2.0 * std::atan2(std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z), std::fabs(d.s));
+}
+
+// The per-frame Slerp the app used before: normalizes, acos, sin and cos four times
+static Quat SlerpLegacy(const Quat& a, const Quat& b, double t)
+{
+    Quat q1 = a.Normalized();
+    Quat q2 = b.Normalized();
+    double dot = q1.s * q2.s + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
+    if (dot < 0.0) { q2 = { -q2.s, -q2.x, -q2.y, -q2.z }; dot = -dot; }
+    if (dot > 0.9995) {
+        Quat r{ q1.s + t * (q2.s - q1.s), q1.x + t * (q2.x - q1.x), q1.y + t * (q2.y - q1.y), q1.z + t * (q2.z - q1.z) };
+        return r.Normalized();
+    }
+    double theta_0 = std::acos(dot);
+    double theta = theta_0 * t;
+    double sin_theta = std::sin(theta);
+    double sin_theta_0 = std::sin(theta_0);
+    Quat r;
+    r.s = (std::cos(theta) - dot * sin_theta / sin_theta_0) * q1.s + (sin_theta / sin_theta_0) * q2.s;
+    r.x = (std::cos(theta) - dot * sin_theta / sin_theta_0) * q1.x + (sin_theta / sin_theta_0) * q2.x;
+    r.y = (std::cos(theta) - dot * sin_theta / sin_theta_0) * q1.y + (sin_theta / sin_theta_0) * q2.y;
+    r.z = (std::cos(theta) - dot * sin_theta / sin_theta_0) * q1.z + (sin_theta / sin_theta_0) * q2.z;
+    return r.Normalized();
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    std::mt19937 rng(1234);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto randomQuat = [&] { return Quat{ gauss(rng), gauss(rng), gauss(rng), gauss(rng) }.Normalized(); };
+
+    std::vector<Quat> a(n), b(n), out(n);
+    std::vector<double> t(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = randomQuat();
+        b[i] = randomQuat();
+        t[i] = unit(rng);
+    }
+    std::printf("count: %zu, SIMD level: %s\n", n, Simd::Name(Simd::Active()));
+
+    // Angular error against the long double reference
+    {
+        double eExact = 0.0, eFast = 0.0, eFastf = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const Quat ref = SlerpReference(a[i], b[i], t[i]);
+            eExact = std::max(eExact, AngleBetween(ref, Quat::Slerp(a[i], b[i], t[i], SlerpMode::Exact)));
+            eFast = std::max(eFast, AngleBetween(ref, Quat::Slerp(a[i], b[i], t[i], SlerpMode::Fast)));
+            const Quatf f = Quatf::Slerp(a[i].Cast<float>(), b[i].Cast<float>(), float(t[i]), SlerpMode::Fast);
+            eFastf = std::max(eFastf, AngleBetween(ref, f.Cast<double>().Normalized()));
+        }
+        std::printf("max angular error: Exact %.2e rad, Fast %.2e rad (float %.2e rad)\n", eExact, eFast, eFastf);
+
+        double eStep = 0.0, eStepf = 0.0;
+        const int steps = 1000;
+        for (std::size_t i = 0; i < std::min<std::size_t>(n, 200); ++i)
+        {
+            SlerpStepper st(a[i], b[i], steps);
+            SlerpStepperf stf(a[i].Cast<float>(), b[i].Cast<float>(), steps);
+            for (int k = 1; k < steps; ++k)
+            {
+                const Quat ref = SlerpReference(a[i], b[i], double(k) / steps);
+                eStep = std::max(eStep, AngleBetween(ref, st.Next()));
+                eStepf = std::max(eStepf, AngleBetween(ref, stf.Next().Cast<double>().Normalized()));
+            }
+        }
+        std::printf("SlerpStepper over %d steps: max angular error %.2e rad (float %.2e rad)\n", steps, eStep, eStepf);
+    }
+
+    // Throughput
+    {
+        double sum = 0.0;
+        double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += SlerpLegacy(a[i], b[i], t[i]).x; });
+        Report("legacy (libm, normalizes)", ns, n, sum);
+    }
+    {
+        double sum = 0.0;
+        double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += Quat::Slerp(a[i], b[i], t[i]).x; });
+        Report("Slerp Exact", ns, n, sum);
+    }
+    {
+        double sum = 0.0;
+        double ns = TimeNs([&] { for (std::size_t i = 0; i < n; ++i) sum += Quat::Slerp(a[i], b[i], t[i], SlerpMode::Fast).x; });
+        Report("Slerp Fast", ns, n, sum);
+    }
+    {
+        double ns = TimeNs([&] { Quat::SlerpBatch(a, b, t, out, SlerpMode::Exact); });
+        double sum = 0.0;
+        for (const Quat& q : out) sum += q.x;
+        Report("SlerpBatch Exact", ns, n, sum);
+    }
+    {
+        double ns = TimeNs([&] { Quat::SlerpBatch(a, b, t, out, SlerpMode::Fast); });
+        double sum = 0.0;
+        for (const Quat& q : out) sum += q.x;
+        Report("SlerpBatch Fast", ns, n, sum);
+    }
+    {
+        // Same pair sampled at n evenly spaced t
+        SlerpStepper st(a[0], b[0], static_cast<int>(n));
+        double sum = 0.0;
+        double ns = TimeNs([&] { while (!st.Done()) sum += st.Next().x; });
+        Report("SlerpStepper::Next", ns, n, sum);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+// SceneStreamer: frame time while a large subtree is streamed into a live scene,
+// against splicing it in one go.
+//
+// Build (headless, no SDL/GLEW needed):
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_streaming.cpp -o bench_streaming -pthread
+//
+// Usage: bench_streaming [--quick] [subtree nodes] [budget ms]     (default: 1M; --quick: 20k)
+//
+// The scene has 100k nodes. A "frame" is SceneStreamer::Update(budget) followed by
+// Scene::UpdateWorld. Two destinations: new roots (appended at the end of the arrays, in
+// blocks) and the children of a node in the middle of the scene (one pass). The
+// streamed scene must end up equal to the one-shot splice, and every Update within its
+// bound: 2 x budget + 1 ms for blocks, half the one-shot time for a growth step of the
+// arrays, 1.5 x the one-shot time (+ budget) for the one pass.
+#include "SceneStreamer.hpp"
+#include "BenchScene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+static bool Run(const char* where, std::size_t baseNodes, std::size_t subtreeNodes, double budget, bool middle)
+{
+    Scene source;
+    RandomHierarchy(source, subtreeNodes, 7);
+
+    // One shot, as a synchronous import would do inside the frame
+    Scene once;
+    RandomHierarchy(once, baseNodes, 42);
+    once.UpdateWorld();
+    auto t0 = std::chrono::steady_clock::now();
+    once.InsertNodes(middle ? once.Object(baseNodes / 2) : nullptr, source.Transforms(), source.Parents(), source.Meshes());
+    once.UpdateWorld();
+    const double oneShot = Ms(t0);
+
+    // Streamed: the loader builds the same subtree while the frames go on
+    Scene scene;
+    RandomHierarchy(scene, baseNodes, 42);
+    scene.UpdateWorld();
+    SceneStreamer streamer(scene);
+    auto request = streamer.Request([&](Scene& s) { RandomHierarchy(s, subtreeNodes, 7); },
+        middle ? scene.Object(baseNodes / 2) : nullptr);
+
+    // Every Update while the subtree is spliced, by what it did
+    struct Kind {
+        int count = 0;
+        double worst = 0.0, total = 0.0;
+        void Add(double ms) { ++count; worst = std::max(worst, ms); total += ms; }
+    };
+    Kind blocks, growth, onePass;
+    int frames = 0;
+    double worstFrame = 0.0;
+    // Capacity of the node arrays, without the pool chunks
+    auto arrayBytes = [&] {
+        const Scene::MemoryStats m = scene.GetMemoryStats();
+        return m.reservedBytes - m.slots * sizeof(GameObject);
+    };
+    t0 = std::chrono::steady_clock::now();
+    while (request->GetState() != StreamRequest::State::Done)
+    {
+        const std::size_t reserved = arrayBytes();
+        const std::size_t spliced = request->NodesSpliced();
+        const auto f0 = std::chrono::steady_clock::now();
+        const double update = streamer.Update(budget);
+        scene.UpdateWorld();
+        const double frame = Ms(f0);
+        if (request->GetState() == StreamRequest::State::Failed) break;
+        if (request->GetState() == StreamRequest::State::Queued || request->GetState() == StreamRequest::State::Building)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ++frames;
+        worstFrame = std::max(worstFrame, frame);
+        if (middle && spliced == 0 && request->NodesSpliced() == subtreeNodes) onePass.Add(update);
+        else if (arrayBytes() != reserved) growth.Add(update);
+        else blocks.Add(update);
+    }
+    const double wall = Ms(t0);
+    const bool same = SameScene(once, scene);
+
+    // The bounds: a frame of blocks keeps to the budget (with some room for the timer
+    // and the scheduler), a growth step copies one array of the ten the one-shot splice
+    // reallocates, and the one pass costs about what the one-shot splice does
+    const double blockBound = 2.0 * budget + 1.0;
+    const double growthBound = std::max(blockBound, oneShot / 2);
+    const double onePassBound = 1.5 * oneShot + budget;
+    const bool inBudget = blocks.worst <= blockBound && growth.worst <= growthBound && onePass.worst <= onePassBound;
+
+    std::printf("  %-8s one shot %8.2f ms | streamed: %5d frames (worst %7.2f ms), %8.1f ms wall, "
+        "%8.1f ms in Update%s%s\n", where, oneShot, frames, worstFrame, wall,
+        blocks.total + growth.total + onePass.total, same ? "" : "  MISMATCH", inBudget ? "" : "  OVER BOUND");
+    std::printf("           Update: %4d of blocks, worst %7.2f ms (bound %.2f)\n", blocks.count, blocks.worst, blockBound);
+    if (growth.count)
+        std::printf("                   %4d growing the arrays, worst %7.2f ms (bound %.2f)\n", growth.count, growth.worst,
+            growthBound);
+    if (onePass.count)
+        std::printf("                   %4d in one pass, %7.2f ms (bound %.2f)\n", onePass.count, onePass.worst, onePassBound);
+    return same && inBudget;
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = TakeFlag(argc, argv, "--quick");
+    const std::size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : quick ? 20000 : 1000000;
+    const double budget = (argc > 2) ? std::atof(argv[2]) : 2.0;
+    const std::size_t base = 100000;
+
+    std::printf("Streaming a %zu-node subtree into a %zu-node scene, budget %.2f ms per frame\n", n, base, budget);
+    bool ok = Run("roots", base, n, budget, false);
+    ok = Run("middle", base, n, budget, true) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,573 @@
+// Math library micro-benchmark suite: every public op of Matrix3x3, Matrix4x4, Affine3x4,
+// Quat, DualQuat, FastMath and QuatBatch in double and float, plus scene traversal on
+// random N-node hierarchies (Scene store included). Reports ns/op and ops/s, writes JSON
+// and compares it with a stored baseline so that optimizations and regressions are
+// measurable.
+//
+// Build (headless, no SDL/GLEW needed):
+//   cmake -S . -B build && cmake --build build --target bench_suite
+// or
+//   g++ -O2 -std=c++20 -Iinclude src/*.cpp bench/bench_suite.cpp -o bench_suite
+//
+// Usage: bench_suite [options]
+//   --quick                 short runs and small scenes (smoke test, ctest)
+//   --filter <text>         only the cases whose name contains text
+//   --nodes <n,n,...>       scene sizes (default 1024,65536; quick: 1024)
+//   --simd <level>          scalar, sse2, avx2 or avx512 (default: best detected)
+//   --json <file>           writes the results; bench/baseline.json is such a file
+//   --baseline <file>       compares with a previous --json output
+//   --tolerance <x>         relative change reported as faster / slower (default 0.10)
+//   --fail-on-regression    exit code 1 when a case is slower than the tolerance
+//
+// Baselines are machine dependent: regenerate bench/baseline.json on the machine that
+// compares against it (bench_suite --json bench/baseline.json).
+#include "DualQuat.hpp"
+#include "FastMath.hpp"
+#include "Scene.hpp"
+#include "QuatBatch.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct Result
+{
+    std::string name;
+    double nsPerOp = 0.0;
+    double checksum = 0.0;
+};
+
+class Suite
+{
+public:
+    std::string filter;
+    double sampleNs = 4e6;      // Target duration of one sample
+    int samples = 5;            // Best of
+    std::vector<Result> results;
+
+    // body() processes ops elements and returns a checksum, so nothing is optimized away
+    template<typename F>
+    void Run(const std::string& name, std::size_t ops, F&& body)
+    {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+
+        double checksum = body();   // Warm-up (first touch of the outputs)
+        const double once = TimeNs([&] { checksum += body(); });
+        const std::size_t reps = std::max<std::size_t>(1, static_cast<std::size_t>(sampleNs / std::max(once, 1.0)));
+
+        double best = 1e300;
+        for (int s = 0; s < samples; ++s)
+        {
+            const double ns = TimeNs([&] { for (std::size_t r = 0; r < reps; ++r) checksum += body(); });
+            best = std::min(best, ns / static_cast<double>(reps * ops));
+        }
+        results.push_back({ name, best, checksum });
+        std::printf("  %-44s %10.2f ns/op %14.4e ops/s\n", name.c_str(), best, 1e9 / best);
+    }
+
+private:
+    template<typename F>
+    static double TimeNs(F&& f)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+};
+
+// Type names as used in the results: Matrix4x4 / Matrix4x4f, ...
+template<typename T>
+static std::string Name(const char* type, const char* op)
+{
+    return std::string(type) + (std::is_same_v<T, float> ? "f." : ".") + op;
+}
+
+// Cache resident random inputs, shared by the per-op cases
+template<typename T>
+struct Inputs
+{
+    static constexpr std::size_t K = 1024;
+
+    std::vector<TVec3<T>> v, u;
+    std::vector<TQuat<T>> q, p;
+    std::vector<TMatrix3x3<T>> R;
+    std::vector<TMatrix4x4<T>> M, N;
+    std::vector<TAffine3x4<T>> A, B;
+    std::vector<TDualQuat<T>> D, E;
+    std::vector<T> t, ang, cosine, norm2;
+
+    explicit Inputs(unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<double> gauss(0.0, 1.0);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::uniform_real_distribution<double> angle(-3.14159, 3.14159);
+        std::uniform_real_distribution<double> scl(0.5, 2.0);
+
+        auto vec = [&] { return Vec3{ gauss(rng), gauss(rng), gauss(rng) }; };
+        auto quat = [&] { return Quat{ gauss(rng), gauss(rng), gauss(rng), gauss(rng) }.Normalized(); };
+        auto trs = [&] { return Affine3x4::FromTRS(vec(), quat(), { scl(rng), scl(rng), scl(rng) }); };
+
+        for (std::size_t i = 0; i < K; ++i)
+        {
+            v.push_back(vec().template Cast<T>());
+            u.push_back(vec().template Cast<T>());
+            q.push_back(quat().template Cast<T>());
+            p.push_back(quat().template Cast<T>());
+            R.push_back(q.back().ToMatrix3x3Unchecked());
+            const Affine3x4 a = trs(), b = trs();
+            A.push_back(a.template Cast<T>());
+            B.push_back(b.template Cast<T>());
+            M.push_back(a.ToMatrix4x4().template Cast<T>());
+            N.push_back(b.ToMatrix4x4().template Cast<T>());
+            D.push_back(DualQuat::FromTR(vec(), quat()).template Cast<T>());
+            E.push_back(DualQuat::FromTR(vec(), quat()).template Cast<T>());
+            t.push_back(static_cast<T>(unit(rng)));
+            ang.push_back(static_cast<T>(angle(rng)));
+            cosine.push_back(static_cast<T>(2.0 * unit(rng) - 1.0));
+            norm2.push_back(static_cast<T>(0.25 + 4.0 * unit(rng)));
+        }
+    }
+};
+
+template<typename T>
+static void RunOps(Suite& suite)
+{
+    using V3 = TVec3<T>;
+    using M3 = TMatrix3x3<T>;
+    using M4 = TMatrix4x4<T>;
+    using Af = TAffine3x4<T>;
+    using Q = TQuat<T>;
+    using DQ = TDualQuat<T>;
+
+    const Inputs<T> in(1234);
+    const std::size_t K = Inputs<T>::K;
+    std::vector<V3> ov(K);
+    std::vector<Q> oq(K);
+    std::vector<M3> oR(K);
+    std::vector<M4> oM(K);
+    std::vector<V3> ot(K), os(K);
+    std::vector<T> x(K), y(K), z(K), ox(K), oy(K), oz(K), o1(K), o2(K);
+    for (std::size_t i = 0; i < K; ++i) { x[i] = in.v[i].x; y[i] = in.v[i].y; z[i] = in.v[i].z; }
+
+    // Vec3
+    suite.Run(Name<T>("Vec3", "Dot"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += V3::Dot(in.v[i], in.u[i]); return s; });
+    suite.Run(Name<T>("Vec3", "Cross"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += V3::Cross(in.v[i], in.u[i]).x; return s; });
+    suite.Run(Name<T>("Vec3", "Normalize"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.v[i].Normalize().x; return s; });
+
+    // Matrix3x3
+    suite.Run(Name<T>("Matrix3x3", "Multiply"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.R[i].Multiply(in.R[K - 1 - i]).m[1]; return s; });
+    suite.Run(Name<T>("Matrix3x3", "MultiplyVec3"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.R[i].Multiply(in.v[i]).x; return s; });
+    suite.Run(Name<T>("Matrix3x3", "Det"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.R[i].Det(); return s; });
+    suite.Run(Name<T>("Matrix3x3", "Transposed"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.R[i].Transposed().m[1]; return s; });
+    suite.Run(Name<T>("Matrix3x3", "Inverse"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.R[i].Inverse().m[1]; return s; });
+    suite.Run(Name<T>("Matrix3x3", "InverseBatch"), K, [&] { M3::InverseBatch(in.R, oR); return double(oR[K / 2].m[1]); });
+    suite.Run(Name<T>("Matrix3x3", "IsRotation"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.R[i].IsRotation(); return s; });
+    suite.Run(Name<T>("Matrix3x3", "Rotate"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.R[i].Rotate(in.v[i]).x; return s; });
+    suite.Run(Name<T>("Matrix3x3", "RotationAxisAngle"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += M3::RotationAxisAngle(in.v[i], in.ang[i]).m[1]; return s; });
+    suite.Run(Name<T>("Matrix3x3", "ToAxisAngle"), K, [&] {
+        double s = 0; V3 a; T phi; for (std::size_t i = 0; i < K; ++i) { in.R[i].ToAxisAngle(a, phi); s += phi; } return s; });
+    suite.Run(Name<T>("Matrix3x3", "FromEulerZYX"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += M3::FromEulerZYX(in.ang[i], in.ang[K - 1 - i], in.t[i]).m[1]; return s; });
+    suite.Run(Name<T>("Matrix3x3", "ToEulerZYX"), K, [&] {
+        double s = 0; T a, b, c; for (std::size_t i = 0; i < K; ++i) { in.R[i].ToEulerZYX(a, b, c); s += a + b + c; } return s; });
+    suite.Run(Name<T>("Matrix3x3", "RotateFromTo"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += M3::RotateFromTo(in.v[i], in.u[i]).m[1]; return s; });
+
+    // Matrix4x4
+    suite.Run(Name<T>("Matrix4x4", "Multiply"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.M[i].Multiply(in.N[i]).m[1]; return s; });
+    suite.Run(Name<T>("Matrix4x4", "MultiplyVec4"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.M[i].Multiply(TVec4<T>(in.v[i], T(1))).x; return s; });
+    suite.Run(Name<T>("Matrix4x4", "TransformPoint"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.M[i].TransformPoint(in.v[i]).x; return s; });
+    suite.Run(Name<T>("Matrix4x4", "TransformVector"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.M[i].TransformVector(in.v[i]).x; return s; });
+    suite.Run(Name<T>("Matrix4x4", "TransformPoints"), K, [&] { in.M[0].TransformPoints(in.v, ov); return double(ov[K / 2].x); });
+    suite.Run(Name<T>("Matrix4x4", "TransformPoints(SoA)"), K, [&] { in.M[0].TransformPoints(x, y, z, ox, oy, oz); return double(ox[K / 2]); });
+    suite.Run(Name<T>("Matrix4x4", "TransformPointsProjective"), K, [&] { in.M[0].TransformPointsProjective(in.v, ov); return double(ov[K / 2].x); });
+    suite.Run(Name<T>("Matrix4x4", "FromTRS(Matrix3x3)"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += M4::FromTRS(in.v[i], in.R[i], in.u[i]).m[1]; return s; });
+    suite.Run(Name<T>("Matrix4x4", "FromTRS(Quat)"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += M4::FromTRS(in.v[i], in.q[i], in.u[i]).m[1]; return s; });
+    suite.Run(Name<T>("Matrix4x4", "InverseTR"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += M4::Rotate(in.R[i]).InverseTR().m[1]; return s; });
+    suite.Run(Name<T>("Matrix4x4", "InverseTRS"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.M[i].InverseTRS().m[1]; return s; });
+    suite.Run(Name<T>("Matrix4x4", "Inverse"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.M[i].Inverse().m[1]; return s; });
+    suite.Run(Name<T>("Matrix4x4", "InverseBatch"), K, [&] { M4::InverseBatch(in.M, oM); return double(oM[K / 2].m[1]); });
+    suite.Run(Name<T>("Matrix4x4", "NormalMatrix"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.M[i].NormalMatrix().m[1]; return s; });
+    suite.Run(Name<T>("Matrix4x4", "IsAffine"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.M[i].IsAffine(); return s; });
+    suite.Run(Name<T>("Matrix4x4", "GetRotationQuat"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.M[i].GetRotationQuat().x; return s; });
+    suite.Run(Name<T>("Matrix4x4", "Decompose"), K, [&] {
+        double s = 0; V3 tt, ss; Q qq; for (std::size_t i = 0; i < K; ++i) { in.M[i].Decompose(tt, qq, ss); s += qq.x + ss.x; } return s; });
+    suite.Run(Name<T>("Matrix4x4", "DecomposeBatch"), K, [&] { M4::DecomposeBatch(in.M, ot, oq, os); return double(oq[K / 2].x); });
+
+    // Affine3x4
+    suite.Run(Name<T>("Affine3x4", "Multiply"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.A[i].Multiply(in.B[i]).m[1]; return s; });
+    suite.Run(Name<T>("Affine3x4", "TransformPoint"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.A[i].TransformPoint(in.v[i]).x; return s; });
+    suite.Run(Name<T>("Affine3x4", "FromTRS(Quat)"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += Af::FromTRS(in.v[i], in.q[i], in.u[i]).m[1]; return s; });
+    suite.Run(Name<T>("Affine3x4", "InverseTR"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += Af::Rotate(in.R[i]).InverseTR().m[1]; return s; });
+    suite.Run(Name<T>("Affine3x4", "InverseTRS"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.A[i].InverseTRS().m[1]; return s; });
+    suite.Run(Name<T>("Affine3x4", "Inverse"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.A[i].Inverse().m[1]; return s; });
+    suite.Run(Name<T>("Affine3x4", "Decompose"), K, [&] {
+        double s = 0; V3 tt, ss; Q qq; for (std::size_t i = 0; i < K; ++i) { in.A[i].Decompose(tt, qq, ss); s += qq.x + ss.x; } return s; });
+
+    // Quat
+    suite.Run(Name<T>("Quat", "Multiply"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.q[i].Multiply(in.p[i]).x; return s; });
+    suite.Run(Name<T>("Quat", "Normalized"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.q[i].Normalized().x; return s; });
+    suite.Run(Name<T>("Quat", "Rotate"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.q[i].Rotate(in.v[i]).x; return s; });
+    suite.Run(Name<T>("Quat", "FromMatrix3x3"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += Q::FromMatrix3x3(in.R[i]).x; return s; });
+    suite.Run(Name<T>("Quat", "FromMatrix3x3Unchecked"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += Q::FromMatrix3x3Unchecked(in.R[i]).x; return s; });
+    suite.Run(Name<T>("Quat", "ToMatrix3x3"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.q[i].ToMatrix3x3().m[1]; return s; });
+    suite.Run(Name<T>("Quat", "ToMatrix3x3Unchecked"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.q[i].ToMatrix3x3Unchecked().m[1]; return s; });
+    suite.Run(Name<T>("Quat", "FromAxisAngle"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += Q::FromAxisAngle(in.v[i], in.ang[i]).x; return s; });
+    suite.Run(Name<T>("Quat", "ToAxisAngle"), K, [&] {
+        double s = 0; V3 a; T phi; for (std::size_t i = 0; i < K; ++i) { in.q[i].ToAxisAngle(a, phi); s += phi; } return s; });
+    suite.Run(Name<T>("Quat", "FromEulerZYX"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += Q::FromEulerZYX(in.ang[i], in.ang[K - 1 - i], in.t[i]).x; return s; });
+    suite.Run(Name<T>("Quat", "ToEulerZYX"), K, [&] {
+        double s = 0; T a, b, c; for (std::size_t i = 0; i < K; ++i) { in.q[i].ToEulerZYX(a, b, c); s += a + b + c; } return s; });
+    suite.Run(Name<T>("Quat", "RotateFromTo"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += Q::RotateFromTo(in.v[i], in.u[i]).x; return s; });
+    suite.Run(Name<T>("Quat", "RotateToTarget"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += Q::RotateToTarget(in.q[i], in.p[i]).x; return s; });
+    suite.Run(Name<T>("Quat", "Slerp(Exact)"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += Q::Slerp(in.q[i], in.p[i], in.t[i]).x; return s; });
+    suite.Run(Name<T>("Quat", "Slerp(Fast)"), K, [&] {
+        double s = 0; for (std::size_t i = 0; i < K; ++i) s += Q::Slerp(in.q[i], in.p[i], in.t[i], SlerpMode::Fast).x; return s; });
+    suite.Run(Name<T>("Quat", "SlerpBatch(Exact)"), K, [&] { Q::SlerpBatch(in.q, in.p, in.t, oq); return double(oq[K / 2].x); });
+    suite.Run(Name<T>("Quat", "SlerpBatch(Fast)"), K, [&] { Q::SlerpBatch(in.q, in.p, in.t, oq, SlerpMode::Fast); return double(oq[K / 2].x); });
+    suite.Run(Name<T>("SlerpStepper", "Next"), K, [&] {
+        TSlerpStepper<T> st(in.q[0], in.p[0], static_cast<int>(K));
+        double s = 0; while (!st.Done()) s += st.Next().x; return s; });
+
+    // DualQuat
+    suite.Run(Name<T>("DualQuat", "FromTR"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += DQ::FromTR(in.v[i], in.q[i]).dual.x; return s; });
+    suite.Run(Name<T>("DualQuat", "Multiply"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.D[i].Multiply(in.E[i]).dual.x; return s; });
+    suite.Run(Name<T>("DualQuat", "TransformPoint"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.D[i].TransformPoint(in.v[i]).x; return s; });
+    suite.Run(Name<T>("DualQuat", "Normalized"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.D[i].Normalized().dual.x; return s; });
+    suite.Run(Name<T>("DualQuat", "ToAffine3x4"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += in.D[i].ToAffine3x4().m[3]; return s; });
+
+    // FastMath
+    suite.Run(Name<T>("FastMath", "SinCos"), K, [&] {
+        double s = 0; T sn, cs; for (std::size_t i = 0; i < K; ++i) { FastMath::SinCos(in.ang[i], sn, cs); s += sn + cs; } return s; });
+    suite.Run(Name<T>("FastMath", "SinCos(bulk)"), K, [&] { FastMath::SinCos(std::span<const T>(in.ang), std::span<T>(o1), std::span<T>(o2)); return double(o1[K / 2]); });
+    suite.Run(Name<T>("FastMath", "Acos"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += FastMath::Acos(in.cosine[i]); return s; });
+    suite.Run(Name<T>("FastMath", "Acos(bulk)"), K, [&] { FastMath::Acos(std::span<const T>(in.cosine), std::span<T>(o1)); return double(o1[K / 2]); });
+    suite.Run(Name<T>("FastMath", "Rsqrt"), K, [&] { double s = 0; for (std::size_t i = 0; i < K; ++i) s += FastMath::Rsqrt(in.norm2[i]); return s; });
+    suite.Run(Name<T>("FastMath", "Rsqrt(bulk)"), K, [&] { FastMath::Rsqrt(std::span<const T>(in.norm2), std::span<T>(o1)); return double(o1[K / 2]); });
+
+    // QuatBatch (SoA)
+    const TQuatBatch<T> qa = TQuatBatch<T>::Gather(in.q), qb = TQuatBatch<T>::Gather(in.p);
+    const TVec3Batch<T> vb = TVec3Batch<T>::Gather(in.v);
+    TQuatBatch<T> qo;
+    TVec3Batch<T> vo;
+    suite.Run(Name<T>("QuatBatch", "Multiply"), K, [&] { qa.Multiply(qb, qo); return double(qo.x[K / 2]); });
+    suite.Run(Name<T>("QuatBatch", "Rotate"), K, [&] { qa.Rotate(vb, vo); return double(vo.x[K / 2]); });
+    suite.Run(Name<T>("QuatBatch", "Normalize"), K, [&] { qb.Normalize(qo); return double(qo.x[K / 2]); });
+    suite.Run(Name<T>("QuatBatch", "ToMatrix3x3"), K, [&] { qa.ToMatrix3x3(oR); return double(oR[K / 2].m[1]); });
+}
+
+// Scene traversal on an N-node random hierarchy: every parent has a smaller index
+// (node 0 and ~1% of the others are roots) and the locals are Euler angles in degrees +
+// position + scale, as the app's Transform
+template<typename T>
+static void RunScene(Suite& suite, std::size_t n)
+{
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<double> pos(-10.0, 10.0);
+    std::uniform_real_distribution<double> deg(-180.0, 180.0);
+    std::uniform_real_distribution<double> scl(0.5, 2.0);
+
+    std::vector<int> parent(n);
+    std::vector<TVec3<T>> position(n), rotation(n), scale(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        parent[i] = (i == 0 || rng() % 100 == 0) ? -1 : static_cast<int>(rng() % i);
+        position[i] = Vec3{ pos(rng), pos(rng), pos(rng) }.Cast<T>();
+        rotation[i] = Vec3{ deg(rng), deg(rng), deg(rng) }.Cast<T>();
+        scale[i] = Vec3{ scl(rng), scl(rng), scl(rng) }.Cast<T>();
+    }
+
+    std::vector<TAffine3x4<T>> local(n), world(n);
+    std::vector<TMatrix4x4<T>> local4(n), world4(n);
+    auto localFromEuler = [&] {
+        const T rad = static_cast<T>(3.14159265358979323846 / 180.0);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const TMatrix3x3<T> R = TMatrix3x3<T>::FromEulerZYX(rotation[i].y * rad, rotation[i].x * rad, rotation[i].z * rad);
+            local[i] = TAffine3x4<T>::FromTRS(position[i], R, scale[i]);
+        }
+        return double(local[n / 2].m[3]);
+    };
+    localFromEuler();
+    for (std::size_t i = 0; i < n; ++i) local4[i] = local[i].ToMatrix4x4();
+
+    const std::string sz = "/" + std::to_string(n);
+    suite.Run(Name<T>("Scene", "LocalFromEuler") + sz, n, localFromEuler);
+
+    // As the pointer-tree GameObject did before caching: every node walks up to its root
+    suite.Run(Name<T>("Scene", "WorldRecursive") + sz, n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            TAffine3x4<T> W = local[i];
+            for (int p = parent[i]; p >= 0; p = parent[p]) W = local[p].Multiply(W);
+            world[i] = W;
+        }
+        return double(world[n / 2].m[3]);
+    });
+    // One pass in index order: parents are already done
+    suite.Run(Name<T>("Scene", "WorldOrdered(Affine3x4)") + sz, n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+            world[i] = (parent[i] < 0) ? local[i] : world[parent[i]].Multiply(local[i]);
+        return double(world[n / 2].m[3]);
+    });
+    suite.Run(Name<T>("Scene", "WorldOrdered(Matrix4x4)") + sz, n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+            world4[i] = (parent[i] < 0) ? local4[i] : world4[parent[i]].Multiply(local4[i]);
+        return double(world4[n / 2].m[3]);
+    });
+    suite.Run(Name<T>("Scene", "WorldInverseTRS") + sz, n, [&] {
+        double s = 0; for (std::size_t i = 0; i < n; ++i) s += world[i].InverseTRS().m[3]; return s; });
+    // The 8 corners of a unit cube per node, as a mesh bounds update
+    std::vector<TVec3<T>> corners(8), out(8);
+    for (int c = 0; c < 8; ++c) corners[c] = { T(c & 1 ? 1 : -1), T(c & 2 ? 1 : -1), T(c & 4 ? 1 : -1) };
+    suite.Run(Name<T>("Scene", "TransformCorners") + sz, n, [&] {
+        double s = 0;
+        for (std::size_t i = 0; i < n; ++i) { world4[i].TransformPoints(corners, out); s += out[7].x; }
+        return s;
+    });
+
+    // Scene store: pre-order SoA arrays with dirty flags (double only)
+    if constexpr (std::is_same_v<T, double>)
+    {
+        // Created depth first, so every CreateObject appends
+        std::vector<std::vector<std::size_t>> kids(n);
+        std::vector<std::size_t> stack;
+        for (std::size_t i = n; i-- > 0; )
+        {
+            if (parent[i] < 0) stack.push_back(i);
+            else kids[parent[i]].push_back(i);
+        }
+        Scene scene;
+        std::vector<GameObject*> handle(n, nullptr), roots;
+        while (!stack.empty())
+        {
+            const std::size_t i = stack.back();
+            stack.pop_back();
+            handle[i] = scene.CreateObject(parent[i] < 0 ? nullptr : handle[parent[i]]);
+            Transform tr;
+            tr.position = position[i];
+            tr.rotation = rotation[i];
+            tr.scale = scale[i];
+            handle[i]->SetTransform(tr);
+            if (parent[i] < 0) roots.push_back(handle[i]);
+            for (std::size_t k : kids[i]) stack.push_back(k);
+        }
+        auto worldAll = [&] {
+            scene.UpdateWorld();
+            double s = 0;
+            for (const Affine3x4& W : scene.World()) s += W.m[3];
+            return s;
+        };
+        // Nothing changed since the last frame
+        suite.Run("Scene.GameObjectWorld(clean)" + sz, n, worldAll);
+        // Every root edited: all world matrices are recomputed (locals only for the roots)
+        suite.Run("Scene.GameObjectWorld(roots edited)" + sz, n, [&] {
+            for (GameObject* r : roots) r->SetRotation(r->GetTransform().rotation);
+            return worldAll();
+        });
+        // One node edited, as the inspector does
+        GameObject* edited = handle[n / 2];
+        suite.Run("Scene.GameObjectWorld(one edit)" + sz, n, [&] {
+            edited->SetPosition(edited->GetTransform().position);
+            return worldAll();
+        });
+        // A 64-node subtree added as the last root and destroyed: pool slots are reused
+        suite.Run("Scene.CreateDestroySubtree(64)" + sz, 64, [&] {
+            GameObject* top = scene.CreateObject();
+            GameObject* p = top;
+            for (int k = 1; k < 64; ++k) p = scene.CreateObject((k % 8 == 0) ? top : p);
+            scene.Destroy(top);
+            return static_cast<double>(scene.Size());
+        });
+        const Scene::MemoryStats mem = scene.GetMemoryStats();
+        std::printf("  %-44s %zu B/node, %zu KiB reserved, %zu pool + %zu array allocations\n",
+            ("Scene memory" + sz).c_str(), mem.bytesPerNode, mem.reservedBytes / 1024,
+            mem.poolAllocations, mem.arrayAllocations);
+    }
+}
+
+// JSON
+
+static std::string Escape(const std::string& s)
+{
+    std::string r;
+    for (char c : s) { if (c == '"' || c == '\\') r += '\\'; r += c; }
+    return r;
+}
+
+static bool WriteJson(const std::string& path, const std::vector<Result>& results, bool quick)
+{
+    std::ofstream f(path);
+    if (!f) return false;
+    char buf[256];
+    f << "{\n";
+    f << "  \"suite\": \"mathcore\",\n";
+    f << "  \"simd\": \"" << Simd::Name(Simd::Active()) << "\",\n";
+    f << "  \"inline_core\": " << MATH_INLINE_CORE << ",\n";
+    f << "  \"quick\": " << (quick ? "true" : "false") << ",\n";
+    f << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        std::snprintf(buf, sizeof(buf), "\"ns_per_op\": %.4f, \"ops_per_sec\": %.6e, \"checksum\": %.6e",
+            r.nsPerOp, 1e9 / r.nsPerOp, r.checksum);
+        f << "    { \"name\": \"" << Escape(r.name) << "\", " << buf << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    f << "  ]\n}\n";
+    return static_cast<bool>(f);
+}
+
+// Reads the name -> ns_per_op pairs of a file written by WriteJson
+static bool ReadBaseline(const std::string& path, std::map<std::string, double>& out)
+{
+    std::ifstream f(path);
+    if (!f) return false;
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const std::string s = ss.str();
+
+    std::size_t pos = 0;
+    while ((pos = s.find("\"name\"", pos)) != std::string::npos)
+    {
+        const std::size_t b = s.find('"', s.find(':', pos));
+        std::string name;
+        std::size_t e = b + 1;
+        for (; e < s.size() && s[e] != '"'; ++e)
+        {
+            if (s[e] == '\\' && e + 1 < s.size()) ++e;
+            name += s[e];
+        }
+        const std::size_t k = s.find("\"ns_per_op\"", e);
+        if (k == std::string::npos) break;
+        out[name] = std::strtod(s.c_str() + s.find(':', k) + 1, nullptr);
+        pos = e;
+    }
+    return true;
+}
+
+// Prints the cases that moved by more than tol and a summary. Returns the regressions.
+static int Compare(const std::vector<Result>& results, const std::map<std::string, double>& base, double tol)
+{
+    int faster = 0, slower = 0, missing = 0;
+    double logSum = 0.0;
+    int matched = 0;
+    std::printf("\nComparison with baseline (tolerance %.0f%%): baseline ns/op -> current ns/op\n", tol * 100.0);
+    for (const Result& r : results)
+    {
+        auto it = base.find(r.name);
+        if (it == base.end() || it->second <= 0.0) { ++missing; continue; }
+        const double ratio = r.nsPerOp / it->second;
+        logSum += std::log(ratio);
+        ++matched;
+        if (ratio > 1.0 + tol) ++slower;
+        else if (ratio < 1.0 - tol) ++faster;
+        else continue;
+        std::printf("  %-44s %10.2f -> %10.2f  %6.2fx %s\n", r.name.c_str(), it->second, r.nsPerOp,
+            it->second / r.nsPerOp, ratio > 1.0 ? "SLOWER" : "faster");
+    }
+    if (matched > 0)
+        std::printf("%d cases compared: %d faster, %d slower, %d unchanged; geometric mean speedup %.3fx\n",
+            matched, faster, slower, matched - faster - slower, std::exp(-logSum / matched));
+    if (missing > 0) std::printf("%d cases not in the baseline\n", missing);
+    return slower;
+}
+
+static std::vector<std::size_t> ParseList(const char* s)
+{
+    std::vector<std::size_t> v;
+    for (const char* p = s; *p; )
+    {
+        char* end;
+        const unsigned long n = std::strtoul(p, &end, 10);
+        if (end == p) break;
+        if (n > 0) v.push_back(n);
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return v;
+}
+
+int main(int argc, char** argv)
+{
+    Suite suite;
+    bool quick = false, failOnRegression = false;
+    std::vector<std::size_t> nodes;
+    std::string jsonPath, baselinePath;
+    double tol = 0.10;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (a == "--quick") quick = true;
+        else if (a == "--fail-on-regression") failOnRegression = true;
+        else if (a == "--filter" && hasValue) suite.filter = argv[++i];
+        else if (a == "--nodes" && hasValue) nodes = ParseList(argv[++i]);
+        else if (a == "--json" && hasValue) jsonPath = argv[++i];
+        else if (a == "--baseline" && hasValue) baselinePath = argv[++i];
+        else if (a == "--tolerance" && hasValue) tol = std::strtod(argv[++i], nullptr);
+        else if (a == "--simd" && hasValue)
+        {
+            const std::string want = argv[++i];
+            bool found = false;
+            for (int l = 0; l <= static_cast<int>(Simd::Level::AVX512); ++l)
+            {
+                std::string name = Simd::Name(static_cast<Simd::Level>(l));
+                name.erase(std::remove(name.begin(), name.end(), '-'), name.end());
+                std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                if (name == want) { Simd::SetActive(static_cast<Simd::Level>(l)); found = true; }
+            }
+            if (!found) { std::fprintf(stderr, "unknown SIMD level: %s\n", want.c_str()); return 2; }
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown or incomplete option: %s (see the header of bench/bench_suite.cpp)\n", a.c_str());
+            return 2;
+        }
+    }
+    if (quick) { suite.sampleNs = 2e5; suite.samples = 3; }
+    if (nodes.empty()) nodes = quick ? std::vector<std::size_t>{ 1024 } : std::vector<std::size_t>{ 1024, 65536 };
+
+    std::printf("mathcore bench suite: SIMD %s (best %s), MATH_INLINE_CORE=%d%s\n", Simd::Name(Simd::Active()),
+        Simd::Name(Simd::Detect()), MATH_INLINE_CORE, quick ? ", quick" : "");
+    RunOps<double>(suite);
+    RunOps<float>(suite);
+    for (std::size_t n : nodes)
+    {
+        RunScene<double>(suite, n);
+        RunScene<float>(suite, n);
+    }
+
+    if (!jsonPath.empty())
+    {
+        if (!WriteJson(jsonPath, suite.results, quick)) { std::fprintf(stderr, "cannot write %s\n", jsonPath.c_str()); return 2; }
+        std::printf("\nwrote %zu results to %s\n", suite.results.size(), jsonPath.c_str());
+    }
+    if (!baselinePath.empty())
+    {
+        std::map<std::string, double> base;
+        if (!ReadBaseline(baselinePath, base)) { std::fprintf(stderr, "cannot read %s\n", baselinePath.c_str()); return 2; }
+        const int slower = Compare(suite.results, base, tol);
+        if (failOnRegression && slower > 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Matrix4x4.hpp"
+
+// Affine transform stored as the top 3 rows of a 4x4 matrix; the bottom row is
+// implicitly (0, 0, 0, 1). Affine by construction, so nothing here validates
+// the input or throws: compose costs 36 multiplies instead of 64 and the
+// inverses are closed form.
+template<typename T>
+struct TAffine3x4
+{
+    // Row-major: m[row * 4 + col]. Column 3 is the translation.
+    T m[12] = { 0 };
+
+    constexpr T& At(std::size_t i, std::size_t j) { return m[i * 4 + j]; }
+    constexpr T  At(std::size_t i, std::size_t j) const { return m[i * 4 + j]; }
+
+    static MATH_CONSTEXPR TAffine3x4 Identity();
+    static MATH_CONSTEXPR TAffine3x4 Translate(const TVec3<T>& t);
+    static MATH_CONSTEXPR TAffine3x4 Scale(const TVec3<T>& s);
+    static MATH_CONSTEXPR TAffine3x4 Rotate(const TMatrix3x3<T>& R);
+    static TAffine3x4 Rotate(const TQuat<T>& q);
+    static MATH_CONSTEXPR TAffine3x4 FromTRS(const TVec3<T>& t, const TMatrix3x3<T>& R, const TVec3<T>& s);
+    static TAffine3x4 FromTRS(const TVec3<T>& t, const TQuat<T>& q, const TVec3<T>& s);
+
+    // this * B
+    MATH_CONSTEXPR TAffine3x4 Multiply(const TAffine3x4& B) const;
+    MATH_CONSTEXPR TAffine3x4 operator*(const TAffine3x4& B) const
+    {
+        return Multiply(B);
+    }
+
+    MATH_CONSTEXPR TVec3<T> TransformPoint(const TVec3<T>& p) const;
+    MATH_CONSTEXPR TVec3<T> TransformVector(const TVec3<T>& v) const;
+
+    // Inverses
+    // InverseTR: the 3x3 part must be a rotation (transpose).
+    // InverseTRS: rotation times scale (orthogonal columns). Zero scale axes map to 0.
+    // Inverse: any invertible 3x3 part (adjugate / determinant). Not finite when Det() == 0.
+    MATH_CONSTEXPR TAffine3x4 InverseTR() const;
+    MATH_CONSTEXPR TAffine3x4 InverseTRS() const;
+    MATH_CONSTEXPR TAffine3x4 Inverse() const;
+    MATH_CONSTEXPR T Det() const;
+
+    // Getters de components
+    MATH_CONSTEXPR TVec3<T> GetTranslation() const;
+    MATH_CONSTEXPR TMatrix3x3<T> GetRotationScale() const;
+    TVec3<T> GetScale() const;
+    TMatrix3x3<T> GetRotation() const;
+    TQuat<T> GetRotationQuat() const;
+
+    // Decomposicio TRS en una sola passada
+    // t, q and s (and optionally the shear) from one pass over the columns, with no
+    // IsRotation / IsAffine checks. Returns false when a scale axis is 0 (q is then
+    // the identity). The shear is only written in DecomposeMode::Shear.
+    bool Decompose(TVec3<T>& t, TQuat<T>& q, TVec3<T>& s,
+        DecomposeMode mode = DecomposeMode::Fast, TVec3<T>* shear = nullptr) const;
+    // Whole arrays at once; all spans must have the same size. Returns how many failed.
+    static std::size_t DecomposeBatch(std::span<const TAffine3x4> m, std::span<TVec3<T>> t,
+        std::span<TQuat<T>> q, std::span<TVec3<T>> s, DecomposeMode mode = DecomposeMode::Fast);
+
+    // Setters de components
+    MATH_CONSTEXPR void SetTranslation(const TVec3<T>& t);
+    MATH_CONSTEXPR void SetRotationScale(const TMatrix3x3<T>& RS);
+
+    // Conversions. FromMatrix4x4 drops the bottom row without checking it.
+    template<MatrixLayout L = MatrixLayout::RowMajor>
+    constexpr TMatrix4x4<T, L> ToMatrix4x4() const
+    {
+        TMatrix4x4<T, L> M;
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 4; ++j)
+                M.At(i, j) = At(i, j);
+        M.At(3, 3) = T(1);
+        return M;
+    }
+
+    template<MatrixLayout L>
+    static constexpr TAffine3x4 FromMatrix4x4(const TMatrix4x4<T, L>& M)
+    {
+        TAffine3x4 A;
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 4; ++j)
+                A.At(i, j) = M.At(i, j);
+        return A;
+    }
+
+    template<typename U>
+    constexpr TAffine3x4<U> Cast() const
+    {
+        TAffine3x4<U> R;
+        for (std::size_t i = 0; i < 12; ++i) R.m[i] = static_cast<U>(m[i]);
+        return R;
+    }
+};
+
+using Affine3x4 = TAffine3x4<double>;
+using Affine3x4f = TAffine3x4<float>;
+
+#if MATH_INLINE_CORE
+#include "Affine3x4.inl"
+#endif
@@ -0,0 +1,194 @@
+#pragma once
+// Inline part of Affine3x4.hpp (see MathConfig.hpp). Included by the header when
+// MATH_INLINE_CORE is 1, and by src/Affine3x4.cpp otherwise.
+#include "Simd.hpp"
+
+template<typename T>
+MATH_CONSTEXPR TAffine3x4<T> TAffine3x4<T>::Identity()
+{
+    TAffine3x4 A;
+    A.At(0, 0) = 1; A.At(1, 1) = 1; A.At(2, 2) = 1;
+    return A;
+}
+
+template<typename T>
+MATH_CONSTEXPR TAffine3x4<T> TAffine3x4<T>::Translate(const TVec3<T>& t)
+{
+    TAffine3x4 A = Identity();
+    A.SetTranslation(t);
+    return A;
+}
+
+template<typename T>
+MATH_CONSTEXPR TAffine3x4<T> TAffine3x4<T>::Scale(const TVec3<T>& s)
+{
+    TAffine3x4 A;
+    A.At(0, 0) = s.x; A.At(1, 1) = s.y; A.At(2, 2) = s.z;
+    return A;
+}
+
+template<typename T>
+MATH_CONSTEXPR TAffine3x4<T> TAffine3x4<T>::Rotate(const TMatrix3x3<T>& R)
+{
+    TAffine3x4 A;
+    A.SetRotationScale(R);
+    return A;
+}
+
+template<typename T>
+MATH_CONSTEXPR TAffine3x4<T> TAffine3x4<T>::FromTRS(const TVec3<T>& t, const TMatrix3x3<T>& R, const TVec3<T>& s)
+{
+    TAffine3x4 A;
+    const T scales[3] = { s.x, s.y, s.z };
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            A.At(i, j) = R.At(i, j) * scales[j];
+        }
+    }
+    A.SetTranslation(t);
+    return A;
+}
+
+template<typename T>
+MATH_CONSTEXPR TAffine3x4<T> TAffine3x4<T>::Multiply(const TAffine3x4& B) const
+{
+    // [A t] * [B u] = [A*B  A*u + t]: 27 + 9 multiplies
+    TAffine3x4 C;
+    if constexpr (std::is_same_v<T, double>) {
+        if (!MATH_IS_CONSTANT_EVALUATED()) {
+            // SIMD kernel picked at runtime (see Simd.hpp)
+            Simd::Affine3x4Mul(m, B.m, C.m);
+            return C;
+        }
+    }
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        const T a0 = At(i, 0), a1 = At(i, 1), a2 = At(i, 2);
+        for (std::size_t j = 0; j < 4; ++j) {
+            C.At(i, j) = a0 * B.At(0, j) + a1 * B.At(1, j) + a2 * B.At(2, j);
+        }
+        C.At(i, 3) += At(i, 3);
+    }
+    return C;
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TAffine3x4<T>::TransformPoint(const TVec3<T>& p) const
+{
+    return {
+        At(0, 0) * p.x + At(0, 1) * p.y + At(0, 2) * p.z + At(0, 3),
+        At(1, 0) * p.x + At(1, 1) * p.y + At(1, 2) * p.z + At(1, 3),
+        At(2, 0) * p.x + At(2, 1) * p.y + At(2, 2) * p.z + At(2, 3)
+    };
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TAffine3x4<T>::TransformVector(const TVec3<T>& v) const
+{
+    return {
+        At(0, 0) * v.x + At(0, 1) * v.y + At(0, 2) * v.z,
+        At(1, 0) * v.x + At(1, 1) * v.y + At(1, 2) * v.z,
+        At(2, 0) * v.x + At(2, 1) * v.y + At(2, 2) * v.z
+    };
+}
+
+template<typename T>
+MATH_CONSTEXPR TAffine3x4<T> TAffine3x4<T>::InverseTR() const
+{
+    // [R t]^-1 = [R^T  -R^T t]
+    TAffine3x4 I;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            I.At(i, j) = At(j, i);
+        }
+    }
+    const TVec3<T> t = I.TransformVector(GetTranslation());
+    I.SetTranslation({ -t.x, -t.y, -t.z });
+    return I;
+}
+
+template<typename T>
+MATH_CONSTEXPR TAffine3x4<T> TAffine3x4<T>::InverseTRS() const
+{
+    // (R S)^-1 = S^-1 R^T: row j of the inverse is column j divided by its squared length
+    TAffine3x4 I;
+    for (std::size_t j = 0; j < 3; ++j) {
+        const T n2 = At(0, j) * At(0, j) + At(1, j) * At(1, j) + At(2, j) * At(2, j);
+        const T inv = (n2 > T(0)) ? T(1) / n2 : T(0);
+        for (std::size_t i = 0; i < 3; ++i) {
+            I.At(j, i) = At(i, j) * inv;
+        }
+    }
+    const TVec3<T> t = I.TransformVector(GetTranslation());
+    I.SetTranslation({ -t.x, -t.y, -t.z });
+    return I;
+}
+
+template<typename T>
+MATH_CONSTEXPR T TAffine3x4<T>::Det() const
+{
+    return At(0, 0) * (At(1, 1) * At(2, 2) - At(1, 2) * At(2, 1))
+        - At(0, 1) * (At(1, 0) * At(2, 2) - At(1, 2) * At(2, 0))
+        + At(0, 2) * (At(1, 0) * At(2, 1) - At(1, 1) * At(2, 0));
+}
+
+template<typename T>
+MATH_CONSTEXPR TAffine3x4<T> TAffine3x4<T>::Inverse() const
+{
+    // A^-1 = adj(A) / det(A), with the cofactors computed once
+    const T c00 = At(1, 1) * At(2, 2) - At(1, 2) * At(2, 1);
+    const T c01 = At(1, 2) * At(2, 0) - At(1, 0) * At(2, 2);
+    const T c02 = At(1, 0) * At(2, 1) - At(1, 1) * At(2, 0);
+    const T invDet = T(1) / (At(0, 0) * c00 + At(0, 1) * c01 + At(0, 2) * c02);
+
+    TAffine3x4 I;
+    I.At(0, 0) = c00 * invDet;
+    I.At(1, 0) = c01 * invDet;
+    I.At(2, 0) = c02 * invDet;
+    I.At(0, 1) = (At(0, 2) * At(2, 1) - At(0, 1) * At(2, 2)) * invDet;
+    I.At(1, 1) = (At(0, 0) * At(2, 2) - At(0, 2) * At(2, 0)) * invDet;
+    I.At(2, 1) = (At(0, 1) * At(2, 0) - At(0, 0) * At(2, 1)) * invDet;
+    I.At(0, 2) = (At(0, 1) * At(1, 2) - At(0, 2) * At(1, 1)) * invDet;
+    I.At(1, 2) = (At(0, 2) * At(1, 0) - At(0, 0) * At(1, 2)) * invDet;
+    I.At(2, 2) = (At(0, 0) * At(1, 1) - At(0, 1) * At(1, 0)) * invDet;
+
+    const TVec3<T> t = I.TransformVector(GetTranslation());
+    I.SetTranslation({ -t.x, -t.y, -t.z });
+    return I;
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TAffine3x4<T>::GetTranslation() const
+{
+    return { At(0, 3), At(1, 3), At(2, 3) };
+}
+
+template<typename T>
+MATH_CONSTEXPR TMatrix3x3<T> TAffine3x4<T>::GetRotationScale() const
+{
+    TMatrix3x3<T> M;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            M.At(i, j) = At(i, j);
+        }
+    }
+    return M;
+}
+
+template<typename T>
+MATH_CONSTEXPR void TAffine3x4<T>::SetTranslation(const TVec3<T>& t)
+{
+    At(0, 3) = t.x;
+    At(1, 3) = t.y;
+    At(2, 3) = t.z;
+}
+
+template<typename T>
+MATH_CONSTEXPR void TAffine3x4<T>::SetRotationScale(const TMatrix3x3<T>& RS)
+{
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            At(i, j) = RS.At(i, j);
+        }
+    }
+}
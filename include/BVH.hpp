@@ -0,0 +1,131 @@
+#pragma once
+#include "Bounds.hpp"
+#include "Scene.hpp"
+#include <functional>
+#include <span>
+#include <vector>
+
+// Dynamic bounding volume hierarchy over the world AABBs of the nodes of a Scene. The
+// leaves are the nodes that have a mesh with bounds (meshBounds[GameObject::GetMesh()],
+// in mesh space); the inner nodes hold the union of their two children.
+//
+// Build makes a new tree top down with a binned SAH split. Refit brings the tree up to
+// date after Scene::UpdateWorld: it only recomputes the boxes of the nodes whose world
+// matrix was written since the last call (Scene::WorldVersions) and the ancestors of
+// those leaves. When the layout of the scene changed (Scene::GetLayoutVersion) it also
+// matches the nodes with the leaves by GameObjectHandle, an O(N) pass, to insert the new
+// nodes and remove the destroyed ones; reparented or reordered nodes keep their leaf.
+// Insertions and removals keep the tree balanced with AVL rotations (as Box2D's dynamic
+// tree). When more than half of the leaves come or go at once Refit rebuilds instead.
+//
+// The queries append the handles of the nodes whose world AABB passes the test; they
+// test boxes only (a sphere query returns nodes whose box touches the sphere).
+class BVH {
+public:
+    struct RayHit {
+        GameObjectHandle object;
+        double t = 0.0;         // Where the ray enters the box of object (or the filter's t)
+    };
+
+    struct Stats {
+        std::size_t leaves;
+        std::size_t nodes;      // Leaves + inner nodes
+        // Last Build / Refit
+        std::size_t updated;    // Leaves whose box was recomputed
+        std::size_t inserted;
+        std::size_t removed;
+        bool rebuilt;
+    };
+
+    // Walks the whole tree
+    struct Quality {
+        std::size_t height;     // Longest root-to-leaf path, in nodes
+        double sahCost;         // Sum of inner surface areas / root surface area
+    };
+
+    // World AABB of every node of scene: the box of its mesh transformed by its world
+    // matrix, or an empty box when the mesh is out of meshBounds. out.size() must be
+    // scene.Size().
+    static void ComputeWorldBounds(const Scene& scene, std::span<const AABB> meshBounds, std::span<AABB> out);
+
+    void Build(const Scene& scene, std::span<const AABB> meshBounds);
+    // Call after Scene::UpdateWorld. Builds when the tree was built for another scene;
+    // call Build when meshBounds itself changes.
+    void Refit(const Scene& scene, std::span<const AABB> meshBounds);
+    void Clear();
+
+    void QueryFrustum(const Frustum& frustum, std::vector<GameObjectHandle>& out) const;
+    void QueryAABB(const AABB& box, std::vector<GameObjectHandle>& out) const;
+    void QuerySphere(const Sphere& sphere, std::vector<GameObjectHandle>& out) const;
+    // Exact test of a leaf hit by a ray: tNear is where the ray enters the box of object
+    // and t, on entry, the farthest hit still worth reporting. Returns true and sets t
+    // when object is hit before that.
+    using RayFilter = std::function<bool(GameObjectHandle object, double tNear, double& t)>;
+
+    // Nearest box entered by the ray within [0, tMax]. False when there is none.
+    bool Raycast(const Ray& ray, double tMax, RayHit& hit) const;
+    // Nearest leaf accepted by filter. Boxes entered after the best hit so far are
+    // skipped, so filter only runs on the few leaves near the ray's first hits.
+    bool Raycast(const Ray& ray, double tMax, RayHit& hit, const RayFilter& filter) const;
+
+    // Union of all leaves (empty when there are none)
+    AABB Bounds() const;
+    std::size_t LeafCount() const { return leafCount; }
+    Stats GetStats() const;
+    Quality GetQuality() const;
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        AABB box;
+        uint32_t parent = NONE;             // Next free node while in the free list
+        uint32_t left = NONE, right = NONE; // NONE for leaves
+        uint32_t height = 0;                // 0 for leaves
+        GameObjectHandle object;            // Leaves
+
+        bool IsLeaf() const { return left == NONE; }
+    };
+
+    // Per pool slot of the scene, so that Refit matches the nodes with their leaves
+    // without touching the tree
+    struct SlotLeaf {
+        uint32_t leaf = NONE;
+        uint32_t generation = 0;
+        uint32_t mesh = 0;
+        uint32_t seen = 0;                  // Refit pass that last found the node
+    };
+
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t n);
+    uint32_t AddLeaf(const AABB& box, GameObjectHandle object, uint32_t mesh);
+    void InsertLeaf(uint32_t leaf);
+    void RemoveLeaf(uint32_t leaf);
+    // Rotates the taller grandchild of n up when the heights of its children differ by
+    // more than one; returns the node now in the place of n
+    uint32_t Balance(uint32_t n);
+    // Rebalances and recomputes the ancestors of n (after an insertion or a removal)
+    void FixAncestors(uint32_t n);
+    // Recomputes the boxes of the ancestors of n, up to the first that does not change
+    void RefitAncestors(uint32_t n);
+    // Recomputes every inner box, children first
+    void RefitAll();
+    // Ancestors of the leaves whose box changed
+    void RefitChanged(const std::vector<uint32_t>& changed);
+    void CollectLeaves(uint32_t n, std::vector<GameObjectHandle>& out) const;
+
+    std::vector<Node> nodes;
+    std::vector<SlotLeaf> slots;            // By GameObjectHandle::slot
+    std::vector<uint32_t> leafOfIndex;      // Scene index -> leaf, or NONE (for syncedLayout)
+    uint32_t root = NONE;
+    uint32_t freeNode = NONE;
+    std::size_t leafCount = 0;
+    bool preOrder = false;                  // Parents before children in nodes (after Build)
+
+    const Scene* scene = nullptr;
+    uint32_t syncedVersion = 0;             // Scene::GetWorldVersion() of the last Build / Refit
+    uint32_t syncedLayout = 0;              // Scene::GetLayoutVersion() of the last Build / Refit
+    uint32_t pass = 0;
+    std::size_t lastUpdated = 0, lastInserted = 0, lastRemoved = 0;
+    bool lastRebuilt = false;
+};
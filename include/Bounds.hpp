@@ -0,0 +1,133 @@
+#pragma once
+#include "Affine3x4.hpp"
+#include <limits>
+
+// Bounding volumes and the shapes used to query them: axis-aligned box, sphere, ray,
+// plane and view frustum. The hot tests are in Bounds.inl (see MathConfig.hpp).
+
+// Axis-aligned box [min, max]. The default box is empty (min = +inf, max = -inf), so
+// merging anything into it gives that thing.
+template<typename T>
+struct TAABB
+{
+    static constexpr T INF = std::numeric_limits<T>::infinity();
+    TVec3<T> min{ INF, INF, INF };
+    TVec3<T> max{ -INF, -INF, -INF };
+
+    static MATH_CONSTEXPR TAABB FromCenterExtents(const TVec3<T>& center, const TVec3<T>& extents);
+
+    MATH_CONSTEXPR bool IsEmpty() const;
+    MATH_CONSTEXPR TVec3<T> Center() const;
+    // Half the size on each axis
+    MATH_CONSTEXPR TVec3<T> Extents() const;
+    // 0 for an empty box. Cost metric of the BVH (SAH).
+    MATH_CONSTEXPR T SurfaceArea() const;
+
+    MATH_CONSTEXPR TAABB Merge(const TAABB& b) const;
+    MATH_CONSTEXPR TAABB Merge(const TVec3<T>& p) const;
+    MATH_CONSTEXPR bool Contains(const TAABB& b) const;
+    MATH_CONSTEXPR bool Overlaps(const TAABB& b) const;
+    // Squared distance from p to the box, 0 inside
+    MATH_CONSTEXPR T DistanceSquared(const TVec3<T>& p) const;
+
+    // Box of the 8 transformed corners, without transforming them: the new center is
+    // M * center and the new extents are |M3x3| * extents (Arvo). Exact for any affine M.
+    MATH_CONSTEXPR TAABB Transformed(const TAffine3x4<T>& M) const;
+
+    template<typename U>
+    constexpr TAABB<U> Cast() const
+    {
+        return { min.template Cast<U>(), max.template Cast<U>() };
+    }
+};
+
+template<typename T>
+struct TSphere
+{
+    TVec3<T> center;
+    T radius = 0;
+
+    MATH_CONSTEXPR bool Overlaps(const TAABB<T>& b) const;
+};
+
+// Half line origin + t * direction, t >= 0. Distances are in units of direction, which
+// need not be unit length. Build it with FromOriginDirection, which caches 1 / direction
+// for the slab test.
+template<typename T>
+struct TRay
+{
+    TVec3<T> origin;
+    TVec3<T> direction;
+    TVec3<T> invDirection;
+
+    static MATH_CONSTEXPR TRay FromOriginDirection(const TVec3<T>& origin, const TVec3<T>& direction);
+    MATH_CONSTEXPR TVec3<T> At(T t) const;
+    // True when the ray enters b at some t in [0, tMax]; tNear is that entry (0 when the
+    // origin is inside)
+    MATH_CONSTEXPR bool Intersects(const TAABB<T>& b, T tMax, T& tNear) const;
+};
+
+// Points p with Dot(normal, p) + d >= 0 are on the inner side
+template<typename T>
+struct TPlane
+{
+    TVec3<T> normal;
+    T d = 0;
+
+    MATH_CONSTEXPR T Distance(const TVec3<T>& p) const;
+};
+
+enum class Containment { Outside, Intersects, Inside };
+
+template<typename T>
+struct TFrustum
+{
+    // Left, right, bottom, top, near, far; normals point inwards and are unit length
+    TPlane<T> planes[6];
+
+    static constexpr unsigned ALL_PLANES = 0x3F;
+
+    // Planes of the clip volume -w <= x, y, z <= w (OpenGL) of VP = projection * view,
+    // in world space (Gribb / Hartmann)
+    template<MatrixLayout L>
+    static TFrustum FromViewProjection(const TMatrix4x4<T, L>& VP)
+    {
+        TFrustum f;
+        for (int k = 0; k < 6; ++k)
+        {
+            const std::size_t row = static_cast<std::size_t>(k / 2);
+            const T sign = (k % 2 == 0) ? T(1) : T(-1);
+            TPlane<T>& p = f.planes[k];
+            p.normal = { VP.At(3, 0) + sign * VP.At(row, 0), VP.At(3, 1) + sign * VP.At(row, 1), VP.At(3, 2) + sign * VP.At(row, 2) };
+            p.d = VP.At(3, 3) + sign * VP.At(row, 3);
+            const T n = p.normal.Norm();
+            if (n > 0) { p.normal = { p.normal.x / n, p.normal.y / n, p.normal.z / n }; p.d /= n; }
+        }
+        return f;
+    }
+
+    // planeMask selects the planes to test (a box known to be inside a plane skips it);
+    // the planes that b is completely inside of are cleared from it
+    MATH_CONSTEXPR Containment Classify(const TAABB<T>& b, unsigned& planeMask) const;
+    MATH_CONSTEXPR Containment Classify(const TAABB<T>& b) const
+    {
+        unsigned mask = ALL_PLANES;
+        return Classify(b, mask);
+    }
+    MATH_CONSTEXPR bool Overlaps(const TSphere<T>& s) const;
+};
+
+using AABB = TAABB<double>;
+using AABBf = TAABB<float>;
+using Sphere = TSphere<double>;
+using Spheref = TSphere<float>;
+using Ray = TRay<double>;
+using Rayf = TRay<float>;
+using Plane = TPlane<double>;
+using Planef = TPlane<float>;
+using Frustum = TFrustum<double>;
+using Frustumf = TFrustum<float>;
+
+#if MATH_INLINE_CORE
+#include "Bounds.inl"
+#endif
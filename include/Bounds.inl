@@ -0,0 +1,188 @@
+#pragma once
+// Inline part of Bounds.hpp (see MathConfig.hpp). Included by the header when
+// MATH_INLINE_CORE is 1, and by src/Bounds.cpp otherwise.
+
+namespace BoundsDetail {
+template<typename T>
+constexpr T Abs(T x) { return (x < 0) ? -x : x; }
+template<typename T>
+constexpr T Min(T a, T b) { return (b < a) ? b : a; }
+template<typename T>
+constexpr T Max(T a, T b) { return (a < b) ? b : a; }
+}
+
+// AABB
+
+template<typename T>
+MATH_CONSTEXPR TAABB<T> TAABB<T>::FromCenterExtents(const TVec3<T>& c, const TVec3<T>& e)
+{
+    return { { c.x - e.x, c.y - e.y, c.z - e.z }, { c.x + e.x, c.y + e.y, c.z + e.z } };
+}
+
+template<typename T>
+MATH_CONSTEXPR bool TAABB<T>::IsEmpty() const
+{
+    return !(min.x <= max.x && min.y <= max.y && min.z <= max.z);
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TAABB<T>::Center() const
+{
+    return { T(0.5) * (min.x + max.x), T(0.5) * (min.y + max.y), T(0.5) * (min.z + max.z) };
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TAABB<T>::Extents() const
+{
+    return { T(0.5) * (max.x - min.x), T(0.5) * (max.y - min.y), T(0.5) * (max.z - min.z) };
+}
+
+template<typename T>
+MATH_CONSTEXPR T TAABB<T>::SurfaceArea() const
+{
+    if (IsEmpty()) return 0;
+    const T x = max.x - min.x, y = max.y - min.y, z = max.z - min.z;
+    return 2 * (x * y + y * z + z * x);
+}
+
+template<typename T>
+MATH_CONSTEXPR TAABB<T> TAABB<T>::Merge(const TAABB& b) const
+{
+    using namespace BoundsDetail;
+    return { { Min(min.x, b.min.x), Min(min.y, b.min.y), Min(min.z, b.min.z) },
+             { Max(max.x, b.max.x), Max(max.y, b.max.y), Max(max.z, b.max.z) } };
+}
+
+template<typename T>
+MATH_CONSTEXPR TAABB<T> TAABB<T>::Merge(const TVec3<T>& p) const
+{
+    using namespace BoundsDetail;
+    return { { Min(min.x, p.x), Min(min.y, p.y), Min(min.z, p.z) },
+             { Max(max.x, p.x), Max(max.y, p.y), Max(max.z, p.z) } };
+}
+
+template<typename T>
+MATH_CONSTEXPR bool TAABB<T>::Contains(const TAABB& b) const
+{
+    return min.x <= b.min.x && min.y <= b.min.y && min.z <= b.min.z
+        && b.max.x <= max.x && b.max.y <= max.y && b.max.z <= max.z;
+}
+
+template<typename T>
+MATH_CONSTEXPR bool TAABB<T>::Overlaps(const TAABB& b) const
+{
+    return min.x <= b.max.x && b.min.x <= max.x
+        && min.y <= b.max.y && b.min.y <= max.y
+        && min.z <= b.max.z && b.min.z <= max.z;
+}
+
+template<typename T>
+MATH_CONSTEXPR T TAABB<T>::DistanceSquared(const TVec3<T>& p) const
+{
+    using namespace BoundsDetail;
+    const T dx = Max(Max(min.x - p.x, p.x - max.x), T(0));
+    const T dy = Max(Max(min.y - p.y, p.y - max.y), T(0));
+    const T dz = Max(Max(min.z - p.z, p.z - max.z), T(0));
+    return dx * dx + dy * dy + dz * dz;
+}
+
+template<typename T>
+MATH_CONSTEXPR TAABB<T> TAABB<T>::Transformed(const TAffine3x4<T>& M) const
+{
+    using BoundsDetail::Abs;
+    if (IsEmpty()) return *this;
+    const TVec3<T> c = Center(), e = Extents();
+    const T* m = M.m;
+    const TVec3<T> C{
+        m[0] * c.x + m[1] * c.y + m[2] * c.z + m[3],
+        m[4] * c.x + m[5] * c.y + m[6] * c.z + m[7],
+        m[8] * c.x + m[9] * c.y + m[10] * c.z + m[11] };
+    const TVec3<T> E{
+        Abs(m[0]) * e.x + Abs(m[1]) * e.y + Abs(m[2]) * e.z,
+        Abs(m[4]) * e.x + Abs(m[5]) * e.y + Abs(m[6]) * e.z,
+        Abs(m[8]) * e.x + Abs(m[9]) * e.y + Abs(m[10]) * e.z };
+    return FromCenterExtents(C, E);
+}
+
+// Sphere
+
+template<typename T>
+MATH_CONSTEXPR bool TSphere<T>::Overlaps(const TAABB<T>& b) const
+{
+    return b.DistanceSquared(center) <= radius * radius;
+}
+
+// Ray
+
+template<typename T>
+MATH_CONSTEXPR TRay<T> TRay<T>::FromOriginDirection(const TVec3<T>& o, const TVec3<T>& d)
+{
+    // 1 / 0 = inf: the slabs of that axis are then hit at -inf / +inf (or never)
+    return { o, d, { T(1) / d.x, T(1) / d.y, T(1) / d.z } };
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TRay<T>::At(T t) const
+{
+    return { origin.x + t * direction.x, origin.y + t * direction.y, origin.z + t * direction.z };
+}
+
+template<typename T>
+MATH_CONSTEXPR bool TRay<T>::Intersects(const TAABB<T>& b, T tMax, T& tNear) const
+{
+    using namespace BoundsDetail;
+    // Slab test. Min(a, b) / Max(a, b) return a when b is NaN (0 * inf on a slab
+    // boundary), which ignores that axis.
+    T t0 = 0, t1 = tMax;
+    const T o[3] = { origin.x, origin.y, origin.z };
+    const T inv[3] = { invDirection.x, invDirection.y, invDirection.z };
+    const T lo[3] = { b.min.x, b.min.y, b.min.z };
+    const T hi[3] = { b.max.x, b.max.y, b.max.z };
+    for (int k = 0; k < 3; ++k)
+    {
+        T tA = (lo[k] - o[k]) * inv[k];
+        T tB = (hi[k] - o[k]) * inv[k];
+        if (tB < tA) { const T s = tA; tA = tB; tB = s; }
+        t0 = Max(t0, tA);
+        t1 = Min(t1, tB);
+    }
+    tNear = t0;
+    return t0 <= t1;
+}
+
+// Plane
+
+template<typename T>
+MATH_CONSTEXPR T TPlane<T>::Distance(const TVec3<T>& p) const
+{
+    return normal.x * p.x + normal.y * p.y + normal.z * p.z + d;
+}
+
+// Frustum
+
+template<typename T>
+MATH_CONSTEXPR Containment TFrustum<T>::Classify(const TAABB<T>& b, unsigned& planeMask) const
+{
+    using BoundsDetail::Abs;
+    const TVec3<T> c = b.Center(), e = b.Extents();
+    Containment result = Containment::Inside;
+    for (unsigned k = 0; k < 6; ++k)
+    {
+        if (!(planeMask & (1u << k))) continue;
+        const TPlane<T>& p = planes[k];
+        const T s = p.Distance(c);
+        const T r = Abs(p.normal.x) * e.x + Abs(p.normal.y) * e.y + Abs(p.normal.z) * e.z;
+        if (s + r < 0) return Containment::Outside;
+        if (s - r >= 0) planeMask &= ~(1u << k);
+        else result = Containment::Intersects;
+    }
+    return result;
+}
+
+template<typename T>
+MATH_CONSTEXPR bool TFrustum<T>::Overlaps(const TSphere<T>& s) const
+{
+    for (const TPlane<T>& p : planes)
+        if (p.Distance(s.center) < -s.radius) return false;
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Affine3x4.hpp"
+
+// Rigid transform (rotation + translation, no scale) as a unit dual quaternion
+// real + eps * dual, with dual = 1/2 (0, t) * real. Composing costs 48 multiplies
+// (Matrix4x4: 64) and the result is exact up to rounding: after long chains,
+// Normalized() restores |real| = 1 and real . dual = 0, which is much cheaper
+// than re-orthogonalizing a matrix.
+template<typename T>
+struct TDualQuat
+{
+    TQuat<T> real;                  // Rotation
+    TQuat<T> dual{ 0, 0, 0, 0 };    // 1/2 (0, t) * real
+
+    static MATH_CONSTEXPR TDualQuat Identity();
+    // q must be unit
+    static MATH_CONSTEXPR TDualQuat FromTR(const TVec3<T>& t, const TQuat<T>& q);
+    // Throws if the 3x3 part is not a rotation (as Quat::FromMatrix3x3)
+    static TDualQuat FromAffine3x4(const TAffine3x4<T>& A);
+
+    // this * b: applies b first, as Matrix4x4::Multiply
+    MATH_CONSTEXPR TDualQuat Multiply(const TDualQuat& b) const;
+    MATH_CONSTEXPR TDualQuat operator*(const TDualQuat& b) const
+    {
+        return Multiply(b);
+    }
+
+    // Quaternion conjugate of both parts. For a unit dual quaternion it is the inverse.
+    MATH_CONSTEXPR TDualQuat Conjugate() const;
+    MATH_CONSTEXPR TDualQuat Inverse() const;
+    // Throws on a zero real part
+    TDualQuat Normalized() const;
+
+    MATH_CONSTEXPR TVec3<T> TransformPoint(const TVec3<T>& p) const;
+    MATH_CONSTEXPR TVec3<T> TransformVector(const TVec3<T>& v) const;
+
+    // Getters de components
+    MATH_CONSTEXPR TVec3<T> GetTranslation() const;
+    constexpr TQuat<T> GetRotation() const { return real; }
+
+    // Conversions (unit dual quaternion)
+    TAffine3x4<T> ToAffine3x4() const;
+    template<MatrixLayout L = MatrixLayout::RowMajor>
+    TMatrix4x4<T, L> ToMatrix4x4() const
+    {
+        return ToAffine3x4().template ToMatrix4x4<L>();
+    }
+
+    template<typename U>
+    constexpr TDualQuat<U> Cast() const
+    {
+        return { real.template Cast<U>(), dual.template Cast<U>() };
+    }
+};
+
+using DualQuat = TDualQuat<double>;
+using DualQuatf = TDualQuat<float>;
+
+#if MATH_INLINE_CORE
+#include "DualQuat.inl"
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+// Inline part of DualQuat.hpp (see MathConfig.hpp). Included by the header when
+// MATH_INLINE_CORE is 1, and by src/DualQuat.cpp otherwise.
+
+template<typename T>
+MATH_CONSTEXPR TDualQuat<T> TDualQuat<T>::Identity()
+{
+    return TDualQuat{};
+}
+
+template<typename T>
+MATH_CONSTEXPR TDualQuat<T> TDualQuat<T>::FromTR(const TVec3<T>& t, const TQuat<T>& q)
+{
+    TDualQuat D;
+    D.real = q;
+    D.dual = TQuat<T>{ 0, T(0.5) * t.x, T(0.5) * t.y, T(0.5) * t.z }.Multiply(q);
+    return D;
+}
+
+template<typename T>
+MATH_CONSTEXPR TDualQuat<T> TDualQuat<T>::Multiply(const TDualQuat& b) const
+{
+    TDualQuat D;
+    D.real = real.Multiply(b.real);
+    const TQuat<T> rd = real.Multiply(b.dual);
+    const TQuat<T> dr = dual.Multiply(b.real);
+    D.dual = { rd.s + dr.s, rd.x + dr.x, rd.y + dr.y, rd.z + dr.z };
+    return D;
+}
+
+template<typename T>
+MATH_CONSTEXPR TDualQuat<T> TDualQuat<T>::Conjugate() const
+{
+    TDualQuat D;
+    D.real = { real.s, -real.x, -real.y, -real.z };
+    D.dual = { dual.s, -dual.x, -dual.y, -dual.z };
+    return D;
+}
+
+template<typename T>
+MATH_CONSTEXPR TDualQuat<T> TDualQuat<T>::Inverse() const
+{
+    return Conjugate();
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TDualQuat<T>::GetTranslation() const
+{
+    // Vector part of 2 dual * conj(real)
+    const TVec3<T> rv{ real.x, real.y, real.z };
+    const TVec3<T> dv{ dual.x, dual.y, dual.z };
+    const TVec3<T> c = TVec3<T>::Cross(rv, dv);
+    return {
+        T(2) * (real.s * dv.x - dual.s * rv.x + c.x),
+        T(2) * (real.s * dv.y - dual.s * rv.y + c.y),
+        T(2) * (real.s * dv.z - dual.s * rv.z + c.z)
+    };
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TDualQuat<T>::TransformVector(const TVec3<T>& v) const
+{
+    // Same formula as TQuat::Rotate: v + s t + u x t, t = 2 u x v
+    const TVec3<T> u{ real.x, real.y, real.z };
+    TVec3<T> t = TVec3<T>::Cross(u, v);
+    t = { T(2) * t.x, T(2) * t.y, T(2) * t.z };
+    const TVec3<T> ut = TVec3<T>::Cross(u, t);
+    return { v.x + real.s * t.x + ut.x, v.y + real.s * t.y + ut.y, v.z + real.s * t.z + ut.z };
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TDualQuat<T>::TransformPoint(const TVec3<T>& p) const
+{
+    const TVec3<T> r = TransformVector(p);
+    const TVec3<T> t = GetTranslation();
+    return { r.x + t.x, r.y + t.y, r.z + t.z };
+}
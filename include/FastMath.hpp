@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cmath>
+#include <span>
+#include "MathConfig.hpp"
+
+// Polynomial replacements for the libm calls of the rotation math (sin/cos, acos,
+// 1/sqrt), for T = double or float. The scalar versions are inline (FastMath.inl);
+// the span versions process 4 doubles / 8 floats per step with AVX2 + FMA when
+// Simd::Active() allows it, and fall back to the scalar versions otherwise.
+//
+// Error bounds, measured against a long double reference over the valid range
+// (ULP of the result; for SinCos, ULP of max(|result|, 2^-26) in double and of
+// max(|result|, 2^-12) in float, i.e. absolute error near the zeros of sin/cos):
+//
+//                      double      float
+//   SinCos             2.5 ULP     2 ULP      |x| <= SinCosMax, libm beyond it
+//   Acos               1.5 ULP     1.5 ULP    x in [-1, 1], clamped outside
+//   Rsqrt              2 ULP       4 ULP      x normal and > 0 (0 gives NaN in float)
+//
+// The SIMD lanes use FMA and may differ from the scalar version in the last bit.
+namespace FastMath
+{
+    template<typename T>
+    inline constexpr T SinCosMax = T(1e5);
+    template<>
+    inline constexpr float SinCosMax<float> = 8192.0f;
+
+    // s = sin(x), c = cos(x) with a single range reduction
+    template<typename T>
+    void SinCos(T x, T& s, T& c);
+    template<typename T>
+    T Acos(T x);
+    // 1 / sqrt(x). Float (and the bulk double version): hardware estimate refined
+    // with Newton steps. A single double uses sqrt and a divide.
+    template<typename T>
+    T Rsqrt(T x);
+
+    // Bulk versions. All spans must have the same size.
+    void SinCos(std::span<const double> x, std::span<double> s, std::span<double> c);
+    void SinCos(std::span<const float> x, std::span<float> s, std::span<float> c);
+    void Acos(std::span<const double> x, std::span<double> out);
+    void Acos(std::span<const float> x, std::span<float> out);
+    void Rsqrt(std::span<const double> x, std::span<double> out);
+    void Rsqrt(std::span<const float> x, std::span<float> out);
+}
+
+#if MATH_INLINE_CORE
+#include "FastMath.inl"
+#endif
@@ -0,0 +1,164 @@
+#pragma once
+// Inline part of FastMath.hpp (see MathConfig.hpp). Included by the header when
+// MATH_INLINE_CORE is 1, and by src/FastMath.cpp otherwise.
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FASTMATH_SSE 1
+#else
+#define FASTMATH_SSE 0
+#endif
+
+namespace FastMath
+{
+    namespace Detail
+    {
+        // Minimax coefficients: fdlibm (__kernel_sin, __kernel_cos, asin) for double,
+        // Cephes (sinf, cosf, asinf) for float. Valid for |r| <= pi/4 and z <= 1/4.
+        template<typename T> struct Coeffs;
+
+        template<> struct Coeffs<double>
+        {
+            // pi/2 in three 33-bit pieces: k * PIO2_n is exact for k < 2^20
+            static constexpr double PIO2_1 = 1.57079632673412561417e+00;
+            static constexpr double PIO2_2 = 6.07710050630396597660e-11;
+            static constexpr double PIO2_3 = 2.02226624871116645580e-21;
+            static constexpr double S[6] = { -1.66666666666666324348e-01, 8.33333333332248946124e-03,
+                -1.98412698298579493134e-04, 2.75573137070700676789e-06, -2.50507602534068634195e-08,
+                1.58969099521155010221e-10 };
+            static constexpr double C[6] = { 4.16666666666666019037e-02, -1.38888888888741095749e-03,
+                2.48015872894767294178e-05, -2.75573143513906633035e-07, 2.08757232129817482790e-09,
+                -1.13596475577881948265e-11 };
+            static constexpr double P[6] = { 1.66666666666666657415e-01, -3.25565818622400915405e-01,
+                2.01212532134862925881e-01, -4.00555345006794114027e-02, 7.91534994289814532176e-04,
+                3.47933107596021167570e-05 };
+            static constexpr double Q[4] = { -2.40339491173441421878e+00, 2.02094576023350569471e+00,
+                -6.88283971605453293030e-01, 7.70381505559019352791e-02 };
+        };
+
+        template<> struct Coeffs<float>
+        {
+            // k * PIO2_n is exact for k < 2^13 (|x| <= 8192)
+            static constexpr float PIO2_1 = 1.5703125f;
+            static constexpr float PIO2_2 = 4.837512969970703125e-4f;
+            static constexpr float PIO2_3 = 7.54978995489188216e-8f;
+            static constexpr float S[3] = { -1.6666654611e-1f, 8.3321608736e-3f, -1.9515295891e-4f };
+            static constexpr float C[3] = { 4.166664568298827e-2f, -1.388731625493765e-3f, 2.443315711809948e-5f };
+            static constexpr float P[5] = { 1.6666752422e-1f, 7.4953002686e-2f, 4.5470025998e-2f,
+                2.4181311049e-2f, 4.2163199048e-2f };
+        };
+
+        // sin(r) and cos(r) for |r| <= pi/4, z = r * r
+        template<typename T>
+        inline T SinPoly(T r, T z)
+        {
+            using K = Coeffs<T>;
+            T p;
+            if constexpr (std::is_same_v<T, double>) p = K::S[0] + z * (K::S[1] + z * (K::S[2] + z * (K::S[3] + z * (K::S[4] + z * K::S[5]))));
+            else p = K::S[0] + z * (K::S[1] + z * K::S[2]);
+            return r + r * z * p;
+        }
+
+        template<typename T>
+        inline T CosPoly(T z)
+        {
+            using K = Coeffs<T>;
+            T p;
+            if constexpr (std::is_same_v<T, double>) p = K::C[0] + z * (K::C[1] + z * (K::C[2] + z * (K::C[3] + z * (K::C[4] + z * K::C[5]))));
+            else p = K::C[0] + z * (K::C[1] + z * K::C[2]);
+            return (T(1) - T(0.5) * z) + z * z * p;
+        }
+
+        // asin(s) = s + s * AsinR(z) for z = s * s <= 1/4
+        template<typename T>
+        inline T AsinR(T z)
+        {
+            using K = Coeffs<T>;
+            if constexpr (std::is_same_v<T, double>) {
+                const T p = z * (K::P[0] + z * (K::P[1] + z * (K::P[2] + z * (K::P[3] + z * (K::P[4] + z * K::P[5])))));
+                const T q = T(1) + z * (K::Q[0] + z * (K::Q[1] + z * (K::Q[2] + z * K::Q[3])));
+                return p / q;
+            }
+            else {
+                return z * (K::P[0] + z * (K::P[1] + z * (K::P[2] + z * (K::P[3] + z * K::P[4]))));
+            }
+        }
+
+        template<typename T> inline constexpr T PI = T(3.14159265358979323846);
+        template<typename T> inline constexpr T PIO2 = T(1.57079632679489661923);
+        template<typename T> inline constexpr T TWO_OVER_PI = T(0.636619772367581343076);
+    }
+
+    template<typename T>
+    void SinCos(T x, T& s, T& c)
+    {
+        using K = Detail::Coeffs<T>;
+        if (!(std::fabs(x) <= SinCosMax<T>)) {     // Also NaN
+            s = std::sin(x);
+            c = std::cos(x);
+            return;
+        }
+
+        // x = q * pi/2 + r, |r| <= pi/4
+        const T v = x * Detail::TWO_OVER_PI<T>;
+        const int q = static_cast<int>(v + std::copysign(T(0.5), v));
+        const T k = static_cast<T>(q);
+        const T r = ((x - k * K::PIO2_1) - k * K::PIO2_2) - k * K::PIO2_3;
+        const T z = r * r;
+
+        const T sr = Detail::SinPoly(r, z);
+        const T cr = Detail::CosPoly(z);
+        // Odd q swaps sin and cos, q & 2 negates sin, (q + 1) & 2 negates cos.
+        // Done on the bits so the quadrant doesn't cost a mispredicted branch.
+        using U = std::conditional_t<std::is_same_v<T, double>, std::uint64_t, std::uint32_t>;
+        constexpr int SIGN = sizeof(U) * 8 - 1;
+        const U swap = U(0) - U(q & 1);
+        const U bs = std::bit_cast<U>(sr), bc = std::bit_cast<U>(cr);
+        s = std::bit_cast<T>(((bc & swap) | (bs & ~swap)) ^ (U(q & 2) << (SIGN - 1)));
+        c = std::bit_cast<T>(((bs & swap) | (bc & ~swap)) ^ (U((q + 1) & 2) << (SIGN - 1)));
+    }
+
+    template<typename T>
+    T Acos(T x)
+    {
+        const T a = std::min(std::fabs(x), T(1));
+        if (a <= T(0.5))
+        {
+            // pi/2 - asin(x)
+            const T t = a + a * Detail::AsinR(a * a);
+            return Detail::PIO2<T> - std::copysign(t, x);
+        }
+        // acos(a) = 2 asin(sqrt((1 - a) / 2))
+        const T z = (T(1) - a) * T(0.5);
+        const T s = std::sqrt(z);
+        const T t = s + s * Detail::AsinR(z);
+        return (x > T(0)) ? T(2) * t : Detail::PI<T> - T(2) * t;
+    }
+
+    template<typename T>
+    T Rsqrt(T x)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+#if FASTMATH_SSE
+            float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));    // 12 bits
+            return y * (1.5f - 0.5f * x * y * y);
+#else
+            float y = std::bit_cast<float>(0x5f375a86u - (std::bit_cast<std::uint32_t>(x) >> 1));
+            y = y * (1.5f - 0.5f * x * y * y);
+            y = y * (1.5f - 0.5f * x * y * y);
+            return y * (1.5f - 0.5f * x * y * y);
+#endif
+        }
+        else
+        {
+            // For a single double, sqrt + divide is as fast as the float estimate plus
+            // the three Newton steps double precision needs. The bulk version does use them.
+            return 1.0 / std::sqrt(x);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "Bounds.hpp"
+#include "Scene.hpp"
+#include <span>
+#include <vector>
+
+// View-frustum culling of a Scene for the render traversal.
+//
+// Update keeps two boxes per node: its own world box (meshBounds[mesh] transformed by
+// its world matrix) and the box of its whole subtree, the union of the own boxes in
+// [i, i + SubtreeSize(i)). Cull walks the scene in pre-order with the subtree boxes: a
+// subtree outside the frustum is skipped, one inside is visible without more tests,
+// and the planes a subtree is inside of are not tested again below it. Subtrees of at
+// most FLAT_SUBTREE nodes that straddle the frustum are finished with
+// Simd::ClassifyBoxesSoA over their own boxes, several at a time.
+//
+// A node whose mesh has no bounds (out of meshBounds, or an empty box) is never culled.
+class FrustumCuller {
+public:
+    static constexpr std::size_t FLAT_SUBTREE = 64;
+
+    struct Stats {
+        std::size_t visible;
+        std::size_t culled;
+        std::size_t subtreesOutside;    // Skipped without testing their nodes
+        std::size_t subtreesInside;     // Visible without testing their nodes
+        std::size_t boxesTested;        // Subtree and own boxes
+    };
+
+    // Call after Scene::UpdateWorld. Recomputes the own boxes of the nodes whose world
+    // matrix changed (all of them when the layout of the scene changed) and then the
+    // subtree boxes; nothing when nothing moved.
+    void Update(const Scene& scene, std::span<const AABB> meshBounds);
+    // Visibility of every node of the last Update
+    void Cull(const Frustum& frustum);
+
+    bool IsVisible(std::size_t i) const { return (flags[i] & VISIBLE) != 0; }
+    // Nothing in the subtree of i is visible: the traversal can skip it
+    bool IsSubtreeCulled(std::size_t i) const { return (flags[i] & SUBTREE_CULLED) != 0; }
+    const Stats& GetStats() const { return stats; }
+
+private:
+    static constexpr uint8_t VISIBLE = 1, SUBTREE_CULLED = 2;
+
+    void ClassifyOwn(std::size_t begin, std::size_t end);
+
+    // Own boxes, min and max corners (SoA, for the SIMD kernel)
+    std::vector<double> x0, y0, z0, x1, y1, z1;
+    std::vector<AABB> subtreeBox;
+    std::vector<uint32_t> subtreeSize;
+    std::vector<uint8_t> flags;
+    std::vector<uint8_t> containment;   // Scratch for Simd::ClassifyBoxesSoA
+    double planes[24] = {};
+
+    const Scene* scene = nullptr;
+    uint32_t syncedVersion = 0;
+    uint32_t syncedLayout = 0;
+    Stats stats{};
+};
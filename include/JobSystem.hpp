@@ -0,0 +1,121 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing job scheduler for the per-frame systems (world update, culling,
+// animation). Every thread has its own queue: it pushes and pops its own jobs at the
+// back (LIFO, cache friendly) and idle threads steal from the front of the others
+// (FIFO, the biggest pieces of work first). Threads that are not workers (the main
+// thread) share queue 0, and Wait() makes the caller run jobs instead of blocking.
+//
+// The scheduler only decides where and when a job runs; a job that writes disjoint
+// outputs gives the same result with any number of threads.
+class JobSystem {
+public:
+    // threads counts the calling thread too: threads - 1 workers are started.
+    // 0 uses all hardware threads.
+    explicit JobSystem(unsigned threads = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned ThreadCount() const { return static_cast<unsigned>(queues.size()); }
+
+    // Unfinished jobs of a batch. Wait() rethrows the first exception of the batch.
+    class Counter {
+    public:
+        bool Done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+        std::atomic<int> pending{ 0 };
+        std::exception_ptr error;
+        std::mutex errorMutex;
+    };
+
+    void Run(Counter& counter, std::function<void()> job);
+    // Runs queued jobs (of any batch) until counter is done, then rethrows its error
+    void Wait(Counter& counter);
+
+    // f(begin, end) over [0, n) in chunks of at least grain elements; returns when all
+    // chunks are done. The caller runs the first chunk itself.
+    template<typename F>
+    void ParallelFor(std::size_t n, std::size_t grain, F&& f);
+
+private:
+    struct Job {
+        void (*fn)(void* ctx, std::size_t begin, std::size_t end) = nullptr;
+        void* ctx = nullptr;
+        std::size_t begin = 0, end = 0;
+        Counter* counter = nullptr;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void Submit(const Job& job);
+    bool Pop(std::size_t self, Job& job);
+    bool Steal(std::size_t self, Job& job);
+    void Execute(const Job& job);
+    std::size_t CurrentQueue() const;
+    void WorkerLoop(std::size_t self);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<int> queued{ 0 };
+    std::atomic<int> sleeping{ 0 };
+    std::atomic<bool> stop{ false };
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+};
+
+template<typename F>
+void JobSystem::ParallelFor(std::size_t n, std::size_t grain, F&& f)
+{
+    if (n == 0) return;
+    if (grain == 0) grain = 1;
+    const std::size_t chunks = (n + grain - 1) / grain;
+    if (chunks == 1 || ThreadCount() == 1)
+    {
+        f(std::size_t(0), n);
+        return;
+    }
+
+    using Fn = std::remove_reference_t<F>;
+    Counter counter;
+    Job job;
+    job.fn = [](void* ctx, std::size_t b, std::size_t e) { (*static_cast<Fn*>(ctx))(b, e); };
+    job.ctx = const_cast<void*>(static_cast<const void*>(&f));
+    job.counter = &counter;
+
+    const std::size_t step = (n + chunks - 1) / chunks;
+    counter.pending.store(static_cast<int>(chunks - 1), std::memory_order_relaxed);
+    for (std::size_t b = step; b < n; b += step)
+    {
+        job.begin = b;
+        job.end = std::min(n, b + step);
+        Submit(job);
+    }
+    try
+    {
+        f(std::size_t(0), std::min(n, step));
+    }
+    catch (...)
+    {
+        Wait(counter);      // The other chunks still use f
+        throw;
+    }
+    Wait(counter);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <type_traits>
+
+// MATH_INLINE_CORE selects how the small, hot operations of the math core
+// (Identity, Translate, Scale, Multiply, Dot, Cross, Quat composition, ...) are built:
+//  - 1 (default): defined in the headers (*.inl) as constexpr. They inline into
+//    the callers and fold at compile time when the arguments are constants.
+//  - 0: compiled out of line in src/*.cpp, as the rest of the library. Kept to
+//    compare both builds (bench/bench_inline.cpp).
+#ifndef MATH_INLINE_CORE
+#define MATH_INLINE_CORE 1
+#endif
+
+#if MATH_INLINE_CORE
+#define MATH_CONSTEXPR constexpr
+#define MATH_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define MATH_CONSTEXPR
+#define MATH_IS_CONSTANT_EVALUATED() false
+#endif
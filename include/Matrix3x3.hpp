@@ -2,50 +2,90 @@
 #include <vector>
 #include <cstddef>
 #include <cmath>
+#include <span>
+#include "MathConfig.hpp"
 
-struct Vec3 
+// The math core is templated on the scalar type (T = double or float).
+// Definitions live in src/*.cpp and are explicitly instantiated for both,
+// except the MATH_CONSTEXPR ones, which live in Matrix3x3.inl (see MathConfig.hpp).
+
+template<typename T>
+struct TVec3
 {
-    double x = 0, y = 0, z = 0;
+    T x = 0, y = 0, z = 0;
+
+    static MATH_CONSTEXPR T Dot(const TVec3& a, const TVec3& b);
+    static MATH_CONSTEXPR TVec3 Cross(const TVec3& a, const TVec3& b);
+    T Norm() const;
+    TVec3 Normalize() const;
 
-    static double Dot(const Vec3& a, const Vec3& b);
-    static Vec3 Cross(const Vec3& a, const Vec3& b);
-    double Norm() const;
-    Vec3 Normalize() const;
+    template<typename U>
+    constexpr TVec3<U> Cast() const
+    {
+        return { static_cast<U>(x), static_cast<U>(y), static_cast<U>(z) };
+    }
 };
 
-struct Matrix3x3 
+template<typename T>
+struct TMatrix3x3
 {
     // Row-major
-    double m[9] = { 0 };
+    T m[9] = { 0 };
 
-    static Matrix3x3 Identity();
-    double& At(std::size_t i, std::size_t j) { return m[i * 3 + j]; }
-    double  At(std::size_t i, std::size_t j) const { return m[i * 3 + j]; }
+    static MATH_CONSTEXPR TMatrix3x3 Identity();
+    constexpr T& At(std::size_t i, std::size_t j) { return m[i * 3 + j]; }
+    constexpr T  At(std::size_t i, std::size_t j) const { return m[i * 3 + j]; }
 
-    Vec3 Multiply(const Vec3& x) const;
-    Matrix3x3 Multiply(const Matrix3x3& B) const;
+    MATH_CONSTEXPR TVec3<T> Multiply(const TVec3<T>& x) const;
+    MATH_CONSTEXPR TMatrix3x3 Multiply(const TMatrix3x3& B) const;
 
-    Vec3 operator*(const Vec3& x) const
+    MATH_CONSTEXPR TVec3<T> operator*(const TVec3<T>& x) const
     {
         return Multiply(x);
     }
-    Matrix3x3 operator*(const Matrix3x3& B) const
+    MATH_CONSTEXPR TMatrix3x3 operator*(const TMatrix3x3& B) const
     {
         return Multiply(B);
     }
 
-    double Det() const;
-    Matrix3x3 Transposed() const;
-    double Trace() const;
+    MATH_CONSTEXPR T Det() const;
+    MATH_CONSTEXPR TMatrix3x3 Transposed() const;
+    MATH_CONSTEXPR T Trace() const;
+
+    // Inverses. Inverse() throws if the matrix is singular; TryInverse reports it
+    // instead (returns false and leaves out untouched). det may be null.
+    TMatrix3x3 Inverse() const;
+    TMatrix3x3 InverseTransposed() const;   // Normal matrix
+    bool TryInverse(TMatrix3x3& out, T* det = nullptr) const;
+    // in and out must have the same size; det is empty or the same size too. Singular
+    // matrices get a zero output and det 0. Returns how many were singular.
+    static std::size_t InverseBatch(std::span<const TMatrix3x3> in, std::span<TMatrix3x3> out, std::span<T> det = {});
 
     bool IsRotation() const;
-    static Matrix3x3 RotationAxisAngle(const Vec3& u, double phi);
-    void ToAxisAngle(Vec3& axis, double& angle) const;
-    Vec3 Rotate(const Vec3& v) const;
+    static TMatrix3x3 RotationAxisAngle(const TVec3<T>& u, T phi);
+    void ToAxisAngle(TVec3<T>& axis, T& angle) const;
+    TVec3<T> Rotate(const TVec3<T>& v) const;
 
-    static Matrix3x3 FromEulerZYX(double yaw, double pitch, double roll);
-    void ToEulerZYX(double& yaw, double& pitch, double& roll) const;
+    static TMatrix3x3 FromEulerZYX(T yaw, T pitch, T roll);
+    void ToEulerZYX(T& yaw, T& pitch, T& roll) const;
 
-    static Matrix3x3 RotateFromTo(const Vec3& u, const Vec3& v);
-    static Matrix3x3 RotateToTarget(const Matrix3x3& initialRot, const Matrix3x3& finalRot);
+    static TMatrix3x3 RotateFromTo(const TVec3<T>& u, const TVec3<T>& v);
+    static TMatrix3x3 RotateToTarget(const TMatrix3x3& initialRot, const TMatrix3x3& finalRot);
+
+    template<typename U>
+    constexpr TMatrix3x3<U> Cast() const
+    {
+        TMatrix3x3<U> R;
+        for (std::size_t i = 0; i < 9; ++i) R.m[i] = static_cast<U>(m[i]);
+        return R;
+    }
 };
+
+using Vec3 = TVec3<double>;
+using Vec3f = TVec3<float>;
+using Matrix3x3 = TMatrix3x3<double>;
+using Matrix3x3f = TMatrix3x3<float>;
+
+#if MATH_INLINE_CORE
+#include "Matrix3x3.inl"
+#endif
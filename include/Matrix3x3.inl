@@ -0,0 +1,79 @@
+#pragma once
+// Inline part of Matrix3x3.hpp (see MathConfig.hpp). Included by the header when
+// MATH_INLINE_CORE is 1, and by src/Matrix3x3.cpp otherwise.
+
+// ------------------ Vec3 -------------------------
+
+template<typename T>
+MATH_CONSTEXPR T TVec3<T>::Dot(const TVec3& a, const TVec3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TVec3<T>::Cross(const TVec3& a, const TVec3& b)
+{
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+// ------------------ Matrix3x3 ---------------------
+
+template<typename T>
+MATH_CONSTEXPR TMatrix3x3<T> TMatrix3x3<T>::Identity()
+{
+    TMatrix3x3 I;
+    I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1;
+    return I;
+}
+
+template<typename T>
+MATH_CONSTEXPR TVec3<T> TMatrix3x3<T>::Multiply(const TVec3<T>& x) const
+{
+    // y = A * x
+    TVec3<T> y;
+    y.x = At(0, 0) * x.x + At(0, 1) * x.y + At(0, 2) * x.z;
+    y.y = At(1, 0) * x.x + At(1, 1) * x.y + At(1, 2) * x.z;
+    y.z = At(2, 0) * x.x + At(2, 1) * x.y + At(2, 2) * x.z;
+    return y;
+}
+
+template<typename T>
+MATH_CONSTEXPR TMatrix3x3<T> TMatrix3x3<T>::Multiply(const TMatrix3x3& B) const
+{
+    TMatrix3x3 C{};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            T s = 0.0;
+            for (int k = 0; k < 3; ++k) {
+                s += At(i, k) * B.At(k, j);
+            }
+            C.At(i, j) = s;
+        }
+    }
+    return C;
+}
+
+template<typename T>
+MATH_CONSTEXPR T TMatrix3x3<T>::Det() const
+{
+    const T a = At(0, 0), b = At(0, 1), c = At(0, 2);
+    const T d = At(1, 0), e = At(1, 1), f = At(1, 2);
+    const T g = At(2, 0), h = At(2, 1), i = At(2, 2);
+    return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+}
+
+template<typename T>
+MATH_CONSTEXPR TMatrix3x3<T> TMatrix3x3<T>::Transposed() const
+{
+    TMatrix3x3 R{};
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            R.At(i, j) = At(j, i);
+    return R;
+}
+
+template<typename T>
+MATH_CONSTEXPR T TMatrix3x3<T>::Trace() const
+{
+    return At(0, 0) + At(1, 1) + At(2, 2);
+}
@@ -2,57 +2,141 @@
 #include "Matrix3x3.hpp"
 #include "Quat.hpp"
 #include <iostream>
+#include <span>
 
-struct Vec4
+template<typename T>
+struct TVec4
 {
-    double x = 0, y = 0, z = 0, w = 0;
+    T x = 0, y = 0, z = 0, w = 0;
 
-    Vec4() = default;
-    Vec4(double _x, double _y, double _z, double _w) : x(_x), y(_y), z(_z), w(_w) {}
-    Vec4(const Vec3& v, double _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
+    TVec4() = default;
+    constexpr TVec4(T _x, T _y, T _z, T _w) : x(_x), y(_y), z(_z), w(_w) {}
+    constexpr TVec4(const TVec3<T>& v, T _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
 };
 
-struct Matrix4x4
+// Storage order of TMatrix4x4::m. At(i, j) hides it from the rest of the code.
+enum class MatrixLayout
 {
-    // Row-major: m[row * 4 + col]
-    double m[16] = { 0 };
+    RowMajor,       // m[row * 4 + col]
+    ColumnMajor     // m[col * 4 + row], same as OpenGL / GLSL
+};
+
+// How Decompose() factors the 3x3 part M = R * H * S (rotation, shear, scale)
+enum class DecomposeMode
+{
+    Fast,           // R * S with positive scale and no shear
+    NegativeScale,  // As Fast, but a mirrored matrix (det < 0) gives a negative x scale
+    Shear           // Gram-Schmidt: also returns H (xy, xz, yz) and handles det < 0 like NegativeScale
+};
 
-    static Matrix4x4 Identity();
-    double& At(std::size_t i, std::size_t j) { return m[i * 4 + j]; }
-    double  At(std::size_t i, std::size_t j) const { return m[i * 4 + j]; }
+// 16-byte aligned so the float column-major version has exactly the layout of a
+// GLSL mat4 (std140 / std430) and can be copied into GPU buffers as it is.
+template<typename T, MatrixLayout L = MatrixLayout::RowMajor>
+struct alignas(16) TMatrix4x4
+{
+    T m[16] = { 0 };
+
+    static constexpr std::size_t Index(std::size_t i, std::size_t j)
+    {
+        return (L == MatrixLayout::RowMajor) ? i * 4 + j : j * 4 + i;
+    }
 
-    Matrix4x4 Multiply(const Matrix4x4& B) const;
-    Vec4 Multiply(const Vec4& v) const;
+    static MATH_CONSTEXPR TMatrix4x4 Identity();
+    constexpr T& At(std::size_t i, std::size_t j) { return m[Index(i, j)]; }
+    constexpr T  At(std::size_t i, std::size_t j) const { return m[Index(i, j)]; }
+
+    MATH_CONSTEXPR TMatrix4x4 Multiply(const TMatrix4x4& B) const;
+    MATH_CONSTEXPR TVec4<T> Multiply(const TVec4<T>& v) const;
 
     bool IsAffine() const;
-	
+
     // Transformacions de punts i vectors
-	Vec3 TransformPoint(const Vec3& p) const;
-	Vec3 TransformVector(const Vec3& v) const;
+    // TransformPoint divides by w unless the matrix is affine (IsAffine) or w is 0, as
+    // TransformPoints does for every point.
+	TVec3<T> TransformPoint(const TVec3<T>& p) const;
+	TVec3<T> TransformVector(const TVec3<T>& v) const;
+
+    // Transformacions en bloc (AoS i SoA)
+    // in and out must have the same size and may be the same buffer.
+    // TransformPoints skips the divide by w when the matrix is affine (IsAffine) and
+    // otherwise divides unless w is 0; the Projective versions always take the second
+    // path.
+    void TransformPoints(std::span<const TVec3<T>> in, std::span<TVec3<T>> out) const;
+    void TransformVectors(std::span<const TVec3<T>> in, std::span<TVec3<T>> out) const;
+    void TransformPointsProjective(std::span<const TVec3<T>> in, std::span<TVec3<T>> out) const;
+
+    void TransformPoints(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+        std::span<T> ox, std::span<T> oy, std::span<T> oz) const;
+    void TransformVectors(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+        std::span<T> ox, std::span<T> oy, std::span<T> oz) const;
+    void TransformPointsProjective(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+        std::span<T> ox, std::span<T> oy, std::span<T> oz) const;
 
     // Statics
-    static Matrix4x4 Translate(const Vec3& t);
-    static Matrix4x4 Scale(const Vec3& s);
-    static Matrix4x4 Rotate(const Matrix3x3& R);
-    static Matrix4x4 Rotate(const Quat& q);
-    static Matrix4x4 FromTRS(const Vec3& t, const Matrix3x3& R, const Vec3& s);
-    static Matrix4x4 FromTRS(const Vec3& t, const Quat& q, const Vec3& s);
+    static MATH_CONSTEXPR TMatrix4x4 Translate(const TVec3<T>& t);
+    static MATH_CONSTEXPR TMatrix4x4 Scale(const TVec3<T>& s);
+    static MATH_CONSTEXPR TMatrix4x4 Rotate(const TMatrix3x3<T>& R);
+    static TMatrix4x4 Rotate(const TQuat<T>& q);
+    static MATH_CONSTEXPR TMatrix4x4 FromTRS(const TVec3<T>& t, const TMatrix3x3<T>& R, const TVec3<T>& s);
+    static TMatrix4x4 FromTRS(const TVec3<T>& t, const TQuat<T>& q, const TVec3<T>& s);
 
 	// Inverses
-    Matrix4x4 InverseTR() const;
-	Matrix4x4 InverseTRS() const;
+    TMatrix4x4 InverseTR() const;
+	TMatrix4x4 InverseTRS() const;
+    // General inverse (any invertible matrix, projections included). Inverse() throws
+    // if the matrix is singular; TryInverse reports it instead and leaves out untouched.
+    TMatrix4x4 Inverse() const;
+    TMatrix4x4 InverseTransposed() const;
+    TMatrix3x3<T> NormalMatrix() const;     // Inverse-transpose of the 3x3 part
+    bool TryInverse(TMatrix4x4& out, T* det = nullptr) const;
+    // in and out must have the same size; det is empty or the same size too. Singular
+    // matrices get a zero output and det 0. Returns how many were singular.
+    static std::size_t InverseBatch(std::span<const TMatrix4x4> in, std::span<TMatrix4x4> out, std::span<T> det = {});
 
     // Getters de components
-    Vec3 GetTranslation() const;
-	Matrix3x3 GetRotation() const;
-	Quat GetRotationQuat() const;
-	Vec3 GetScale() const;
-    Matrix3x3 GetRotationScale() const;
+    TVec3<T> GetTranslation() const;
+	TMatrix3x3<T> GetRotation() const;
+	TQuat<T> GetRotationQuat() const;
+	TVec3<T> GetScale() const;
+    TMatrix3x3<T> GetRotationScale() const;
+
+    // Decomposicio TRS en una sola passada (see TAffine3x4::Decompose)
+    // Checks IsAffine once. Returns false when a scale axis is 0 (q is then the identity).
+    bool Decompose(TVec3<T>& t, TQuat<T>& q, TVec3<T>& s,
+        DecomposeMode mode = DecomposeMode::Fast, TVec3<T>* shear = nullptr) const;
+    // Whole arrays at once; all spans must have the same size. Returns how many failed.
+    static std::size_t DecomposeBatch(std::span<const TMatrix4x4> m, std::span<TVec3<T>> t,
+        std::span<TQuat<T>> q, std::span<TVec3<T>> s, DecomposeMode mode = DecomposeMode::Fast);
 
 	// Setters de components
-	void SetTranslation(const Vec3& t);
-	void SetRotation(const Matrix3x3& R);
-	void SetRotation(const Quat& q);
-	void SetScale(const Vec3& s);
-	void SetRotationScale(const Matrix3x3& RS);
-};
\ No newline at end of file
+	void SetTranslation(const TVec3<T>& t);
+	void SetRotation(const TMatrix3x3<T>& R);
+	void SetRotation(const TQuat<T>& q);
+	void SetScale(const TVec3<T>& s);
+	void SetRotationScale(const TMatrix3x3<T>& RS);
+
+    // Conversio de precisio i/o layout
+    template<typename U, MatrixLayout L2 = L>
+    constexpr TMatrix4x4<U, L2> Cast() const
+    {
+        TMatrix4x4<U, L2> R;
+        for (std::size_t i = 0; i < 4; ++i)
+            for (std::size_t j = 0; j < 4; ++j)
+                R.At(i, j) = static_cast<U>(At(i, j));
+        return R;
+    }
+};
+
+using Vec4 = TVec4<double>;
+using Vec4f = TVec4<float>;
+using Matrix4x4 = TMatrix4x4<double>;
+using Matrix4x4f = TMatrix4x4<float>;
+// GPU layout: float, column-major, 16-byte aligned. Uploads with no conversion or transpose.
+using Matrix4x4GL = TMatrix4x4<float, MatrixLayout::ColumnMajor>;
+
+static_assert(sizeof(Matrix4x4GL) == 16 * sizeof(float) && alignof(Matrix4x4GL) == 16,
+    "Matrix4x4GL must match a GLSL mat4");
+
+#if MATH_INLINE_CORE
+#include "Matrix4x4.inl"
+#endif
@@ -0,0 +1,124 @@
+#pragma once
+// Inline part of Matrix4x4.hpp (see MathConfig.hpp). Included by the header when
+// MATH_INLINE_CORE is 1, and by src/Matrix4x4.cpp otherwise.
+#include "Simd.hpp"
+
+template<typename T, MatrixLayout L>
+MATH_CONSTEXPR TMatrix4x4<T, L> TMatrix4x4<T, L>::Identity()
+{
+    TMatrix4x4 I;
+    I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1; I.At(3, 3) = 1;
+    return I;
+}
+
+template<typename T, MatrixLayout L>
+MATH_CONSTEXPR TMatrix4x4<T, L> TMatrix4x4<T, L>::Multiply(const TMatrix4x4& B) const
+{
+    TMatrix4x4 C;
+    if (!MATH_IS_CONSTANT_EVALUATED()) {
+        // SIMD kernel picked at runtime (see Simd.hpp). The kernels work on row-major
+        // storage; a column-major matrix stores the transpose, so C^T = B^T * A^T.
+        if constexpr (L == MatrixLayout::RowMajor) {
+            if constexpr (std::is_same_v<T, double>) Simd::Mat4Mul(m, B.m, C.m);
+            else Simd::Mat4MulF(m, B.m, C.m);
+        }
+        else {
+            if constexpr (std::is_same_v<T, double>) Simd::Mat4Mul(B.m, m, C.m);
+            else Simd::Mat4MulF(B.m, m, C.m);
+        }
+        return C;
+    }
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            T sum = 0;
+            for (std::size_t k = 0; k < 4; ++k) {
+                sum += At(i, k) * B.At(k, j);
+            }
+            C.At(i, j) = sum;
+        }
+    }
+    return C;
+}
+
+template<typename T, MatrixLayout L>
+MATH_CONSTEXPR TVec4<T> TMatrix4x4<T, L>::Multiply(const TVec4<T>& v) const
+{
+    if constexpr (std::is_same_v<T, double> && L == MatrixLayout::RowMajor) {
+        if (!MATH_IS_CONSTANT_EVALUATED()) {
+            const double in[4] = { v.x, v.y, v.z, v.w };
+            double out[4] = {};
+            Simd::Mat4MulVec4(m, in, out);
+            return TVec4<T>(out[0], out[1], out[2], out[3]);
+        }
+    }
+
+    TVec4<T> res;
+    res.x = At(0, 0) * v.x + At(0, 1) * v.y + At(0, 2) * v.z + At(0, 3) * v.w;
+    res.y = At(1, 0) * v.x + At(1, 1) * v.y + At(1, 2) * v.z + At(1, 3) * v.w;
+    res.z = At(2, 0) * v.x + At(2, 1) * v.y + At(2, 2) * v.z + At(2, 3) * v.w;
+    res.w = At(3, 0) * v.x + At(3, 1) * v.y + At(3, 2) * v.z + At(3, 3) * v.w;
+    return res;
+}
+
+template<typename T, MatrixLayout L>
+MATH_CONSTEXPR TMatrix4x4<T, L> TMatrix4x4<T, L>::Translate(const TVec3<T>& t)
+{
+    TMatrix4x4 M = TMatrix4x4::Identity();
+
+    M.At(0,3) = t.x;
+    M.At(1,3) = t.y;
+    M.At(2,3) = t.z;
+
+    return M;
+}
+
+template<typename T, MatrixLayout L>
+MATH_CONSTEXPR TMatrix4x4<T, L> TMatrix4x4<T, L>::Scale(const TVec3<T>& s)
+{
+    TMatrix4x4 M = TMatrix4x4::Identity();
+
+    M.At(0, 0) = s.x;
+    M.At(1, 1) = s.y;
+    M.At(2, 2) = s.z;
+
+
+    return M;
+}
+
+template<typename T, MatrixLayout L>
+MATH_CONSTEXPR TMatrix4x4<T, L> TMatrix4x4<T, L>::Rotate(const TMatrix3x3<T>& R)
+{
+    TMatrix4x4 M = TMatrix4x4::Identity();
+
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            M.At(i, j) = R.At(i, j);
+        }
+    }
+
+    return M;
+}
+
+template<typename T, MatrixLayout L>
+MATH_CONSTEXPR TMatrix4x4<T, L> TMatrix4x4<T, L>::FromTRS(const TVec3<T>& t, const TMatrix3x3<T>& R, const TVec3<T>& s)
+{
+    TMatrix4x4 M;
+    M = Rotate(R);
+
+    T scales[3] = { s.x, s.y, s.z };
+
+    for (int j = 0; j < 3; ++j)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            M.At(i, j) = M.At(i, j) * scales[j];
+        }
+    }
+
+    M.At(0, 3) = t.x;
+    M.At(1, 3) = t.y;
+    M.At(2, 3) = t.z;
+
+    return M;
+}
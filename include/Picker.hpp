@@ -0,0 +1,64 @@
+#pragma once
+#include "BVH.hpp"
+#include <span>
+#include <vector>
+
+// Triangles of a mesh, in mesh space, for exact ray hits. They are kept as the nine SoA
+// arrays of Simd::IntersectRayTrianglesSoA (v0 and the two edges from it).
+class PickMesh {
+public:
+    // positions holds x, y, z per vertex and indices three vertices per triangle.
+    // Throws std::out_of_range when an index is past the last vertex.
+    static PickMesh FromIndexed(std::span<const float> positions, std::span<const unsigned> indices);
+
+    // Nearest triangle hit within t (in units of ray.direction, which may have any
+    // length); sets t and triangle. False when there is none.
+    bool Raycast(const Ray& ray, double& t, std::size_t& triangle) const;
+
+    std::size_t TriangleCount() const { return count; }
+    const AABB& Bounds() const { return bounds; }
+
+private:
+    std::vector<double> triangles;  // 9 * count
+    std::size_t count = 0;
+    AABB bounds;
+};
+
+// Mouse picking: the ray under a pixel and the nearest node it hits. The BVH finds the
+// few world boxes near the ray, nearest first; the ray is taken to mesh space (inverse
+// world matrix, so the distance along it does not change) to test the triangles of the
+// node's mesh. Boxes entered after the best triangle hit so far are never opened.
+class Picker {
+public:
+    struct Hit {
+        GameObjectHandle object;
+        double t = 0.0;             // Along the ray
+        Vec3 point;                 // World space
+        std::size_t triangle = 0;   // Of the mesh; 0 for nodes tested by their box only
+    };
+
+    // Last Pick
+    struct Stats {
+        std::size_t objectsTested;  // Leaves of the BVH reached by the ray
+        std::size_t trianglesTested;
+        double ms;
+    };
+
+    // Ray from the near plane (t = 0) to the far plane (t = 1) through the point
+    // (ndcX, ndcY) in [-1, 1] of normalized device coordinates. inverseViewProjection is
+    // (projection * view)^-1, OpenGL clip space.
+    static Ray ScreenRay(const Matrix4x4& inverseViewProjection, double ndcX, double ndcY);
+    // Same through pixel (x, y) of a width x height viewport, y down (window coordinates)
+    static Ray ScreenRay(const Matrix4x4& inverseViewProjection, double x, double y, double width, double height);
+
+    // Nearest node hit by the ray within [0, tMax]. Call after Scene::UpdateWorld and
+    // BVH::Refit. Nodes whose mesh is out of meshes or has no triangles are hit by their
+    // world box. False when nothing is hit.
+    bool Pick(const Scene& scene, const BVH& bvh, std::span<const PickMesh> meshes, const Ray& ray, double tMax,
+        Hit& hit);
+
+    const Stats& GetStats() const { return stats; }
+
+private:
+    Stats stats{};
+};
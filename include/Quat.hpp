@@ -1,28 +1,85 @@
 #pragma once
 #include "Matrix3x3.hpp"
 
-struct Quat 
+// How TQuat::Slerp interpolates (see bench/bench_slerp.cpp for the measured errors)
+enum class SlerpMode
 {
-    double s = 1, x = 0, y = 0, z = 0;
+    Exact,          // acos + sin/cos (FastMath)
+    Fast            // Corrected nlerp: polynomial fix of t, no transcendentals.
+                    // Max angular error 8e-4 rad, reached for nearly opposite rotations.
+};
 
-    Quat Normalized() const;
-    Quat Multiply(const Quat& b) const;
-    Quat operator*(const Quat& b) const
+template<typename T>
+struct TQuat
+{
+    T s = 1, x = 0, y = 0, z = 0;
+
+    TQuat Normalized() const;
+    MATH_CONSTEXPR TQuat Multiply(const TQuat& b) const;
+    MATH_CONSTEXPR TQuat operator*(const TQuat& b) const
     {
         return Multiply(b);
 	}
 
-    Vec3 Rotate(const Vec3& v) const;
+    TVec3<T> Rotate(const TVec3<T>& v) const;
+
+    // FromMatrix3x3 throws if R is not a rotation and ToMatrix3x3 normalizes first.
+    // The Unchecked versions trust the caller (R orthonormal with det 1, quaternion
+    // of unit length) and only assert it in debug builds.
+    static TQuat FromMatrix3x3(const TMatrix3x3<T>& R);
+    static TQuat FromMatrix3x3Unchecked(const TMatrix3x3<T>& R);
+    TMatrix3x3<T> ToMatrix3x3() const;
+    TMatrix3x3<T> ToMatrix3x3Unchecked() const;
+
+    static TQuat FromAxisAngle(const TVec3<T>& u, T phi);
+    void ToAxisAngle(TVec3<T>& axis, T& angle) const;
+
+    // Closed form, same convention as Matrix3x3: R = Rz(yaw) * Ry(pitch) * Rx(roll)
+    static TQuat FromEulerZYX(T yaw, T pitch, T roll);
+    void ToEulerZYX(T& yaw, T& pitch, T& roll) const;
+
+    static TQuat RotateFromTo(const TVec3<T>& u, const TVec3<T>& v);
+    static TQuat RotateToTarget(const TQuat& initialRot, const TQuat& finalRot);
+
+    // Interpolacio esferica. a and b must be unit quaternions (only asserted in debug
+    // builds); the result takes the shortest path and is unit.
+    static TQuat Slerp(const TQuat& a, const TQuat& b, T t, SlerpMode mode = SlerpMode::Exact);
+    // Whole arrays at once; all spans must have the same size. The Exact mode runs
+    // acos and sin/cos through the bulk FastMath versions.
+    static void SlerpBatch(std::span<const TQuat> a, std::span<const TQuat> b, T t,
+        std::span<TQuat> out, SlerpMode mode = SlerpMode::Exact);
+    static void SlerpBatch(std::span<const TQuat> a, std::span<const TQuat> b, std::span<const T> t,
+        std::span<TQuat> out, SlerpMode mode = SlerpMode::Exact);
+
+    template<typename U>
+    constexpr TQuat<U> Cast() const
+    {
+        return { static_cast<U>(s), static_cast<U>(x), static_cast<U>(y), static_cast<U>(z) };
+    }
+};
+
+// Samples Slerp(a, b, t) at t = 0, 1/steps, ..., 1 with one quaternion product per
+// step: the delta (a^-1 b)^(1/steps) is computed once. The product is renormalized
+// every step (no sqrt) and the last step returns b exactly.
+template<typename T>
+struct TSlerpStepper
+{
+    TQuat<T> current, delta, end;
+    int step = 0, steps = 0;
 
-    static Quat FromMatrix3x3(const Matrix3x3& R);
-    Matrix3x3 ToMatrix3x3() const;
+    TSlerpStepper() = default;
+    TSlerpStepper(const TQuat<T>& a, const TQuat<T>& b, int steps);
 
-    static Quat FromAxisAngle(const Vec3& u, double phi);
-    void ToAxisAngle(Vec3& axis, double& angle) const;
+    bool Done() const { return step >= steps; }
+    // Advances one step and returns the new current rotation (b once Done)
+    const TQuat<T>& Next();
+};
 
-    static Quat FromEulerZYX(double yaw, double pitch, double roll);
-    void ToEulerZYX(double& yaw, double& pitch, double& roll) const;
+using Quat = TQuat<double>;
+using Quatf = TQuat<float>;
+using SlerpStepper = TSlerpStepper<double>;
+using SlerpStepperf = TSlerpStepper<float>;
 
-    static Quat RotateFromTo(const Vec3& u, const Vec3& v);
-    static Quat RotateToTarget(const Quat& initialRot, const Quat& finalRot);
-};
\ No newline at end of file
+#if MATH_INLINE_CORE
+#include "Quat.inl"
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+// Inline part of Quat.hpp (see MathConfig.hpp). Included by the header when
+// MATH_INLINE_CORE is 1, and by src/Quat.cpp otherwise.
+
+template<typename T>
+MATH_CONSTEXPR TQuat<T> TQuat<T>::Multiply(const TQuat& b) const
+{
+    const TQuat& a = *this;
+    TQuat q;
+    q.s = a.s * b.s - a.x * b.x - a.y * b.y - a.z * b.z;
+    q.x = a.s * b.x + a.x * b.s + a.y * b.z - a.z * b.y;
+    q.y = a.s * b.y - a.x * b.z + a.y * b.s + a.z * b.x;
+    q.z = a.s * b.z + a.x * b.y - a.y * b.x + a.z * b.s;
+    return q;
+}
@@ -0,0 +1,340 @@
+#pragma once
+#include "Affine3x4.hpp"
+#include "StringTable.hpp"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Local TRS of a node: position, Euler angles in degrees (x = pitch, y = yaw, z = roll)
+// and scale
+class Transform {
+public:
+    Vec3 position = { 0.0, 0.0, 0.0 };
+    Vec3 rotation = { 0.0, 0.0, 0.0 };
+    Vec3 scale = { 1.0, 1.0, 1.0 };
+
+    Transform() {}
+
+    template<typename T = double>
+    TAffine3x4<T> GetLocalAffine() const {
+        const double rad = 3.14159265358979323846 / 180.0;
+
+        // Graus a Radians
+        T radX = static_cast<T>(rotation.x * rad);
+        T radY = static_cast<T>(rotation.y * rad);
+        T radZ = static_cast<T>(rotation.z * rad);
+
+        //Crear la Matriu de Rotacio
+        TMatrix3x3<T> matrot = TMatrix3x3<T>::FromEulerZYX(radY, radX, radZ);
+
+        // Covertir a TRS
+        return TAffine3x4<T>::FromTRS(position.Cast<T>(), matrot, scale.Cast<T>());
+    }
+
+    // T / L let the renderer build float column-major matrices directly
+    template<typename T = double, MatrixLayout L = MatrixLayout::RowMajor>
+    TMatrix4x4<T, L> GetLocalMatrix() const {
+        return GetLocalAffine<T>().template ToMatrix4x4<L>();
+    }
+};
+
+class Scene;
+class GameObject;
+class JobSystem;
+
+// Weak reference to a GameObject: pool slot + generation. The generation of a slot
+// changes when its node is destroyed, so a stale handle resolves to null
+// (Scene::Resolve) instead of to whatever node reuses the slot.
+struct GameObjectHandle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const GameObjectHandle& o) const { return slot == o.slot && generation == o.generation; }
+    bool operator!=(const GameObjectHandle& o) const { return !(*this == o); }
+};
+
+// Iterates over sibling nodes of a Scene (the children of a node, or the roots) as
+// GameObject*. Invalidated by any change of the hierarchy.
+class NodeRange {
+public:
+    class Iterator {
+    public:
+        GameObject* operator*() const;
+        Iterator& operator++();
+        bool operator!=(const Iterator& o) const { return index != o.index; }
+
+    private:
+        friend class NodeRange;
+        Iterator(const Scene* s, std::size_t i) : scene(s), index(i) {}
+        const Scene* scene;
+        std::size_t index;
+    };
+
+    Iterator begin() const { return { scene, first }; }
+    Iterator end() const { return { scene, last }; }
+    bool empty() const { return first == last; }
+
+private:
+    friend class Scene;
+    friend class GameObject;
+    NodeRange(const Scene* s, std::size_t f, std::size_t l) : scene(s), first(f), last(l) {}
+    const Scene* scene;
+    std::size_t first, last;
+};
+
+// Handle to a node of a Scene. The node data lives in the scene arrays; the handle
+// only knows its current index, which the scene updates when nodes move. The handles
+// live in a pool owned by the scene and keep their address for the scene's lifetime,
+// but the slot of a destroyed node is reused: keep a GameObjectHandle, not a pointer,
+// across frames.
+class GameObject {
+public:
+    GameObject(const GameObject&) = delete;
+    GameObject& operator=(const GameObject&) = delete;
+
+    // Construir jerarquia. A child that already had a parent is moved (with its
+    // subtree). Throws std::invalid_argument for a node of another scene or when the
+    // child is this node or one of its ancestors.
+    void AddChild(GameObject* child);
+    // The child becomes a root
+    void RemoveChild(GameObject* child);
+    GameObject* GetParent() const;
+    NodeRange GetChildren() const;
+
+    // Transform. The setters mark the local matrix and the world matrices of the
+    // whole subtree dirty.
+    const Transform& GetTransform() const;
+    void SetTransform(const Transform& t);
+    void SetPosition(const Vec3& position);
+    void SetRotation(const Vec3& eulerDegrees);
+    void SetScale(const Vec3& scale);
+
+    // Cached matrices. GetGlobalAffine brings the whole scene up to date first
+    // (Scene::UpdateWorld), which costs nothing when nothing changed.
+    const Affine3x4& GetLocalAffine();
+    const Affine3x4& GetGlobalAffine();
+
+    template<typename T = double, MatrixLayout L = MatrixLayout::RowMajor>
+    TMatrix4x4<T, L> GetGlobalMatrix() {
+        return GetGlobalAffine().template Cast<T>().template ToMatrix4x4<L>();
+    }
+
+    bool IsLocalDirty() const;
+    bool IsWorldDirty() const;
+
+    // Index in the renderer's mesh table (0 by default)
+    uint32_t GetMesh() const;
+    void SetMesh(uint32_t mesh);
+
+    // Name and tag, interned in the scene's string table (empty by default). Setting
+    // them keeps the lookups of Scene (FindByName, FindAllByTag, ...) up to date.
+    std::string_view GetName() const;
+    void SetName(std::string_view name);
+    std::string_view GetTag() const;
+    void SetTag(std::string_view tag);
+
+    Scene& GetScene() const { return *scene; }
+    // Position in the scene arrays (changes when the hierarchy changes)
+    std::size_t GetIndex() const { return index; }
+    GameObjectHandle GetHandle() const { return { slot, generation }; }
+
+private:
+    friend class Scene;
+    friend class SceneEdit;
+    GameObject() = default;
+
+    static constexpr std::size_t FREE = SIZE_MAX;  // index of an unused slot
+
+    // A string of the node and its position in the scene's list of nodes with that
+    // string (Scene::byName / byTag)
+    struct Label {
+        StringTable::Id id = StringTable::EMPTY;
+        uint32_t position = 0;
+    };
+
+    Scene* scene = nullptr;
+    std::size_t index = FREE;
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+    uint32_t nextFree = UINT32_MAX;
+    Label name, tag;
+};
+
+// Data-oriented scene store. Nodes are kept in depth-first (pre-order) order in
+// parallel arrays, so every parent comes before its children and the subtree of
+// node i is the range [i, i + SubtreeSize(i)). UpdateWorld is then one linear sweep,
+// world[i] = world[parent[i]] * local[i], over the dirty range only.
+//
+// Adding a node as the last one in pre-order (e.g. building a scene depth first) is
+// O(depth). Inserting it anywhere else moves the nodes after it up by one, and
+// destroying a subtree moves them down: O(N - index) either way, in place (the arrays
+// are only reallocated when they grow past their capacity). So creating and destroying
+// nodes is not O(1), only taking and releasing their handles is: the arrays stay in
+// pre-order, without holes, so that UpdateWorld remains one sweep. A reparent reorders
+// the arrays in O(N). Many such edits at once go through a SceneEdit (SceneEdit.hpp),
+// one O(N) pass in all.
+//
+// The GameObject handles come from a pool of fixed-size chunks with a free list:
+// taking or releasing a slot is O(1) and only allocates when a new chunk is needed.
+//
+// Names and tags are interned strings kept with the handles, not in the arrays, so they
+// cost nothing to move. For each string id the scene lists the nodes that use it: the
+// lookups by name or tag are a hash of the string plus the matches, and renaming or
+// destroying a node is O(1) (unnamed nodes are in no list). The table and the lists
+// keep every distinct string used since the last Clear or Load, in use or not.
+class Scene {
+public:
+    Scene() = default;
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    // New node with an identity transform, last child of parent (a root when null)
+    GameObject* CreateObject(GameObject* parent = nullptr);
+    // Moves child (and its subtree) to the end of parent's children, or to the roots.
+    // Same exceptions as GameObject::AddChild.
+    void SetParent(GameObject* child, GameObject* parent);
+    // Inserts a block of new nodes, given in pre-order, as the last descendants of
+    // parent (new roots when null). parents[k] is the index in the block of the parent
+    // of node k (< k), or -1 for parent itself. The new nodes take indices
+    // [result, result + size) and are dirty. Throws std::invalid_argument when the spans
+    // differ in size or the block is not in pre-order.
+    std::size_t InsertNodes(GameObject* parent, std::span<const Transform> transforms,
+        std::span<const int32_t> parents, std::span<const uint32_t> meshes);
+    // Destroys node and its whole subtree. Their handles go stale and their pool slots
+    // are reused by the next CreateObject calls.
+    void Destroy(GameObject* node);
+    // Null for a null, stale or foreign handle
+    GameObject* Resolve(GameObjectHandle handle) const;
+
+    // Lookup by name and tag, exact and case-sensitive. The empty string matches nothing.
+    // FindByName returns any one node with that name, or null; FindAll* append them all.
+    GameObject* FindByName(std::string_view name) const;
+    void FindAllByName(std::string_view name, std::vector<GameObjectHandle>& out) const;
+    void FindAllByTag(std::string_view tag, std::vector<GameObjectHandle>& out) const;
+    // Nodes whose name (tag) starts with prefix, in the order of their names (tags), at
+    // most limit of them. A range of the ordered string table: the cost is the matching
+    // strings, not the size of the scene.
+    void SearchByName(std::string_view prefix, std::vector<GameObjectHandle>& out, std::size_t limit = SIZE_MAX) const;
+    void SearchByTag(std::string_view prefix, std::vector<GameObjectHandle>& out, std::size_t limit = SIZE_MAX) const;
+    const StringTable& Strings() const { return strings; }
+    // Room for n nodes without reallocating the arrays or the pool
+    void Reserve(std::size_t n);
+    // Reserve(n) for the arrays one at a time: each call reallocates the next array
+    // short of n and returns false once they all have room. Spreads a large growth over
+    // several calls (frames), one array copy each.
+    bool ReserveStep(std::size_t n);
+    // Nodes that fit in all the arrays without reallocating
+    std::size_t Capacity() const;
+    // Destroys every node and empties the string table
+    void Clear();
+
+    // Binary snapshot (SceneFile.cpp): the flat arrays as they are in memory, behind a
+    // versioned header, so loading is a mapping plus a few bulk copies. Names and tags
+    // go as indices into the file's own list of strings. Load replaces the whole scene
+    // (all handles go stale, the string table starts over) and leaves every matrix
+    // dirty. Both throw std::runtime_error on I/O errors or a malformed / incompatible
+    // file.
+    void Save(const std::string& path) const;
+    void Load(const std::string& path);
+
+    struct MemoryStats {
+        std::size_t nodes;              // Live nodes
+        std::size_t slots;              // Pool slots (live + free)
+        std::size_t bytesPerNode;       // Arrays + pool slot
+        std::size_t reservedBytes;      // Capacity of the arrays + pool chunks
+        std::size_t poolAllocations;    // Chunks allocated so far
+        std::size_t arrayAllocations;   // Reallocations of the node arrays so far
+    };
+    MemoryStats GetMemoryStats() const;
+
+    std::size_t Size() const { return parent.size(); }
+    NodeRange Roots() const { return { this, 0, Size() }; }
+    GameObject* Object(std::size_t i) const { return object[i]; }
+
+    // Recomputes the dirty locals and world matrices, in index order
+    void UpdateWorld();
+    // Same result (bit for bit) on all the threads of jobs: the subtrees of the dirty
+    // range are cut into contiguous pieces of similar size, their ancestors are updated
+    // first and the pieces then run as jobs. Small updates stay on the calling thread.
+    void UpdateWorld(JobSystem& jobs);
+
+    // SoA views, indexed by GameObject::GetIndex(). World() is up to date after UpdateWorld.
+    std::span<const int32_t> Parents() const { return parent; }
+    std::span<const Transform> Transforms() const { return transform; }
+    std::span<const uint32_t> Meshes() const { return mesh; }
+    std::span<const Affine3x4> Locals() const { return local; }
+    std::span<const Affine3x4> World() const { return world; }
+    // Incremented by every UpdateWorld that recomputes something. WorldVersions()[i] is
+    // the version that last wrote World()[i]: caches of world-space data (the BVH)
+    // compare it with the version they were built at.
+    uint32_t GetWorldVersion() const { return worldVersion; }
+    std::span<const uint32_t> WorldVersions() const { return worldStamp; }
+    // Incremented when nodes are added, destroyed or moved in the arrays, or change mesh:
+    // while it stays the same, index i is the same node with the same mesh
+    uint32_t GetLayoutVersion() const { return layoutVersion; }
+    std::size_t SubtreeSize(std::size_t i) const { return subtreeSize[i]; }
+
+private:
+    friend class GameObject;
+    friend class NodeRange::Iterator;
+    friend class SceneEdit;
+
+    void CheckNode(const GameObject* node, const char* what) const;
+    void AddPoolChunk();
+    GameObject* AllocateObject(std::size_t index);
+    void FreeObject(GameObject* node);
+    void UpdateNode(std::size_t i);
+    void UpdateRange(std::size_t begin, std::size_t end);
+    // World matrix of i from the current transforms, without writing anything
+    Affine3x4 ComputeWorld(std::size_t i) const;
+    void MarkDirty(std::size_t i);
+    // Moves node from the list of its current string in index to the list of id
+    void Relabel(std::vector<std::vector<GameObject*>>& index, GameObject* node, GameObject::Label GameObject::* label,
+        StringTable::Id id);
+    // Empties the string table and the lists by string (no node may still use them)
+    void ClearLabels();
+    void Search(const std::vector<std::vector<GameObject*>>& index, std::string_view prefix,
+        std::vector<GameObjectHandle>& out, std::size_t limit) const;
+    // Rearranges all arrays so that new index k holds old node order[k] (the nodes left
+    // out are dropped). parent must already name the new parents (old indices); the
+    // subtree sizes and the dirty range are rebuilt.
+    void Reorder(const std::vector<std::size_t>& order);
+
+    std::vector<Transform> transform;
+    std::vector<int32_t> parent;            // -1 for roots
+    std::vector<uint32_t> subtreeSize;      // Node included
+    std::vector<uint32_t> mesh;
+    std::vector<Affine3x4> local, world;
+    std::vector<uint8_t> localDirty, worldDirty;
+    std::vector<uint32_t> worldStamp;
+    uint32_t worldVersion = 0;
+    uint32_t layoutVersion = 0;
+    std::vector<GameObject*> object;        // index -> handle
+
+    StringTable strings;
+    std::vector<std::vector<GameObject*>> byName, byTag;   // By string id
+
+    // Handle pool: slot s is pool[s / POOL_CHUNK][s % POOL_CHUNK]
+    static constexpr uint32_t POOL_CHUNK = 256;
+    std::vector<std::unique_ptr<GameObject[]>> pool;
+    uint32_t freeSlot = UINT32_MAX;         // Head of the free list
+    uint32_t slotCount = 0;
+    std::size_t arrayAllocations = 0;
+
+    // Every world-dirty node is in [dirtyBegin, dirtyEnd)
+    std::size_t dirtyBegin = 0, dirtyEnd = 0;
+};
+
+inline GameObject* NodeRange::Iterator::operator*() const
+{
+    return scene->object[index];
+}
+
+inline NodeRange::Iterator& NodeRange::Iterator::operator++()
+{
+    index += scene->subtreeSize[index];
+    return *this;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Scene.hpp"
+
+// Random test hierarchies, for the benchmarks and the demo's test import.
+
+// Node values of RandomHierarchy. Positions, Euler angles and the scale jitter are
+// uniform in [-x, x].
+struct HierarchyShape {
+    double rootSpread = 1.0;        // Positions of the roots
+    double childSpread = 1.0;       // Positions of the other nodes, around their parent
+    double rotation = 30.0;         // Degrees
+    double rootScale = 1.0;         // Uniform scales
+    double childScale = 1.0;
+    double scaleJitter = 0.0;       // Scales times 1 + jitter
+    uint32_t meshes = 0;            // Random mesh in [0, meshes) when not 0
+    std::size_t maxDepth = 24;
+    bool transforms = true;         // False: identity transforms (structure only)
+};
+
+// Appends n nodes built depth first: each one goes up 0 to 2 levels from the previous
+// node and becomes its child (or a root), so every CreateObject appends in pre-order.
+// The same seed and shape give the same nodes.
+void RandomHierarchy(Scene& scene, std::size_t n, unsigned seed, const HierarchyShape& shape = {});
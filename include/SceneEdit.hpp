@@ -0,0 +1,111 @@
+#pragma once
+#include "Scene.hpp"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// A batch of hierarchy edits of a Scene, applied together.
+//
+// Every reparent or insertion in the middle of the scene reorders the flat arrays, an
+// O(N) pass per call (Scene::SetParent). A SceneEdit only records the edits; Apply
+// replays them in order on a linked copy of the hierarchy, in O(1) each (a reparent
+// also walks the ancestors of its destination, to refuse cycles), and then lays out
+// the arrays once in pre-order: O(N + edits) for the whole batch. Nothing touches the
+// scene before Apply, so the edits can be recorded while iterating over it (e.g. from
+// the hierarchy panel).
+//
+// Edits name their nodes by handle. A node destroyed by an earlier edit of the batch,
+// or in the scene since it was recorded, makes Apply fail.
+class SceneEdit {
+public:
+    // What a moved node keeps: its local transform (it follows its new parent, as
+    // Scene::SetParent) or its world transform (its local one is recomputed from the
+    // inverse of the new parent's world matrix)
+    enum class Keep { Local, World };
+
+    explicit SceneEdit(Scene& scene);
+    // Gives back the pool slots of the insertions that were not applied. The batch
+    // must not outlive its scene.
+    ~SceneEdit();
+
+    SceneEdit(const SceneEdit&) = delete;
+    SceneEdit& operator=(const SceneEdit&) = delete;
+
+    // New node, last child of parent (a root when parent is a null handle). The
+    // returned handle names it in later edits of the batch and resolves once Apply is
+    // done.
+    GameObjectHandle Insert(GameObjectHandle parent, const Transform& transform = {}, uint32_t mesh = 0,
+        std::string_view name = {}, std::string_view tag = {});
+    // node and its whole subtree
+    void Destroy(GameObjectHandle node);
+    // node (with its subtree) becomes the last child of parent, or a root
+    void Reparent(GameObjectHandle node, GameObjectHandle parent, Keep keep = Keep::Local);
+    // node (with its subtree) moves just before sibling, under sibling's parent
+    void MoveBefore(GameObjectHandle node, GameObjectHandle sibling, Keep keep = Keep::Local);
+
+    // Applies the edits in the order they were recorded and empties the batch. The
+    // moved and inserted subtrees are left dirty for the next Scene::UpdateWorld; the
+    // handles and GameObject pointers of the other nodes stay valid. Throws
+    // std::invalid_argument, with the scene untouched and the batch discarded, for a
+    // stale handle, a move under the node's own subtree or a node moved before itself.
+    //
+    // Keep::World keeps the world matrix the node had before Apply; it is exact when the
+    // new parent's world matrix has no shear (orthogonal axes, Affine3x4::InverseTRS).
+    // When a node moves more than once the last move decides what it keeps, and nodes
+    // inserted by the batch always keep their local transform.
+    void Apply();
+    // Drops the recorded edits
+    void Clear();
+
+    std::size_t Size() const { return edits.size(); }
+    bool Empty() const { return edits.empty(); }
+
+private:
+    enum class Kind : uint8_t { Insert, Destroy, Reparent, MoveBefore };
+
+    struct Edit {
+        Kind kind;
+        Keep keep;
+        GameObjectHandle node;
+        GameObjectHandle target;        // Parent or sibling
+    };
+
+    // One inserted node
+    struct Added {
+        GameObject* object;             // Reserved pool slot, not in the arrays yet
+        Transform transform;
+        uint32_t mesh;
+        std::string name, tag;
+    };
+
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // The hierarchy as linked lists, over the scene indices then the added nodes, with
+    // the roots as the children of one more node, root
+    struct Links {
+        uint32_t root;
+        std::vector<uint32_t> parent, firstChild, lastChild, next, prev;
+        std::vector<uint8_t> dead;
+        std::vector<uint8_t> moved;         // Scene nodes moved by the batch
+        std::vector<uint8_t> keepWorld;     // Their last move was Keep::World
+    };
+
+    // Node of handle in links, root for a null handle when nullIsRoot. Throws for a
+    // stale handle or a node destroyed by the batch.
+    uint32_t Node(const Links& links, GameObjectHandle handle, bool nullIsRoot) const;
+    static void Unlink(Links& links, uint32_t node);
+    // node becomes the child of parent just before the child before (the last one for NONE)
+    static void Link(Links& links, uint32_t node, uint32_t parent, uint32_t before);
+    // ancestor is node or one of its ancestors
+    static bool IsAncestor(const Links& links, uint32_t ancestor, uint32_t node);
+    // Marks node and its subtree destroyed
+    static void Kill(Links& links, uint32_t node);
+    // Frees the reserved slots of the pending insertions and empties the batch
+    void Discard();
+
+    Scene& scene;
+    std::vector<Edit> edits;
+    std::vector<Added> added;
+    std::unordered_map<uint32_t, uint32_t> addedBySlot;     // Pool slot -> added
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include "Scene.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// One subtree request of a SceneStreamer, shared between the caller, the loader thread
+// and the main loop. The accessors can be polled from any thread.
+class StreamRequest {
+public:
+    enum class State { Queued, Building, Splicing, Done, Failed, Canceled };
+
+    State GetState() const { return state.load(std::memory_order_acquire); }
+    // Nodes of the built subtree (0 until it is built) and nodes already in the scene
+    std::size_t NodeCount() const { return nodeCount.load(std::memory_order_acquire); }
+    std::size_t NodesSpliced() const { return spliced.load(std::memory_order_acquire); }
+    // Set when the state is Failed (the exception of the build function)
+    const std::string& Error() const { return error; }
+
+private:
+    friend class SceneStreamer;
+
+    std::function<void(Scene&)> build;
+    GameObjectHandle parent;
+    bool toRoots = true;
+
+    std::atomic<State> state{ State::Queued };
+    std::atomic<std::size_t> nodeCount{ 0 };
+    std::atomic<std::size_t> spliced{ 0 };
+    std::string error;
+
+    // Built on the loader thread, then only used by the main loop
+    std::unique_ptr<Scene> source;
+    std::vector<GameObjectHandle> placed;   // source index -> node in the target
+};
+
+// Builds detached subtrees on a loader thread (file reads, parsing, allocation) and
+// adds them to a scene from the main loop, a few blocks per frame.
+//
+// The build function fills a Scene of its own that nobody else sees. Update(), called
+// once per frame between two frames, copies the finished ones into the target with
+// Scene::InsertNodes (names and tags are set after each block): a large subtree appears
+// over several frames, always as a valid hierarchy (a pre-order prefix of it is in
+// place). If the parent, or a node already spliced, is destroyed meanwhile the request
+// is canceled.
+//
+// Each block is sized from the time the last ones took, per node inserted and per node
+// moved, to what is left of the budget; a block that would not fit waits for the next
+// frame. Appended blocks (new roots, or under a node at the end of the scene) cost their
+// own nodes. A block under a node in the middle of the scene also moves every node
+// after it: when that move alone would take a good part of the budget, the rest of the
+// subtree goes in one pass, at the start of a frame and alone in it, which costs what a
+// synchronous splice does (one move of the tail) instead of one move per frame.
+// When the built nodes do not fit in the scene arrays they grow geometrically, one array
+// per frame (Scene::ReserveStep), while the blocks fill the room that is left.
+class SceneStreamer {
+public:
+    explicit SceneStreamer(Scene& target);
+    // Waits for the build in progress; queued requests are dropped
+    ~SceneStreamer();
+
+    SceneStreamer(const SceneStreamer&) = delete;
+    SceneStreamer& operator=(const SceneStreamer&) = delete;
+
+    // The built scene becomes the last children of parent (new roots when null).
+    // build runs on the loader thread.
+    std::shared_ptr<const StreamRequest> Request(std::function<void(Scene&)> build, GameObject* parent = nullptr);
+    // Same with a scene file (Scene::Load)
+    std::shared_ptr<const StreamRequest> RequestFile(const std::string& path, GameObject* parent = nullptr);
+
+    // Main loop, between frames: splices built subtrees for about budgetMs (at least one
+    // block when there is work and room; a growth step of the arrays or a one-pass splice
+    // in the middle of the scene can take longer). Returns the time spent, in ms.
+    double Update(double budgetMs);
+
+    struct Progress {
+        std::size_t building;       // Requests queued or in the loader
+        std::size_t splicing;       // Built, not fully in the scene yet
+        std::size_t nodesPending;   // Built nodes not in the scene yet
+        double lastUpdateMs;        // Frame time taken by the last Update
+        double maxUpdateMs;         // Worst Update so far
+    };
+    // Main loop, like Update
+    Progress GetProgress() const;
+
+    // Smallest block, in nodes: a smaller rest waits for the next frame
+    static constexpr std::size_t BLOCK = 256;
+
+private:
+    void LoaderLoop();
+    // Nodes after the point where the next node of r goes in the target
+    std::size_t Tail(const StreamRequest& r) const;
+    // Whether a request with that tail goes in blocks (or the rest in one pass)
+    bool InBlocks(std::size_t tail, double budgetMs) const;
+    // Nodes of the next block of r that fit in budgetMs (0: none, wait for the next
+    // frame); frameStart when nothing was done yet in this Update
+    std::size_t PlanBlock(const StreamRequest& r, std::size_t tail, double budgetMs, bool frameStart) const;
+    // Next count nodes of r; false when r is finished (done or canceled)
+    bool SpliceBlock(StreamRequest& r, std::size_t count);
+    // Drops the source of a finished request; the loader thread frees it
+    void Retire(StreamRequest& r);
+
+    Scene& target;
+
+    // Loader thread
+    std::thread loader;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<StreamRequest>> queued;     // Waiting for the loader
+    std::deque<std::shared_ptr<StreamRequest>> built;      // Waiting for Update
+    std::vector<std::unique_ptr<Scene>> retired;            // Spliced, for the loader to free
+    std::size_t building = 0;
+    bool stop = false;
+
+    // Main loop only
+    std::deque<std::shared_ptr<StreamRequest>> splicing;
+    double lastUpdateMs = 0.0, maxUpdateMs = 0.0;
+    // Measured cost of a block, in ns: per node inserted (with its name and tag) and per
+    // node of the target moved. Start pessimistic; the first blocks correct them.
+    double insertNs = 1000.0, moveNs = 50.0;
+    std::size_t growTo = 0;                 // Capacity the arrays are growing to (0: none)
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+
+// GCC/Clang need a per-function target to use AVX intrinsics without building
+// the whole project with -mavx2. MSVC accepts the intrinsics as they are.
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#else
+#define SIMD_X86 0
+#endif
+
+// SIMD kernels for the hot Matrix4x4 operations, picked at runtime from the
+// CPU features. The scalar kernels are the reference implementation.
+//
+// Accuracy against the scalar reference (u = 2^-53):
+//  - SSE2 performs the same operations in the same order: bit-identical results.
+//  - AVX2 / AVX-512 use FMA, which rounds fewer times. For every element
+//    C_ij = sum_k A_ik * B_kj they satisfy |C_simd - C_ref| <= 8u * sum_k |A_ik * B_kj|,
+//    i.e. at most 4 ULP when the products don't cancel each other.
+namespace Simd
+{
+    enum class Level
+    {
+        Scalar = 0,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    // Best level supported by both the CPU and the OS
+    Level Detect();
+
+    // Level used by the kernels. Defaults to Detect().
+    Level Active();
+
+    // Forces a level (benchmarks, comparisons). Clamped to Detect(). Kernels running on
+    // other threads meanwhile use either the old level or the new one, whole.
+    void SetActive(Level level);
+
+    const char* Name(Level level);
+
+    // Row-major: m[row * 4 + col]
+    void Mat4Mul(const double* a, const double* b, double* out);
+    void Mat4MulVec4(const double* m, const double* v, double* out);
+    // Single precision, same row-major layout
+    void Mat4MulF(const float* a, const float* b, float* out);
+    // Affine 3x4 (top three rows of a 4x4, bottom row implicitly 0 0 0 1)
+    void Affine3x4Mul(const double* a, const double* b, double* out);
+    // General 4x4 inverse, any storage order. Returns det(M); out is only meaningful when
+    // it is non-zero (1 / det is applied as is). The AVX2 kernel uses the blockwise 2x2
+    // method and differs from the cofactor reference by a few ULP times the condition number.
+    double Mat4Inverse(const double* m, double* out);
+
+    // Bulk transforms over SoA arrays. Outputs may alias the inputs.
+    // Affine: o = M * (x, y, z, w) ignoring the bottom row of M, no divide.
+    // w = 1 for points, w = 0 for vectors.
+    void TransformAffineSoA(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n, double w);
+    // Projective: o = M * (x, y, z, 1), divided by the resulting w when it isn't 0
+    void TransformProjectiveSoA(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n);
+    // Same over packed (x, y, z) triplets
+    void TransformAffineAoS(const double* m, const double* in, double* out, std::size_t n, double w);
+    void TransformProjectiveAoS(const double* m, const double* in, double* out, std::size_t n);
+
+    // Frustum test of n boxes [(x0, y0, z0), (x1, y1, z1)] (SoA). planes holds six planes
+    // (nx, ny, nz, d), inside where n.p + d >= 0. out[i] is 0 when box i is outside a
+    // plane, 2 when it is inside all of them and 1 otherwise (the values of Containment).
+    // No FMA: every level matches TFrustum::Classify exactly.
+    void ClassifyBoxesSoA(const double* planes, const double* x0, const double* y0, const double* z0,
+        const double* x1, const double* y1, const double* z1, unsigned char* out, std::size_t n);
+
+    // Nearest of n triangles hit by the ray (ox, oy, oz, dx, dy, dz), from either side.
+    // tri holds nine arrays of n values back to back: v0 x, y, z, then the edges
+    // e1 = v1 - v0 and e2 = v2 - v0. On entry t is the farthest distance to accept; the
+    // result is the index of the triangle (the lowest on ties) with t set to its
+    // distance, or n with t unchanged. No FMA: every level gives the same answer.
+    std::size_t IntersectRayTrianglesSoA(const double* ray, const double* tri, std::size_t n, double& t);
+
+    // Reference implementation
+    void Mat4MulScalar(const double* a, const double* b, double* out);
+    void Mat4MulVec4Scalar(const double* m, const double* v, double* out);
+    void Mat4MulFScalar(const float* a, const float* b, float* out);
+    void Affine3x4MulScalar(const double* a, const double* b, double* out);
+    double Mat4InverseScalar(const double* m, double* out);
+    float Mat4InverseScalar(const float* m, float* out);
+    void TransformAffineSoAScalar(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n, double w);
+    void TransformProjectiveSoAScalar(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n);
+    void TransformAffineAoSScalar(const double* m, const double* in, double* out, std::size_t n, double w);
+    void TransformProjectiveAoSScalar(const double* m, const double* in, double* out, std::size_t n);
+    void ClassifyBoxesSoAScalar(const double* planes, const double* x0, const double* y0, const double* z0,
+        const double* x1, const double* y1, const double* z1, unsigned char* out, std::size_t n);
+    std::size_t IntersectRayTrianglesSoAScalar(const double* ray, const double* tri, std::size_t n, double& t);
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Interned strings: every distinct string is stored once and named by a small dense id,
+// so names compare and hash as integers and can index plain arrays. Strings are not
+// counted: one stays in the table after its last user is gone, until Clear drops them
+// all. Id EMPTY is the empty string. The views returned by Get stay valid until the
+// next Clear.
+//
+// The hash from string to id is open addressing (linear probing) over an array of
+// (id, hash) pairs: a probe only reads strings whose hash matches, and growing does
+// not hash again. The table also keeps its ids in the order of their strings, so the
+// strings that start with a prefix are a range found in O(log n). The strings interned
+// since the last prefix search are sorted and merged in by the next one, so interning
+// stays a hash insertion. Ordering compares the first bytes of the strings as integers
+// before it reads them.
+class StringTable {
+public:
+    using Id = uint32_t;
+    static constexpr Id EMPTY = 0;
+
+    StringTable();
+    // The maps hold views into strings
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+
+    // Id of s, added the first time
+    Id Intern(std::string_view s);
+    // Id of s without adding it: false when s was never interned
+    bool Find(std::string_view s, Id& id) const;
+    std::string_view Get(Id id) const { return strings[id]; }
+    // Strings interned so far, the empty one included: ids are in [0, Size())
+    std::size_t Size() const { return strings.size(); }
+    // Back to the empty string only; the ids handed out so far are no longer valid
+    void Clear();
+
+    // f(id) for the strings that start with prefix, in lexicographic order, while f
+    // returns true. Not thread-safe: it may sort the strings interned since the last
+    // call.
+    template<typename F>
+    void ForEachWithPrefix(std::string_view prefix, F&& f) const;
+
+private:
+    static constexpr Id FREE = UINT32_MAX;  // Unused bucket
+
+    struct Bucket {
+        Id id = FREE;
+        uint32_t hash = 0;
+    };
+
+    // First 8 bytes of s, big-endian, 0 past its end: a < b when Key(a) < Key(b)
+    static uint64_t Key(std::string_view s);
+    bool Less(Id a, Id b) const;
+    // Bucket of s, or the free one where it would go
+    std::size_t Probe(std::string_view s, uint32_t hash) const;
+    void Grow();
+    void SortPending() const;
+
+    std::deque<std::string> strings;    // By id; a deque never moves its elements
+    std::vector<uint64_t> keys;         // By id
+    std::vector<Bucket> buckets;        // Power of two, at most half full
+    // Ids by string: [0, sortedCount) in order, the rest in the order they came in
+    mutable std::vector<Id> sorted;
+    mutable std::size_t sortedCount = 0;
+};
+
+template<typename F>
+void StringTable::ForEachWithPrefix(std::string_view prefix, F&& f) const
+{
+    SortPending();
+    const uint64_t key = Key(prefix);
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), prefix, [&](Id id, std::string_view p) {
+        return keys[id] != key ? keys[id] < key : std::string_view(strings[id]) < p;
+    });
+    for (; it != sorted.end() && std::string_view(strings[*it]).starts_with(prefix); ++it)
+        if (!f(*it)) return;
+}
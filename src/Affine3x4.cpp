@@ -0,0 +1,139 @@
+#include "Affine3x4.hpp"
+#include <stdexcept>
+#include <string>
+
+#if !MATH_INLINE_CORE
+#include "Affine3x4.inl"
+#endif
+
+template<typename T>
+TAffine3x4<T> TAffine3x4<T>::Rotate(const TQuat<T>& q)
+{
+    return Rotate(q.ToMatrix3x3());
+}
+
+template<typename T>
+TAffine3x4<T> TAffine3x4<T>::FromTRS(const TVec3<T>& t, const TQuat<T>& q, const TVec3<T>& s)
+{
+    return FromTRS(t, q.ToMatrix3x3(), s);
+}
+
+template<typename T>
+TVec3<T> TAffine3x4<T>::GetScale() const
+{
+    TVec3<T> X(At(0, 0), At(1, 0), At(2, 0));
+    TVec3<T> Y(At(0, 1), At(1, 1), At(2, 1));
+    TVec3<T> Z(At(0, 2), At(1, 2), At(2, 2));
+    return { X.Norm(), Y.Norm(), Z.Norm() };
+}
+
+template<typename T>
+TMatrix3x3<T> TAffine3x4<T>::GetRotation() const
+{
+    // Columns divided by their length; zero-scale columns stay 0
+    TMatrix3x3<T> M;
+    const TVec3<T> s = GetScale();
+    const T scales[3] = { s.x, s.y, s.z };
+    for (std::size_t j = 0; j < 3; ++j) {
+        if (scales[j] == T(0)) continue;
+        const T inv = T(1) / scales[j];
+        for (std::size_t i = 0; i < 3; ++i) {
+            M.At(i, j) = At(i, j) * inv;
+        }
+    }
+    return M;
+}
+
+template<typename T>
+TQuat<T> TAffine3x4<T>::GetRotationQuat() const
+{
+    return TQuat<T>::FromMatrix3x3(GetRotation());
+}
+
+// ------------------ Decompose ---------------------
+
+template<typename T>
+bool TAffine3x4<T>::Decompose(TVec3<T>& t, TQuat<T>& q, TVec3<T>& s, DecomposeMode mode, TVec3<T>* shear) const
+{
+    t = GetTranslation();
+
+    TVec3<T> c0{ At(0, 0), At(1, 0), At(2, 0) };
+    TVec3<T> c1{ At(0, 1), At(1, 1), At(2, 1) };
+    TVec3<T> c2{ At(0, 2), At(1, 2), At(2, 2) };
+    TVec3<T> h{ 0, 0, 0 };
+    s = { c0.Norm(), c1.Norm(), c2.Norm() };
+    if (shear) *shear = h;
+
+    if (s.x == T(0) || s.y == T(0) || s.z == T(0)) {
+        q = {};
+        return false;
+    }
+
+    c0 = { c0.x / s.x, c0.y / s.x, c0.z / s.x };
+    if (mode == DecomposeMode::Shear)
+    {
+        // Gram-Schmidt: [c0 c1 c2] = R * U, with U upper triangular = H * S
+        h.x = TVec3<T>::Dot(c0, c1);
+        c1 = { c1.x - h.x * c0.x, c1.y - h.x * c0.y, c1.z - h.x * c0.z };
+        s.y = c1.Norm();
+
+        h.y = TVec3<T>::Dot(c0, c2);
+        c2 = { c2.x - h.y * c0.x, c2.y - h.y * c0.y, c2.z - h.y * c0.z };
+        if (s.y == T(0)) {
+            q = {};
+            return false;
+        }
+        c1 = { c1.x / s.y, c1.y / s.y, c1.z / s.y };
+
+        h.z = TVec3<T>::Dot(c1, c2);
+        c2 = { c2.x - h.z * c1.x, c2.y - h.z * c1.y, c2.z - h.z * c1.z };
+        s.z = c2.Norm();
+        if (s.z == T(0)) {
+            q = {};
+            return false;
+        }
+
+        // U(0,1) = H_xy * s.y, U(0,2) = H_xz * s.z, U(1,2) = H_yz * s.z
+        h = { h.x / s.y, h.y / s.z, h.z / s.z };
+    }
+    else
+    {
+        c1 = { c1.x / s.y, c1.y / s.y, c1.z / s.y };
+    }
+    c2 = { c2.x / s.z, c2.y / s.z, c2.z / s.z };
+
+    // Mirrored basis: move the reflection into the x scale so R is a proper rotation.
+    // In Shear mode this flips row 0 of U, i.e. H_xy and H_xz.
+    if (mode != DecomposeMode::Fast && TVec3<T>::Dot(c0, TVec3<T>::Cross(c1, c2)) < T(0))
+    {
+        s.x = -s.x;
+        c0 = { -c0.x, -c0.y, -c0.z };
+        h.x = -h.x;
+        h.y = -h.y;
+    }
+
+    TMatrix3x3<T> R;
+    R.At(0, 0) = c0.x; R.At(0, 1) = c1.x; R.At(0, 2) = c2.x;
+    R.At(1, 0) = c0.y; R.At(1, 1) = c1.y; R.At(1, 2) = c2.y;
+    R.At(2, 0) = c0.z; R.At(2, 1) = c1.z; R.At(2, 2) = c2.z;
+    q = TQuat<T>::FromMatrix3x3Unchecked(R);
+    if (shear) *shear = h;
+    return true;
+}
+
+template<typename T>
+std::size_t TAffine3x4<T>::DecomposeBatch(std::span<const TAffine3x4> m, std::span<TVec3<T>> t,
+    std::span<TQuat<T>> q, std::span<TVec3<T>> s, DecomposeMode mode)
+{
+    if (t.size() != m.size() || q.size() != m.size() || s.size() != m.size()) {
+        throw std::invalid_argument("DecomposeBatch: input and output sizes differ");
+    }
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < m.size(); ++i) {
+        if (!m[i].Decompose(t[i], q[i], s[i], mode)) ++failed;
+    }
+    return failed;
+}
+
+template struct TAffine3x4<float>;
+template struct TAffine3x4<double>;
@@ -0,0 +1,625 @@
+#include "BVH.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr int BINS = 16;
+
+struct BuildItem {
+    AABB box;
+    Vec3 center;
+    uint32_t index;     // In the scene
+};
+
+double Axis(const Vec3& v, int axis)
+{
+    return (axis == 0) ? v.x : (axis == 1) ? v.y : v.z;
+}
+
+bool SameBox(const AABB& a, const AABB& b)
+{
+    return a.min.x == b.min.x && a.min.y == b.min.y && a.min.z == b.min.z
+        && a.max.x == b.max.x && a.max.y == b.max.y && a.max.z == b.max.z;
+}
+
+// Reorders items[begin, end) into two non-empty halves and returns where the second
+// starts. Centers are put in BINS bins along the axis where they spread most and the
+// cut between bins with the smallest SAH cost (count * area on each side) wins.
+std::size_t Split(std::vector<BuildItem>& items, std::size_t begin, std::size_t end)
+{
+    AABB centers;
+    for (std::size_t k = begin; k < end; ++k) centers = centers.Merge(items[k].center);
+    const Vec3 spread{ centers.max.x - centers.min.x, centers.max.y - centers.min.y, centers.max.z - centers.min.z };
+    const int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z) ? 1 : 2;
+    const double lo = Axis(centers.min, axis);
+    const double extent = Axis(spread, axis);
+    // All the centers in one point: any halves will do
+    if (!(extent > 0.0)) return begin + (end - begin) / 2;
+    const double scale = BINS / extent;
+    auto binOf = [&](const BuildItem& it) {
+        return std::min(BINS - 1, static_cast<int>((Axis(it.center, axis) - lo) * scale));
+    };
+
+    AABB box[BINS];
+    std::size_t count[BINS] = {};
+    for (std::size_t k = begin; k < end; ++k)
+    {
+        const int b = binOf(items[k]);
+        box[b] = box[b].Merge(items[k].box);
+        ++count[b];
+    }
+
+    double rightArea[BINS];
+    std::size_t rightCount[BINS];
+    AABB acc;
+    std::size_t n = 0;
+    for (int b = BINS - 1; b > 0; --b)
+    {
+        acc = acc.Merge(box[b]);
+        n += count[b];
+        rightArea[b] = acc.SurfaceArea();
+        rightCount[b] = n;
+    }
+    // The first and last bins are not empty, so some cut has items on both sides
+    double bestCost = AABB::INF;
+    int bestBin = 0;
+    acc = AABB{};
+    n = 0;
+    for (int b = 0; b < BINS - 1; ++b)
+    {
+        acc = acc.Merge(box[b]);
+        n += count[b];
+        if (n == 0 || rightCount[b + 1] == 0) continue;
+        const double cost = n * acc.SurfaceArea() + rightCount[b + 1] * rightArea[b + 1];
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            bestBin = b;
+        }
+    }
+
+    const auto mid = std::partition(items.begin() + begin, items.begin() + end,
+        [&](const BuildItem& it) { return binOf(it) <= bestBin; });
+    return static_cast<std::size_t>(mid - items.begin());
+}
+
+}
+
+void BVH::ComputeWorldBounds(const Scene& scene, std::span<const AABB> meshBounds, std::span<AABB> out)
+{
+    if (out.size() != scene.Size())
+        throw std::invalid_argument("BVH::ComputeWorldBounds: out must have one box per node");
+    const std::span<const Affine3x4> world = scene.World();
+    const std::span<const uint32_t> mesh = scene.Meshes();
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i] = (mesh[i] < meshBounds.size()) ? meshBounds[mesh[i]].Transformed(world[i]) : AABB{};
+}
+
+uint32_t BVH::AllocateNode()
+{
+    if (freeNode == NONE)
+    {
+        nodes.emplace_back();
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+    const uint32_t n = freeNode;
+    freeNode = nodes[n].parent;
+    nodes[n] = Node{};
+    return n;
+}
+
+void BVH::FreeNode(uint32_t n)
+{
+    nodes[n] = Node{};
+    nodes[n].parent = freeNode;
+    freeNode = n;
+}
+
+uint32_t BVH::AddLeaf(const AABB& box, GameObjectHandle object, uint32_t mesh)
+{
+    const uint32_t leaf = AllocateNode();
+    Node& node = nodes[leaf];
+    node.box = box;
+    node.object = object;
+    if (object.slot >= slots.size()) slots.resize(object.slot + 1);
+    slots[object.slot] = { leaf, object.generation, mesh, pass };
+    ++leafCount;
+    return leaf;
+}
+
+void BVH::InsertLeaf(uint32_t leaf)
+{
+    preOrder = false;
+    if (root == NONE)
+    {
+        root = leaf;
+        nodes[leaf].parent = NONE;
+        return;
+    }
+
+    // Walk down to the sibling that makes the tree grow least (Box2D's heuristic): stop
+    // at a node when pairing the leaf with it is cheaper than going into either child
+    const AABB box = nodes[leaf].box;
+    uint32_t sibling = root;
+    while (!nodes[sibling].IsLeaf())
+    {
+        const Node& n = nodes[sibling];
+        const double combined = n.box.Merge(box).SurfaceArea();
+        const double cost = 2.0 * combined;
+        const double inherited = 2.0 * (combined - n.box.SurfaceArea());
+        auto descendCost = [&](uint32_t c) {
+            const double merged = nodes[c].box.Merge(box).SurfaceArea();
+            return inherited + (nodes[c].IsLeaf() ? merged : merged - nodes[c].box.SurfaceArea());
+        };
+        const double costLeft = descendCost(n.left);
+        const double costRight = descendCost(n.right);
+        if (cost < costLeft && cost < costRight) break;
+        sibling = (costLeft < costRight) ? n.left : n.right;
+    }
+
+    const uint32_t oldParent = nodes[sibling].parent;
+    const uint32_t p = AllocateNode();
+    nodes[p].parent = oldParent;
+    nodes[p].left = sibling;
+    nodes[p].right = leaf;
+    nodes[p].box = nodes[sibling].box.Merge(box);
+    nodes[p].height = nodes[sibling].height + 1;
+    nodes[sibling].parent = p;
+    nodes[leaf].parent = p;
+    if (oldParent == NONE) root = p;
+    else if (nodes[oldParent].left == sibling) nodes[oldParent].left = p;
+    else nodes[oldParent].right = p;
+    FixAncestors(p);
+}
+
+void BVH::RemoveLeaf(uint32_t leaf)
+{
+    preOrder = false;
+    if (leaf == root)
+    {
+        root = NONE;
+        return;
+    }
+    // The sibling takes the place of the parent
+    const uint32_t p = nodes[leaf].parent;
+    const uint32_t grandParent = nodes[p].parent;
+    const uint32_t sibling = (nodes[p].left == leaf) ? nodes[p].right : nodes[p].left;
+    nodes[sibling].parent = grandParent;
+    if (grandParent == NONE) root = sibling;
+    else
+    {
+        if (nodes[grandParent].left == p) nodes[grandParent].left = sibling;
+        else nodes[grandParent].right = sibling;
+        FixAncestors(sibling);
+    }
+    FreeNode(p);
+}
+
+uint32_t BVH::Balance(uint32_t a)
+{
+    Node& A = nodes[a];
+    if (A.IsLeaf() || A.height < 2) return a;
+    const int balance = static_cast<int>(nodes[A.right].height) - static_cast<int>(nodes[A.left].height);
+    if (balance >= -1 && balance <= 1) return a;
+
+    // c, the taller child, takes the place of a; a keeps the other child and takes the
+    // shorter child of c
+    const bool rightUp = balance > 0;
+    const uint32_t c = rightUp ? A.right : A.left;
+    const uint32_t b = rightUp ? A.left : A.right;
+    Node& C = nodes[c];
+    const bool firstTaller = nodes[C.left].height > nodes[C.right].height;
+    const uint32_t keep = firstTaller ? C.left : C.right;
+    const uint32_t give = firstTaller ? C.right : C.left;
+
+    C.parent = A.parent;
+    A.parent = c;
+    if (C.parent == NONE) root = c;
+    else if (nodes[C.parent].left == a) nodes[C.parent].left = c;
+    else nodes[C.parent].right = c;
+
+    C.left = a;
+    C.right = keep;
+    if (rightUp) A.right = give;
+    else A.left = give;
+    nodes[give].parent = a;
+
+    A.box = nodes[b].box.Merge(nodes[give].box);
+    A.height = 1 + std::max(nodes[b].height, nodes[give].height);
+    C.box = A.box.Merge(nodes[keep].box);
+    C.height = 1 + std::max(A.height, nodes[keep].height);
+    return c;
+}
+
+void BVH::FixAncestors(uint32_t n)
+{
+    for (uint32_t i = nodes[n].parent; i != NONE; i = nodes[i].parent)
+    {
+        i = Balance(i);
+        Node& node = nodes[i];
+        node.height = 1 + std::max(nodes[node.left].height, nodes[node.right].height);
+        node.box = nodes[node.left].box.Merge(nodes[node.right].box);
+    }
+}
+
+void BVH::RefitAncestors(uint32_t n)
+{
+    for (uint32_t i = nodes[n].parent; i != NONE; i = nodes[i].parent)
+    {
+        const AABB box = nodes[nodes[i].left].box.Merge(nodes[nodes[i].right].box);
+        if (SameBox(box, nodes[i].box)) break;
+        nodes[i].box = box;
+    }
+}
+
+void BVH::RefitAll()
+{
+    if (root == NONE) return;
+    if (preOrder)
+    {
+        for (std::size_t k = nodes.size(); k-- > 0; )
+        {
+            Node& n = nodes[k];
+            if (!n.IsLeaf()) n.box = nodes[n.left].box.Merge(nodes[n.right].box);
+        }
+        return;
+    }
+    // Pre-order, then backwards: every node comes after its children
+    std::vector<uint32_t> order;
+    order.reserve(nodes.size());
+    order.push_back(root);
+    for (std::size_t k = 0; k < order.size(); ++k)
+    {
+        const Node& n = nodes[order[k]];
+        if (n.IsLeaf()) continue;
+        order.push_back(n.left);
+        order.push_back(n.right);
+    }
+    for (std::size_t k = order.size(); k-- > 0; )
+    {
+        Node& n = nodes[order[k]];
+        if (!n.IsLeaf()) n.box = nodes[n.left].box.Merge(nodes[n.right].box);
+    }
+}
+
+void BVH::RefitChanged(const std::vector<uint32_t>& changed)
+{
+    // Past a few changed leaves the walks up would overlap: one pass over the whole tree
+    if (changed.size() > leafCount / 8) RefitAll();
+    else for (uint32_t leaf : changed) RefitAncestors(leaf);
+}
+
+void BVH::Clear()
+{
+    nodes.clear();
+    slots.clear();
+    leafOfIndex.clear();
+    root = NONE;
+    freeNode = NONE;
+    leafCount = 0;
+    preOrder = false;
+    scene = nullptr;
+}
+
+void BVH::Build(const Scene& s, std::span<const AABB> meshBounds)
+{
+    Clear();
+    scene = &s;
+    syncedVersion = s.GetWorldVersion();
+    syncedLayout = s.GetLayoutVersion();
+    ++pass;
+
+    const std::span<const Affine3x4> world = s.World();
+    const std::span<const uint32_t> mesh = s.Meshes();
+    std::vector<BuildItem> items;
+    items.reserve(s.Size());
+    for (std::size_t i = 0; i < s.Size(); ++i)
+    {
+        if (mesh[i] >= meshBounds.size() || meshBounds[mesh[i]].IsEmpty()) continue;
+        const AABB box = meshBounds[mesh[i]].Transformed(world[i]);
+        items.push_back({ box, box.Center(), static_cast<uint32_t>(i) });
+    }
+    nodes.reserve(2 * items.size());
+    leafOfIndex.assign(s.Size(), NONE);
+
+    // Top down with an explicit stack. A node is always allocated before its children,
+    // so the inner boxes can then be filled in one backward pass.
+    struct Task {
+        std::size_t begin, end;
+        uint32_t parent;
+        bool left;
+    };
+    std::vector<Task> stack;
+    if (!items.empty()) stack.push_back({ 0, items.size(), NONE, true });
+    while (!stack.empty())
+    {
+        const Task task = stack.back();
+        stack.pop_back();
+
+        uint32_t n;
+        if (task.end - task.begin == 1)
+        {
+            const BuildItem& it = items[task.begin];
+            n = AddLeaf(it.box, s.Object(it.index)->GetHandle(), mesh[it.index]);
+            leafOfIndex[it.index] = n;
+        }
+        else
+        {
+            n = AllocateNode();
+            const std::size_t mid = Split(items, task.begin, task.end);
+            stack.push_back({ mid, task.end, n, false });
+            stack.push_back({ task.begin, mid, n, true });
+        }
+
+        nodes[n].parent = task.parent;
+        if (task.parent == NONE) root = n;
+        else if (task.left) nodes[task.parent].left = n;
+        else nodes[task.parent].right = n;
+    }
+    for (std::size_t k = nodes.size(); k-- > 0; )
+    {
+        Node& n = nodes[k];
+        if (n.IsLeaf()) continue;
+        n.box = nodes[n.left].box.Merge(nodes[n.right].box);
+        n.height = 1 + std::max(nodes[n.left].height, nodes[n.right].height);
+    }
+    preOrder = true;
+
+    lastUpdated = lastInserted = leafCount;
+    lastRemoved = 0;
+    lastRebuilt = true;
+}
+
+void BVH::Refit(const Scene& s, std::span<const AABB> meshBounds)
+{
+    if (scene != &s)
+    {
+        Build(s, meshBounds);
+        return;
+    }
+    ++pass;
+
+    const std::span<const Affine3x4> world = s.World();
+    const std::span<const uint32_t> mesh = s.Meshes();
+    const std::span<const uint32_t> stamp = s.WorldVersions();
+    // Wrap-safe "written after the last sync"
+    auto moved = [&](std::size_t i) { return static_cast<int32_t>(stamp[i] - syncedVersion) > 0; };
+    std::vector<uint32_t> changed;
+    auto update = [&](uint32_t leaf, std::size_t i) {
+        Node& node = nodes[leaf];
+        const AABB box = meshBounds[mesh[i]].Transformed(world[i]);
+        if (SameBox(box, node.box)) return;
+        node.box = box;
+        changed.push_back(leaf);
+    };
+
+    // Same nodes at the same indices: only the stamps need a look
+    if (s.GetLayoutVersion() == syncedLayout)
+    {
+        for (std::size_t i = 0; i < s.Size(); ++i)
+            if (moved(i) && leafOfIndex[i] != NONE) update(leafOfIndex[i], i);
+        syncedVersion = s.GetWorldVersion();
+        RefitChanged(changed);
+        lastUpdated = changed.size();
+        lastInserted = lastRemoved = 0;
+        lastRebuilt = false;
+        return;
+    }
+
+    // Match the nodes with their leaves. A leaf that is not found (its node was
+    // destroyed or lost its mesh) keeps an old pass.
+    std::vector<uint32_t> added;
+    std::size_t found = 0;
+    leafOfIndex.assign(s.Size(), NONE);
+    for (std::size_t i = 0; i < s.Size(); ++i)
+    {
+        const uint32_t m = mesh[i];
+        if (m >= meshBounds.size() || meshBounds[m].IsEmpty()) continue;
+        const GameObjectHandle h = s.Object(i)->GetHandle();
+        SlotLeaf* e = (h.slot < slots.size()) ? &slots[h.slot] : nullptr;
+        if (!e || e->leaf == NONE || e->generation != h.generation)
+        {
+            added.push_back(static_cast<uint32_t>(i));
+            continue;
+        }
+        e->seen = pass;
+        leafOfIndex[i] = e->leaf;
+        ++found;
+        if (!moved(i) && e->mesh == m) continue;
+        e->mesh = m;
+        update(e->leaf, i);
+    }
+
+    const std::size_t removed = leafCount - found;
+    if (added.size() + removed > leafCount / 2)
+    {
+        Build(s, meshBounds);
+        return;
+    }
+    syncedVersion = s.GetWorldVersion();
+    syncedLayout = s.GetLayoutVersion();
+
+    if (removed > 0)
+    {
+        for (SlotLeaf& e : slots)
+        {
+            if (e.leaf == NONE || e.seen == pass) continue;
+            RemoveLeaf(e.leaf);
+            FreeNode(e.leaf);
+            e.leaf = NONE;
+            --leafCount;
+        }
+    }
+    RefitChanged(changed);
+    for (uint32_t i : added)
+    {
+        const AABB box = meshBounds[mesh[i]].Transformed(world[i]);
+        const uint32_t leaf = AddLeaf(box, s.Object(i)->GetHandle(), mesh[i]);
+        InsertLeaf(leaf);
+        leafOfIndex[i] = leaf;
+    }
+
+    lastUpdated = changed.size();
+    lastInserted = added.size();
+    lastRemoved = removed;
+    lastRebuilt = false;
+}
+
+void BVH::CollectLeaves(uint32_t n, std::vector<GameObjectHandle>& out) const
+{
+    std::vector<uint32_t> stack{ n };
+    while (!stack.empty())
+    {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (node.IsLeaf()) out.push_back(node.object);
+        else
+        {
+            stack.push_back(node.right);
+            stack.push_back(node.left);
+        }
+    }
+}
+
+void BVH::QueryFrustum(const Frustum& frustum, std::vector<GameObjectHandle>& out) const
+{
+    if (root == NONE) return;
+    // Each node only tests the planes its parent straddles
+    struct Entry {
+        uint32_t node;
+        unsigned planes;
+    };
+    std::vector<Entry> stack{ { root, Frustum::ALL_PLANES } };
+    while (!stack.empty())
+    {
+        Entry e = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[e.node];
+        const Containment c = frustum.Classify(node.box, e.planes);
+        if (c == Containment::Outside) continue;
+        if (c == Containment::Inside) CollectLeaves(e.node, out);
+        else if (node.IsLeaf()) out.push_back(node.object);
+        else
+        {
+            stack.push_back({ node.right, e.planes });
+            stack.push_back({ node.left, e.planes });
+        }
+    }
+}
+
+void BVH::QueryAABB(const AABB& box, std::vector<GameObjectHandle>& out) const
+{
+    if (root == NONE) return;
+    std::vector<uint32_t> stack{ root };
+    while (!stack.empty())
+    {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!node.box.Overlaps(box)) continue;
+        if (node.IsLeaf()) out.push_back(node.object);
+        else
+        {
+            stack.push_back(node.right);
+            stack.push_back(node.left);
+        }
+    }
+}
+
+void BVH::QuerySphere(const Sphere& sphere, std::vector<GameObjectHandle>& out) const
+{
+    if (root == NONE) return;
+    std::vector<uint32_t> stack{ root };
+    while (!stack.empty())
+    {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!sphere.Overlaps(node.box)) continue;
+        if (node.IsLeaf()) out.push_back(node.object);
+        else
+        {
+            stack.push_back(node.right);
+            stack.push_back(node.left);
+        }
+    }
+}
+
+bool BVH::Raycast(const Ray& ray, double tMax, RayHit& hit) const
+{
+    return Raycast(ray, tMax, hit, nullptr);
+}
+
+bool BVH::Raycast(const Ray& ray, double tMax, RayHit& hit, const RayFilter& filter) const
+{
+    double t;
+    if (root == NONE || !ray.Intersects(nodes[root].box, tMax, t)) return false;
+
+    // Nearest child first; a node entered after the best hit so far is skipped
+    struct Entry {
+        uint32_t node;
+        double t;
+    };
+    std::vector<Entry> stack{ { root, t } };
+    double best = tMax;
+    bool found = false;
+    while (!stack.empty())
+    {
+        const Entry e = stack.back();
+        stack.pop_back();
+        if (e.t > best) continue;
+        const Node& node = nodes[e.node];
+        if (node.IsLeaf())
+        {
+            double exact = best;
+            if (!filter) exact = e.t;
+            else if (!filter(node.object, e.t, exact)) continue;
+            best = exact;
+            hit = { node.object, exact };
+            found = true;
+            continue;
+        }
+        double tLeft, tRight;
+        const bool hitLeft = ray.Intersects(nodes[node.left].box, best, tLeft);
+        const bool hitRight = ray.Intersects(nodes[node.right].box, best, tRight);
+        if (hitLeft && hitRight)
+        {
+            const bool leftFirst = tLeft <= tRight;
+            stack.push_back(leftFirst ? Entry{ node.right, tRight } : Entry{ node.left, tLeft });
+            stack.push_back(leftFirst ? Entry{ node.left, tLeft } : Entry{ node.right, tRight });
+        }
+        else if (hitLeft) stack.push_back({ node.left, tLeft });
+        else if (hitRight) stack.push_back({ node.right, tRight });
+    }
+    return found;
+}
+
+AABB BVH::Bounds() const
+{
+    return (root == NONE) ? AABB{} : nodes[root].box;
+}
+
+BVH::Stats BVH::GetStats() const
+{
+    // Every inner node has two children
+    return { leafCount, leafCount ? 2 * leafCount - 1 : 0, lastUpdated, lastInserted, lastRemoved, lastRebuilt };
+}
+
+BVH::Quality BVH::GetQuality() const
+{
+    Quality q{};
+    if (root == NONE) return q;
+    const double rootArea = nodes[root].box.SurfaceArea();
+    std::vector<std::pair<uint32_t, std::size_t>> stack{ { root, 1 } };
+    while (!stack.empty())
+    {
+        const auto [n, depth] = stack.back();
+        stack.pop_back();
+        q.height = std::max(q.height, depth);
+        const Node& node = nodes[n];
+        if (node.IsLeaf()) continue;
+        if (rootArea > 0.0) q.sahCost += node.box.SurfaceArea() / rootArea;
+        stack.push_back({ node.left, depth + 1 });
+        stack.push_back({ node.right, depth + 1 });
+    }
+    return q;
+}
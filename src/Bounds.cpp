@@ -0,0 +1,16 @@
+#include "Bounds.hpp"
+
+#if !MATH_INLINE_CORE
+#include "Bounds.inl"
+#endif
+
+template struct TAABB<float>;
+template struct TAABB<double>;
+template struct TSphere<float>;
+template struct TSphere<double>;
+template struct TRay<float>;
+template struct TRay<double>;
+template struct TPlane<float>;
+template struct TPlane<double>;
+template struct TFrustum<float>;
+template struct TFrustum<double>;
@@ -0,0 +1,41 @@
+#include "DualQuat.hpp"
+#include "FastMath.hpp"
+#include <stdexcept>
+
+#if !MATH_INLINE_CORE
+#include "DualQuat.inl"
+#endif
+
+template<typename T>
+TDualQuat<T> TDualQuat<T>::FromAffine3x4(const TAffine3x4<T>& A)
+{
+    return FromTR(A.GetTranslation(), TQuat<T>::FromMatrix3x3(A.GetRotationScale()));
+}
+
+template<typename T>
+TDualQuat<T> TDualQuat<T>::Normalized() const
+{
+    const T n2 = real.s * real.s + real.x * real.x + real.y * real.y + real.z * real.z;
+    if (n2 == 0) throw std::invalid_argument("DualQuat::Normalized: zero norm");
+    const T inv = FastMath::Rsqrt(n2);
+
+    TDualQuat D;
+    D.real = { real.s * inv, real.x * inv, real.y * inv, real.z * inv };
+    D.dual = { dual.s * inv, dual.x * inv, dual.y * inv, dual.z * inv };
+
+    // Remove the part of dual along real, so that real . dual = 0 again
+    const T k = D.real.s * D.dual.s + D.real.x * D.dual.x + D.real.y * D.dual.y + D.real.z * D.dual.z;
+    D.dual = { D.dual.s - k * D.real.s, D.dual.x - k * D.real.x, D.dual.y - k * D.real.y, D.dual.z - k * D.real.z };
+    return D;
+}
+
+template<typename T>
+TAffine3x4<T> TDualQuat<T>::ToAffine3x4() const
+{
+    TAffine3x4<T> A = TAffine3x4<T>::Rotate(real.ToMatrix3x3Unchecked());
+    A.SetTranslation(GetTranslation());
+    return A;
+}
+
+template struct TDualQuat<float>;
+template struct TDualQuat<double>;
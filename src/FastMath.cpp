@@ -0,0 +1,314 @@
+#include "FastMath.hpp"
+#include "Simd.hpp"
+#include <stdexcept>
+
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if !MATH_INLINE_CORE
+#include "FastMath.inl"
+#endif
+
+namespace FastMath
+{
+    using namespace Detail;
+
+#if SIMD_X86
+    // ------------------ AVX2 + FMA ----------------
+    // Same reduction and polynomials as the scalar versions, 4 doubles / 8 floats
+    // per step. Lanes outside the valid range are redone with the scalar version.
+
+    SIMD_TARGET("avx2,fma")
+    static void SinCosAVX2(const double* x, double* s, double* c, std::size_t n)
+    {
+        using K = Coeffs<double>;
+        const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+        const __m256i one = _mm256_set1_epi64x(1);
+        const __m256i two = _mm256_set1_epi64x(2);
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d v = _mm256_loadu_pd(x + i);
+
+            // Rounds to nearest
+            const __m128i q32 = _mm256_cvtpd_epi32(_mm256_mul_pd(v, _mm256_set1_pd(TWO_OVER_PI<double>)));
+            const __m256d k = _mm256_cvtepi32_pd(q32);
+            __m256d r = _mm256_fnmadd_pd(k, _mm256_set1_pd(K::PIO2_1), v);
+            r = _mm256_fnmadd_pd(k, _mm256_set1_pd(K::PIO2_2), r);
+            r = _mm256_fnmadd_pd(k, _mm256_set1_pd(K::PIO2_3), r);
+            const __m256d z = _mm256_mul_pd(r, r);
+
+            __m256d ps = _mm256_set1_pd(K::S[5]);
+            ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(K::S[4]));
+            ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(K::S[3]));
+            ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(K::S[2]));
+            ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(K::S[1]));
+            ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(K::S[0]));
+            const __m256d sr = _mm256_fmadd_pd(_mm256_mul_pd(r, z), ps, r);
+
+            __m256d pc = _mm256_set1_pd(K::C[5]);
+            pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(K::C[4]));
+            pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(K::C[3]));
+            pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(K::C[2]));
+            pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(K::C[1]));
+            pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(K::C[0]));
+            const __m256d cr = _mm256_fmadd_pd(_mm256_mul_pd(z, z), pc,
+                _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, _mm256_set1_pd(1.0)));
+
+            // Quadrant: odd q swaps sin and cos, q & 2 negates sin, (q + 1) & 2 negates cos
+            const __m256i q = _mm256_cvtepi32_epi64(q32);
+            const __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(q, one), one));
+            const __m256d sinSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(q, two), 62));
+            const __m256d cosSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(q, one), two), 62));
+            _mm256_storeu_pd(s + i, _mm256_xor_pd(_mm256_blendv_pd(sr, cr, swap), sinSign));
+            _mm256_storeu_pd(c + i, _mm256_xor_pd(_mm256_blendv_pd(cr, sr, swap), cosSign));
+
+            const __m256d out = _mm256_cmp_pd(_mm256_and_pd(v, absMask), _mm256_set1_pd(SinCosMax<double>), _CMP_NLE_UQ);
+            if (_mm256_movemask_pd(out)) {
+                for (std::size_t j = i; j < i + 4; ++j) FastMath::SinCos(x[j], s[j], c[j]);
+            }
+        }
+        for (; i < n; ++i) FastMath::SinCos(x[i], s[i], c[i]);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void SinCosAVX2(const float* x, float* s, float* c, std::size_t n)
+    {
+        using K = Coeffs<float>;
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i two = _mm256_set1_epi32(2);
+
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256 v = _mm256_loadu_ps(x + i);
+
+            const __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(v, _mm256_set1_ps(TWO_OVER_PI<float>)));
+            const __m256 k = _mm256_cvtepi32_ps(q);
+            __m256 r = _mm256_fnmadd_ps(k, _mm256_set1_ps(K::PIO2_1), v);
+            r = _mm256_fnmadd_ps(k, _mm256_set1_ps(K::PIO2_2), r);
+            r = _mm256_fnmadd_ps(k, _mm256_set1_ps(K::PIO2_3), r);
+            const __m256 z = _mm256_mul_ps(r, r);
+
+            __m256 ps = _mm256_set1_ps(K::S[2]);
+            ps = _mm256_fmadd_ps(ps, z, _mm256_set1_ps(K::S[1]));
+            ps = _mm256_fmadd_ps(ps, z, _mm256_set1_ps(K::S[0]));
+            const __m256 sr = _mm256_fmadd_ps(_mm256_mul_ps(r, z), ps, r);
+
+            __m256 pc = _mm256_set1_ps(K::C[2]);
+            pc = _mm256_fmadd_ps(pc, z, _mm256_set1_ps(K::C[1]));
+            pc = _mm256_fmadd_ps(pc, z, _mm256_set1_ps(K::C[0]));
+            const __m256 cr = _mm256_fmadd_ps(_mm256_mul_ps(z, z), pc,
+                _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.0f)));
+
+            const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+            const __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+            const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+            _mm256_storeu_ps(s + i, _mm256_xor_ps(_mm256_blendv_ps(sr, cr, swap), sinSign));
+            _mm256_storeu_ps(c + i, _mm256_xor_ps(_mm256_blendv_ps(cr, sr, swap), cosSign));
+
+            const __m256 out = _mm256_cmp_ps(_mm256_and_ps(v, absMask), _mm256_set1_ps(SinCosMax<float>), _CMP_NLE_UQ);
+            if (_mm256_movemask_ps(out)) {
+                for (std::size_t j = i; j < i + 8; ++j) FastMath::SinCos(x[j], s[j], c[j]);
+            }
+        }
+        for (; i < n; ++i) FastMath::SinCos(x[i], s[i], c[i]);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void AcosAVX2(const double* x, double* out, std::size_t n)
+    {
+        using K = Coeffs<double>;
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        const __m256d half = _mm256_set1_pd(0.5);
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d v = _mm256_loadu_pd(x + i);
+            const __m256d sign = _mm256_and_pd(v, signMask);
+            const __m256d a = _mm256_min_pd(_mm256_andnot_pd(signMask, v), _mm256_set1_pd(1.0));
+
+            // |x| > 1/2: asin of s = sqrt((1 - a) / 2), else asin of s = a
+            const __m256d big = _mm256_cmp_pd(a, half, _CMP_GT_OQ);
+            const __m256d z = _mm256_blendv_pd(_mm256_mul_pd(a, a), _mm256_mul_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), a), half), big);
+            const __m256d s = _mm256_blendv_pd(a, _mm256_sqrt_pd(z), big);
+
+            __m256d p = _mm256_set1_pd(K::P[5]);
+            p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(K::P[4]));
+            p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(K::P[3]));
+            p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(K::P[2]));
+            p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(K::P[1]));
+            p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(K::P[0]));
+            p = _mm256_mul_pd(p, z);
+            __m256d q = _mm256_set1_pd(K::Q[3]);
+            q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(K::Q[2]));
+            q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(K::Q[1]));
+            q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(K::Q[0]));
+            q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.0));
+            const __m256d t = _mm256_fmadd_pd(s, _mm256_div_pd(p, q), s);
+
+            const __m256d small = _mm256_sub_pd(_mm256_set1_pd(PIO2<double>), _mm256_xor_pd(t, sign));
+            const __m256d t2 = _mm256_add_pd(t, t);
+            const __m256d large = _mm256_blendv_pd(t2, _mm256_sub_pd(_mm256_set1_pd(PI<double>), t2), sign);
+            _mm256_storeu_pd(out + i, _mm256_blendv_pd(small, large, big));
+        }
+        for (; i < n; ++i) out[i] = FastMath::Acos(x[i]);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void AcosAVX2(const float* x, float* out, std::size_t n)
+    {
+        using K = Coeffs<float>;
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256 v = _mm256_loadu_ps(x + i);
+            const __m256 sign = _mm256_and_ps(v, signMask);
+            const __m256 a = _mm256_min_ps(_mm256_andnot_ps(signMask, v), _mm256_set1_ps(1.0f));
+
+            const __m256 big = _mm256_cmp_ps(a, half, _CMP_GT_OQ);
+            const __m256 z = _mm256_blendv_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), a), half), big);
+            const __m256 s = _mm256_blendv_ps(a, _mm256_sqrt_ps(z), big);
+
+            __m256 p = _mm256_set1_ps(K::P[4]);
+            p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(K::P[3]));
+            p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(K::P[2]));
+            p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(K::P[1]));
+            p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(K::P[0]));
+            const __m256 t = _mm256_fmadd_ps(s, _mm256_mul_ps(p, z), s);
+
+            const __m256 small = _mm256_sub_ps(_mm256_set1_ps(PIO2<float>), _mm256_xor_ps(t, sign));
+            const __m256 t2 = _mm256_add_ps(t, t);
+            const __m256 large = _mm256_blendv_ps(t2, _mm256_sub_ps(_mm256_set1_ps(PI<float>), t2), sign);
+            _mm256_storeu_ps(out + i, _mm256_blendv_ps(small, large, big));
+        }
+        for (; i < n; ++i) out[i] = FastMath::Acos(x[i]);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void RsqrtAVX2(const double* x, double* out, std::size_t n)
+    {
+        const __m256d lo = _mm256_set1_pd(double(std::numeric_limits<float>::min()));
+        const __m256d hi = _mm256_set1_pd(double(std::numeric_limits<float>::max()));
+        const __m256d threeHalves = _mm256_set1_pd(1.5);
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d v = _mm256_loadu_pd(x + i);
+            __m256d y = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(v)));
+            const __m256d h = _mm256_mul_pd(v, _mm256_set1_pd(0.5));
+            for (int it = 0; it < 3; ++it) {
+                y = _mm256_mul_pd(y, _mm256_fnmadd_pd(_mm256_mul_pd(h, y), y, threeHalves));
+            }
+            _mm256_storeu_pd(out + i, y);
+
+            const __m256d inside = _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GE_OQ), _mm256_cmp_pd(v, hi, _CMP_LE_OQ));
+            if (_mm256_movemask_pd(inside) != 0xF) {
+                for (std::size_t j = i; j < i + 4; ++j) out[j] = FastMath::Rsqrt(x[j]);
+            }
+        }
+        for (; i < n; ++i) out[i] = FastMath::Rsqrt(x[i]);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void RsqrtAVX2(const float* x, float* out, std::size_t n)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256 v = _mm256_loadu_ps(x + i);
+            const __m256 y = _mm256_rsqrt_ps(v);
+            const __m256 hy = _mm256_mul_ps(_mm256_mul_ps(v, _mm256_set1_ps(0.5f)), y);
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(y, _mm256_fnmadd_ps(hy, y, _mm256_set1_ps(1.5f))));
+        }
+        for (; i < n; ++i) out[i] = FastMath::Rsqrt(x[i]);
+    }
+#endif
+
+    static bool UseAVX2()
+    {
+#if SIMD_X86
+        return Simd::Active() >= Simd::Level::AVX2;
+#else
+        return false;
+#endif
+    }
+
+    static void CheckSizes(std::size_t a, std::size_t b, const char* what)
+    {
+        if (a != b) throw std::invalid_argument(what);
+    }
+
+    void SinCos(std::span<const double> x, std::span<double> s, std::span<double> c)
+    {
+        CheckSizes(x.size(), s.size(), "SinCos: input and output sizes differ");
+        CheckSizes(x.size(), c.size(), "SinCos: input and output sizes differ");
+#if SIMD_X86
+        if (UseAVX2()) return SinCosAVX2(x.data(), s.data(), c.data(), x.size());
+#endif
+        for (std::size_t i = 0; i < x.size(); ++i) SinCos(x[i], s[i], c[i]);
+    }
+
+    void SinCos(std::span<const float> x, std::span<float> s, std::span<float> c)
+    {
+        CheckSizes(x.size(), s.size(), "SinCos: input and output sizes differ");
+        CheckSizes(x.size(), c.size(), "SinCos: input and output sizes differ");
+#if SIMD_X86
+        if (UseAVX2()) return SinCosAVX2(x.data(), s.data(), c.data(), x.size());
+#endif
+        for (std::size_t i = 0; i < x.size(); ++i) SinCos(x[i], s[i], c[i]);
+    }
+
+    void Acos(std::span<const double> x, std::span<double> out)
+    {
+        CheckSizes(x.size(), out.size(), "Acos: input and output sizes differ");
+#if SIMD_X86
+        if (UseAVX2()) return AcosAVX2(x.data(), out.data(), x.size());
+#endif
+        for (std::size_t i = 0; i < x.size(); ++i) out[i] = Acos(x[i]);
+    }
+
+    void Acos(std::span<const float> x, std::span<float> out)
+    {
+        CheckSizes(x.size(), out.size(), "Acos: input and output sizes differ");
+#if SIMD_X86
+        if (UseAVX2()) return AcosAVX2(x.data(), out.data(), x.size());
+#endif
+        for (std::size_t i = 0; i < x.size(); ++i) out[i] = Acos(x[i]);
+    }
+
+    void Rsqrt(std::span<const double> x, std::span<double> out)
+    {
+        CheckSizes(x.size(), out.size(), "Rsqrt: input and output sizes differ");
+#if SIMD_X86
+        if (UseAVX2()) return RsqrtAVX2(x.data(), out.data(), x.size());
+#endif
+        for (std::size_t i = 0; i < x.size(); ++i) out[i] = Rsqrt(x[i]);
+    }
+
+    void Rsqrt(std::span<const float> x, std::span<float> out)
+    {
+        CheckSizes(x.size(), out.size(), "Rsqrt: input and output sizes differ");
+#if SIMD_X86
+        if (UseAVX2()) return RsqrtAVX2(x.data(), out.data(), x.size());
+#endif
+        for (std::size_t i = 0; i < x.size(); ++i) out[i] = Rsqrt(x[i]);
+    }
+
+#if !MATH_INLINE_CORE
+    template void SinCos<float>(float, float&, float&);
+    template void SinCos<double>(double, double&, double&);
+    template float Acos<float>(float);
+    template double Acos<double>(double);
+    template float Rsqrt<float>(float);
+    template double Rsqrt<double>(double);
+#endif
+}
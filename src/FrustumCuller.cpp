@@ -0,0 +1,117 @@
+#include "FrustumCuller.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <limits>
+
+void FrustumCuller::Update(const Scene& s, std::span<const AABB> meshBounds)
+{
+    const std::size_t n = s.Size();
+    const bool relayout = scene != &s || syncedLayout != s.GetLayoutVersion() || flags.size() != n;
+    if (!relayout && syncedVersion == s.GetWorldVersion()) return;
+
+    if (relayout)
+    {
+        for (auto* v : { &x0, &y0, &z0, &x1, &y1, &z1 }) v->resize(n);
+        subtreeBox.resize(n);
+        subtreeSize.resize(n);
+        for (std::size_t i = 0; i < n; ++i) subtreeSize[i] = static_cast<uint32_t>(s.SubtreeSize(i));
+        flags.assign(n, VISIBLE);
+    }
+
+    // Nodes without bounds get a box that reaches every plane
+    constexpr double UNBOUNDED = std::numeric_limits<double>::max() / 8;
+    const std::span<const Affine3x4> world = s.World();
+    const std::span<const uint32_t> mesh = s.Meshes();
+    const std::span<const uint32_t> stamp = s.WorldVersions();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (!relayout && static_cast<int32_t>(stamp[i] - syncedVersion) <= 0) continue;
+        const uint32_t m = mesh[i];
+        const AABB box = (m < meshBounds.size() && !meshBounds[m].IsEmpty())
+            ? meshBounds[m].Transformed(world[i])
+            : AABB::FromCenterExtents({ world[i].m[3], world[i].m[7], world[i].m[11] }, { UNBOUNDED, UNBOUNDED, UNBOUNDED });
+        x0[i] = box.min.x; y0[i] = box.min.y; z0[i] = box.min.z;
+        x1[i] = box.max.x; y1[i] = box.max.y; z1[i] = box.max.z;
+    }
+
+    // Pre-order: going backwards, every subtree is complete before it joins its parent's
+    for (std::size_t i = 0; i < n; ++i) subtreeBox[i] = { { x0[i], y0[i], z0[i] }, { x1[i], y1[i], z1[i] } };
+    const std::span<const int32_t> parent = s.Parents();
+    for (std::size_t i = n; i-- > 0; )
+        if (parent[i] >= 0) subtreeBox[parent[i]] = subtreeBox[parent[i]].Merge(subtreeBox[i]);
+
+    scene = &s;
+    syncedVersion = s.GetWorldVersion();
+    syncedLayout = s.GetLayoutVersion();
+}
+
+void FrustumCuller::ClassifyOwn(std::size_t begin, std::size_t end)
+{
+    const std::size_t count = end - begin;
+    if (containment.size() < count) containment.resize(count);
+    Simd::ClassifyBoxesSoA(planes, x0.data() + begin, y0.data() + begin, z0.data() + begin,
+        x1.data() + begin, y1.data() + begin, z1.data() + begin, containment.data(), count);
+    for (std::size_t k = 0; k < count; ++k)
+        flags[begin + k] = (containment[k] != static_cast<uint8_t>(Containment::Outside)) ? VISIBLE : 0;
+    stats.boxesTested += count;
+}
+
+void FrustumCuller::Cull(const Frustum& frustum)
+{
+    for (int k = 0; k < 6; ++k)
+    {
+        const Plane& p = frustum.planes[k];
+        planes[4 * k + 0] = p.normal.x;
+        planes[4 * k + 1] = p.normal.y;
+        planes[4 * k + 2] = p.normal.z;
+        planes[4 * k + 3] = p.d;
+    }
+    stats = {};
+    std::fill(flags.begin(), flags.end(), uint8_t(0));
+
+    // Pre-order walk. open holds the straddling ancestors of i, with the planes that are
+    // still worth testing below them.
+    struct Open {
+        std::size_t end;
+        unsigned planeMask;
+    };
+    std::vector<Open> open;
+    const std::size_t n = flags.size();
+    std::size_t i = 0;
+    while (i < n)
+    {
+        while (!open.empty() && i >= open.back().end) open.pop_back();
+        unsigned mask = open.empty() ? Frustum::ALL_PLANES : open.back().planeMask;
+        const std::size_t end = i + subtreeSize[i];
+
+        ++stats.boxesTested;
+        const Containment c = frustum.Classify(subtreeBox[i], mask);
+        if (c == Containment::Outside)
+        {
+            flags[i] = SUBTREE_CULLED;
+            ++stats.subtreesOutside;
+            i = end;
+        }
+        else if (c == Containment::Inside)
+        {
+            std::fill(flags.begin() + i, flags.begin() + end, VISIBLE);
+            ++stats.subtreesInside;
+            i = end;
+        }
+        else if (end - i <= FLAT_SUBTREE)
+        {
+            ClassifyOwn(i, end);
+            i = end;
+        }
+        else
+        {
+            ClassifyOwn(i, i + 1);
+            open.push_back({ end, mask });
+            ++i;
+        }
+    }
+
+    stats.visible = static_cast<std::size_t>(std::count_if(flags.begin(), flags.end(),
+        [](uint8_t f) { return (f & VISIBLE) != 0; }));
+    stats.culled = n - stats.visible;
+}
@@ -0,0 +1,145 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+
+// Queue of the worker running on this thread (per JobSystem)
+static thread_local const JobSystem* tlsOwner = nullptr;
+static thread_local std::size_t tlsQueue = 0;
+
+JobSystem::JobSystem(unsigned threads)
+{
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+    for (unsigned i = 1; i < threads; ++i) workers.emplace_back([this, i] { WorkerLoop(i); });
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+void JobSystem::Run(Counter& counter, std::function<void()> job)
+{
+    Job j;
+    j.fn = [](void* ctx, std::size_t, std::size_t) {
+        std::unique_ptr<std::function<void()>> f(static_cast<std::function<void()>*>(ctx));
+        (*f)();
+    };
+    j.ctx = new std::function<void()>(std::move(job));
+    j.counter = &counter;
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    Submit(j);
+}
+
+void JobSystem::Wait(Counter& counter)
+{
+    const std::size_t self = CurrentQueue();
+    Job job;
+    while (!counter.Done())
+    {
+        if (Pop(self, job) || Steal(self, job)) Execute(job);
+        else std::this_thread::yield();
+    }
+    if (counter.error)
+    {
+        std::exception_ptr e = counter.error;
+        counter.error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+void JobSystem::Submit(const Job& job)
+{
+    Queue& q = *queues[CurrentQueue()];
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.jobs.push_back(job);
+    }
+    // seq_cst here and in WorkerLoop: either the worker sees the job or we see it asleep
+    queued.fetch_add(1);
+    if (sleeping.load() > 0)
+    {
+        // Taking the lock orders this with a worker about to sleep (no lost wake-up)
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_one();
+    }
+}
+
+bool JobSystem::Pop(std::size_t self, Job& job)
+{
+    Queue& q = *queues[self];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.jobs.empty()) return false;
+    job = q.jobs.back();
+    q.jobs.pop_back();
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::Steal(std::size_t self, Job& job)
+{
+    const std::size_t n = queues.size();
+    for (std::size_t k = 1; k < n; ++k)
+    {
+        Queue& q = *queues[(self + k) % n];
+        std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || q.jobs.empty()) continue;
+        job = q.jobs.front();
+        q.jobs.pop_front();
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::Execute(const Job& job)
+{
+    try
+    {
+        job.fn(job.ctx, job.begin, job.end);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(job.counter->errorMutex);
+        if (!job.counter->error) job.counter->error = std::current_exception();
+    }
+    job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+std::size_t JobSystem::CurrentQueue() const
+{
+    return (tlsOwner == this) ? tlsQueue : 0;
+}
+
+void JobSystem::WorkerLoop(std::size_t self)
+{
+    tlsOwner = this;
+    tlsQueue = self;
+    Job job;
+    while (true)
+    {
+        if (Pop(self, job) || Steal(self, job))
+        {
+            Execute(job);
+            continue;
+        }
+        // Spin briefly (jobs of a frame come in bursts), then sleep
+        bool found = false;
+        for (int spin = 0; spin < 64 && !found; ++spin)
+        {
+            std::this_thread::yield();
+            found = queued.load(std::memory_order_acquire) > 0;
+        }
+        if (found) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.fetch_add(1);
+        wake.wait(lock, [this] { return stop.load() || queued.load() > 0; });
+        sleeping.fetch_sub(1);
+        if (stop) return;
+    }
+}
@@ -1,183 +1,209 @@
 #include "Matrix3x3.hpp"
+#include "FastMath.hpp"
 #include <stdexcept>
+#include <type_traits>
 
-#define TOL 1e-6
+// Tolerance scaled to the precision of T
+template<typename T>
+static constexpr T TOL = std::is_same_v<T, float> ? T(1e-4) : T(1e-6);
 #define PI 3.14159265358979323846
 
-// ------------------ Vec3 -------------------------
-
-double Vec3::Dot(const Vec3& a, const Vec3& b)
-{
-    return a.x * b.x + a.y * b.y + a.z * b.z;
-}
+#if !MATH_INLINE_CORE
+#include "Matrix3x3.inl"
+#endif
 
-Vec3 Vec3::Cross(const Vec3& a, const Vec3& b)
-{
-    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
-}
+// ------------------ Vec3 -------------------------
 
-double Vec3::Norm() const
+template<typename T>
+T TVec3<T>::Norm() const
 {
     return std::sqrt(Dot(*this, *this));
 }
 
-Vec3 Vec3::Normalize() const
+template<typename T>
+TVec3<T> TVec3<T>::Normalize() const
 {
-    double n = Norm();
-    if (n == 0) throw std::invalid_argument("normalize: zero vector");
-    return { x / n, y / n, z / n };
+    T n2 = Dot(*this, *this);
+    if (n2 == 0) throw std::invalid_argument("normalize: zero vector");
+    T inv = FastMath::Rsqrt(n2);
+    return { x * inv, y * inv, z * inv };
 }
 
 // ------------------ Matrix3x3 ---------------------
 
-Matrix3x3 Matrix3x3::Identity()
+template<typename T>
+TMatrix3x3<T> TMatrix3x3<T>::RotationAxisAngle(const TVec3<T>& u_in, T phi)
 {
-    Matrix3x3 I;
-    I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1;
-    return I;
+    TVec3<T> u = u_in.Normalize();
+    T s, c;
+    FastMath::SinCos(phi, s, c);
+    const T t = T(1) - c;
+
+    const T ux = u.x, uy = u.y, uz = u.z;
+
+    TMatrix3x3 R{};
+    R.At(0, 0) = c + t * ux * ux;
+    R.At(0, 1) = t * ux * uy - s * uz;
+    R.At(0, 2) = t * ux * uz + s * uy;
+
+    R.At(1, 0) = t * uy * ux + s * uz;
+    R.At(1, 1) = c + t * uy * uy;
+    R.At(1, 2) = t * uy * uz - s * ux;
+
+    R.At(2, 0) = t * uz * ux - s * uy;
+    R.At(2, 1) = t * uz * uy + s * ux;
+    R.At(2, 2) = c + t * uz * uz;
+    return R;
 }
 
-Vec3 Matrix3x3::Multiply(const Vec3& x) const
+// Transposed inverse, i.e. the cofactor matrix / det. Returns det.
+template<typename T>
+static T CofactorsOverDet(const TMatrix3x3<T>& A, TMatrix3x3<T>& C)
 {
-    // y = A * x
-    Vec3 y;
-    y.x = At(0, 0) * x.x + At(0, 1) * x.y + At(0, 2) * x.z;
-    y.y = At(1, 0) * x.x + At(1, 1) * x.y + At(1, 2) * x.z;
-    y.z = At(2, 0) * x.x + At(2, 1) * x.y + At(2, 2) * x.z;
-    return y;
+    C.At(0, 0) = A.At(1, 1) * A.At(2, 2) - A.At(1, 2) * A.At(2, 1);
+    C.At(0, 1) = A.At(1, 2) * A.At(2, 0) - A.At(1, 0) * A.At(2, 2);
+    C.At(0, 2) = A.At(1, 0) * A.At(2, 1) - A.At(1, 1) * A.At(2, 0);
+    C.At(1, 0) = A.At(0, 2) * A.At(2, 1) - A.At(0, 1) * A.At(2, 2);
+    C.At(1, 1) = A.At(0, 0) * A.At(2, 2) - A.At(0, 2) * A.At(2, 0);
+    C.At(1, 2) = A.At(0, 1) * A.At(2, 0) - A.At(0, 0) * A.At(2, 1);
+    C.At(2, 0) = A.At(0, 1) * A.At(1, 2) - A.At(0, 2) * A.At(1, 1);
+    C.At(2, 1) = A.At(0, 2) * A.At(1, 0) - A.At(0, 0) * A.At(1, 2);
+    C.At(2, 2) = A.At(0, 0) * A.At(1, 1) - A.At(0, 1) * A.At(1, 0);
+
+    const T det = A.At(0, 0) * C.At(0, 0) + A.At(0, 1) * C.At(0, 1) + A.At(0, 2) * C.At(0, 2);
+    const T inv = T(1) / det;
+    for (int i = 0; i < 9; ++i) C.m[i] *= inv;
+    return det;
 }
 
-Matrix3x3 Matrix3x3::Multiply(const Matrix3x3& B) const
+// Singular, or so close that 1 / det overflows
+template<typename T>
+static bool IsSingular(T det)
 {
-    Matrix3x3 C{};
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            double s = 0.0;
-            for (int k = 0; k < 3; ++k) {
-                s += At(i, k) * B.At(k, j);
-            }
-            C.At(i, j) = s;
-        }
-    }
-    return C;
+    return !std::isfinite(T(1) / det);
 }
 
-double Matrix3x3::Det() const
+template<typename T>
+bool TMatrix3x3<T>::TryInverse(TMatrix3x3& out, T* det) const
 {
-    const double a = At(0, 0), b = At(0, 1), c = At(0, 2);
-    const double d = At(1, 0), e = At(1, 1), f = At(1, 2);
-    const double g = At(2, 0), h = At(2, 1), i = At(2, 2);
-    return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    TMatrix3x3 C;
+    const T d = CofactorsOverDet(*this, C);
+    if (det) *det = d;
+    if (IsSingular(d)) return false;
+    out = C.Transposed();
+    return true;
 }
 
-Matrix3x3 Matrix3x3::Transposed() const
+template<typename T>
+TMatrix3x3<T> TMatrix3x3<T>::Inverse() const
 {
-    Matrix3x3 R{};
-    for (int i = 0; i < 3; ++i)
-        for (int j = 0; j < 3; ++j)
-            R.At(i, j) = At(j, i);
+    TMatrix3x3 R;
+    if (!TryInverse(R)) throw std::invalid_argument("Inverse: matrix is singular");
     return R;
 }
 
-double Matrix3x3::Trace() const
+template<typename T>
+TMatrix3x3<T> TMatrix3x3<T>::InverseTransposed() const
 {
-    return At(0, 0) + At(1, 1) + At(2, 2);
+    TMatrix3x3 C;
+    if (IsSingular(CofactorsOverDet(*this, C))) throw std::invalid_argument("InverseTransposed: matrix is singular");
+    return C;
 }
 
-
-Matrix3x3 Matrix3x3::RotationAxisAngle(const Vec3& u_in, double phi)
+template<typename T>
+std::size_t TMatrix3x3<T>::InverseBatch(std::span<const TMatrix3x3> in, std::span<TMatrix3x3> out, std::span<T> det)
 {
-    Vec3 u = u_in.Normalize();
-    const double c = std::cos(phi);
-    const double s = std::sin(phi);
-    const double t = 1.0 - c;
-
-    const double ux = u.x, uy = u.y, uz = u.z;
-
-    Matrix3x3 R{};
-    R.At(0, 0) = c + t * ux * ux;
-    R.At(0, 1) = t * ux * uy - s * uz;
-    R.At(0, 2) = t * ux * uz + s * uy;
-
-    R.At(1, 0) = t * uy * ux + s * uz;
-    R.At(1, 1) = c + t * uy * uy;
-    R.At(1, 2) = t * uy * uz - s * ux;
-
-    R.At(2, 0) = t * uz * ux - s * uy;
-    R.At(2, 1) = t * uz * uy + s * ux;
-    R.At(2, 2) = c + t * uz * uz;
-    return R;
+    if (out.size() != in.size() || (!det.empty() && det.size() != in.size())) {
+        throw std::invalid_argument("InverseBatch: input and output sizes differ");
+    }
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < in.size(); ++i)
+    {
+        T d;
+        if (!in[i].TryInverse(out[i], &d)) {
+            out[i] = TMatrix3x3{};
+            d = T(0);
+            ++failed;
+        }
+        if (!det.empty()) det[i] = d;
+    }
+    return failed;
 }
 
-bool Matrix3x3::IsRotation() const
+template<typename T>
+bool TMatrix3x3<T>::IsRotation() const
 {
-    Matrix3x3 Rt = this->Transposed();
-    Matrix3x3 RtR = Rt.Multiply(*this);
-    Matrix3x3 I = Identity();
+    TMatrix3x3 Rt = this->Transposed();
+    TMatrix3x3 RtR = Rt.Multiply(*this);
+    TMatrix3x3 I = Identity();
 
     for (int i = 0; i < 3; ++i)
     {
         for (int j = 0; j < 3; ++j)
         {
-            if (std::fabs(RtR.At(i, j) - I.At(i, j)) > TOL) return false;
+            if (std::fabs(RtR.At(i, j) - I.At(i, j)) > TOL<T>) return false;
         }
     }
 
-    if (std::fabs(Det() - 1.0) > TOL) return false;
+    if (std::fabs(Det() - T(1)) > TOL<T>) return false;
 
     return true;
 }
 
-Vec3 Matrix3x3::Rotate(const Vec3& v) const
+template<typename T>
+TVec3<T> TMatrix3x3<T>::Rotate(const TVec3<T>& v) const
 {
     return Multiply(v);
 }
 
-void Matrix3x3::ToAxisAngle(Vec3& axis, double& angle) const
+template<typename T>
+void TMatrix3x3<T>::ToAxisAngle(TVec3<T>& axis, T& angle) const
 {
     if (!IsRotation()) throw std::invalid_argument("ToAxisAngle: matrix is not a rotation");
 
-    double tr = Trace();
-    double cos_a = (tr - 1.0) * 0.5;
-    angle = std::acos(cos_a);
+    T tr = Trace();
+    T cos_a = (tr - T(1)) * T(0.5);
+    angle = FastMath::Acos(cos_a);
 
-    if (std::fabs(angle) < TOL)
+    if (std::fabs(angle) < TOL<T>)
     {
         axis = { 1,0,0 };
         return;
     }
 
-    if (std::fabs(PI - angle) < TOL)
+    if (std::fabs(T(PI) - angle) < TOL<T>)
     {
-        double xx = (At(0, 0) + 1.0) * 0.5;
-        double yy = (At(1, 1) + 1.0) * 0.5;
-        double zz = (At(2, 2) + 1.0) * 0.5;
-        double x = std::sqrt(xx);
-        double y = std::sqrt(yy);
-        double z = std::sqrt(zz);
+        T xx = (At(0, 0) + T(1)) * T(0.5);
+        T yy = (At(1, 1) + T(1)) * T(0.5);
+        T zz = (At(2, 2) + T(1)) * T(0.5);
+        T x = std::sqrt(xx);
+        T y = std::sqrt(yy);
+        T z = std::sqrt(zz);
 
-        if (At(0, 1) + At(1, 0) < 0.0) y = -y;
-        if (At(0, 2) + At(2, 0) < 0.0) z = -z;
+        if (At(0, 1) + At(1, 0) < T(0)) y = -y;
+        if (At(0, 2) + At(2, 0) < T(0)) z = -z;
 
-        axis = Vec3{ x, y, z }.Normalize();
+        axis = TVec3<T>{ x, y, z }.Normalize();
 
         return;
     }
 
-    double denom = 2.0 * std::sin(angle);
+    T denom = T(2) * std::sin(angle);
     axis.x = (At(2, 1) - At(1, 2)) / denom;
     axis.y = (At(0, 2) - At(2, 0)) / denom;
     axis.z = (At(1, 0) - At(0, 1)) / denom;
     axis = axis.Normalize();
 }
 
-Matrix3x3 Matrix3x3::FromEulerZYX(double yaw, double pitch, double roll)
+template<typename T>
+TMatrix3x3<T> TMatrix3x3<T>::FromEulerZYX(T yaw, T pitch, T roll)
 {
-    const double cy = std::cos(yaw), sy = std::sin(yaw);
-    const double cp = std::cos(pitch), sp = std::sin(pitch);
-    const double cr = std::cos(roll), sr = std::sin(roll);
+    T cy, sy, cp, sp, cr, sr;
+    FastMath::SinCos(yaw, sy, cy);
+    FastMath::SinCos(pitch, sp, cp);
+    FastMath::SinCos(roll, sr, cr);
 
-    Matrix3x3 R{};
+    TMatrix3x3 R{};
     R.At(0, 0) = cy * cp;
     R.At(0, 1) = cy * sp * sr - sy * cr;
     R.At(0, 2) = cy * sp * cr + sy * sr;
@@ -192,11 +218,12 @@ Matrix3x3 Matrix3x3::FromEulerZYX(double yaw, double pitch, double roll)
     return R;
 }
 
-void Matrix3x3::ToEulerZYX(double& yaw, double& pitch, double& roll) const
+template<typename T>
+void TMatrix3x3<T>::ToEulerZYX(T& yaw, T& pitch, T& roll) const
 {
-    double r20 = At(2, 0);
+    T r20 = At(2, 0);
 
-    if (std::fabs(r20) < 1.0 - TOL)
+    if (std::fabs(r20) < T(1) - TOL<T>)
     {
         pitch = std::asin(-r20);
         yaw = std::atan2(At(1, 0), At(0, 0));
@@ -204,44 +231,51 @@ void Matrix3x3::ToEulerZYX(double& yaw, double& pitch, double& roll) const
     }
     else
     {
-        pitch = (r20 < 0.0) ? +PI / 2 : -PI / 2;
+        pitch = (r20 < T(0)) ? T(+PI / 2) : T(-PI / 2);
         yaw = std::atan2(-At(0, 1), At(1, 1));
-        roll = 0.0;
+        roll = T(0);
     }
 }
 
-Matrix3x3 Matrix3x3::RotateFromTo(const Vec3& u, const Vec3& v)
+template<typename T>
+TMatrix3x3<T> TMatrix3x3<T>::RotateFromTo(const TVec3<T>& u, const TVec3<T>& v)
 {
-    Vec3 a{ u.Normalize()};
-    Vec3 b{ v.Normalize()};
+    TVec3<T> a{ u.Normalize()};
+    TVec3<T> b{ v.Normalize()};
 
-    double dot = Vec3::Dot(a, b);
+    T dot = TVec3<T>::Dot(a, b);
 
-    if (std::fabs(dot - 1.0) < TOL) 
+    if (std::fabs(dot - T(1)) < TOL<T>)
     {
         return Identity();
     }
 
-    if (std::fabs(dot + 1.0) < TOL) 
+    if (std::fabs(dot + T(1)) < TOL<T>)
     {
-        Vec3 arbitrary = (std::fabs(a.x) < 0.9) ? Vec3{ 1,0,0 } : Vec3{ 0,1,0 };
-        Vec3 axis = Vec3::Cross(a, arbitrary).Normalize();
-        return RotationAxisAngle(axis, PI);
+        TVec3<T> arbitrary = (std::fabs(a.x) < T(0.9)) ? TVec3<T>{ 1,0,0 } : TVec3<T>{ 0,1,0 };
+        TVec3<T> axis = TVec3<T>::Cross(a, arbitrary).Normalize();
+        return RotationAxisAngle(axis, T(PI));
     }
 
-    Vec3 axis = Vec3::Cross(a, b).Normalize();
-    double angle = std::acos(dot);
+    TVec3<T> axis = TVec3<T>::Cross(a, b).Normalize();
+    T angle = FastMath::Acos(dot);
     return RotationAxisAngle(axis, angle);
 }
 
-Matrix3x3 Matrix3x3::RotateToTarget(const Matrix3x3& initialRot, const Matrix3x3& finalRot)
+template<typename T>
+TMatrix3x3<T> TMatrix3x3<T>::RotateToTarget(const TMatrix3x3& initialRot, const TMatrix3x3& finalRot)
 {
     if (!initialRot.IsRotation())
         throw std::invalid_argument("RotateToTarget: initialRot is not a rotation");
     if (!finalRot.IsRotation())
         throw std::invalid_argument("RotateToTarget: finalRot is not a rotation");
 
-    Matrix3x3 RiT = initialRot.Transposed();
-    Matrix3x3 Rdelta = finalRot.Multiply(RiT);
+    TMatrix3x3 RiT = initialRot.Transposed();
+    TMatrix3x3 Rdelta = finalRot.Multiply(RiT);
     return Rdelta;
 }
+
+template struct TVec3<float>;
+template struct TVec3<double>;
+template struct TMatrix3x3<float>;
+template struct TMatrix3x3<double>;
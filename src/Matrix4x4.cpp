@@ -1,57 +1,40 @@
 #include "Matrix4x4.hpp"
+#include "Affine3x4.hpp"
+#include "Simd.hpp"
 #include <cmath>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 
-#define TOL 1e-6
+// Tolerance scaled to the precision of T
+template<typename T>
+static constexpr T TOL = std::is_same_v<T, float> ? T(1e-4) : T(1e-6);
 
-Matrix4x4 Matrix4x4::Identity()
-{
-    Matrix4x4 I;
-    I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1; I.At(3, 3) = 1;
-    return I;
-}
-
-Matrix4x4 Matrix4x4::Multiply(const Matrix4x4& B) const
-{
-    Matrix4x4 C{};
-    for (int i = 0; i < 4; ++i) {
-        for (int j = 0; j < 4; ++j) {
-            double sum = 0.0;
-            for (int k = 0; k < 4; ++k) {
-                sum += At(i, k) * B.At(k, j);
-            }
-            C.At(i, j) = sum;
-        }
-    }
-    return C;
-}
+#if !MATH_INLINE_CORE
+#include "Matrix4x4.inl"
+#endif
 
-Vec4 Matrix4x4::Multiply(const Vec4& v) const
-{
-    Vec4 res;
-    res.x = At(0, 0) * v.x + At(0, 1) * v.y + At(0, 2) * v.z + At(0, 3) * v.w;
-    res.y = At(1, 0) * v.x + At(1, 1) * v.y + At(1, 2) * v.z + At(1, 3) * v.w;
-    res.z = At(2, 0) * v.x + At(2, 1) * v.y + At(2, 2) * v.z + At(2, 3) * v.w;
-    res.w = At(3, 0) * v.x + At(3, 1) * v.y + At(3, 2) * v.z + At(3, 3) * v.w;
-    return res;
-}
+// The bulk SIMD kernels only cover double row-major storage
+template<typename T, MatrixLayout L>
+static constexpr bool IsRowMajorDouble = std::is_same_v<T, double> && L == MatrixLayout::RowMajor;
 
 // --------------------------------------------------------------------------
 // TODO LAB 3
 // --------------------------------------------------------------------------
 
-bool Matrix4x4::IsAffine() const
+template<typename T, MatrixLayout L>
+bool TMatrix4x4<T, L>::IsAffine() const
 {
-    if (std::abs(At(3, 0)) > TOL) {
+    if (std::abs(At(3, 0)) > TOL<T>) {
         return false;
     }
-    if (std::abs(At(3, 1)) > TOL) {
+    if (std::abs(At(3, 1)) > TOL<T>) {
         return false;
     }
-    if (std::abs(At(3, 2)) > TOL) {
+    if (std::abs(At(3, 2)) > TOL<T>) {
         return false;
     }
-    if (std::abs(At(3, 3) - 1) > TOL) {
+    if (std::abs(At(3, 3) - 1) > TOL<T>) {
         return false;
     }
     else {
@@ -59,101 +42,171 @@ bool Matrix4x4::IsAffine() const
     }
 }
 
-Vec3 Matrix4x4::TransformPoint(const Vec3& p) const
+template<typename T, MatrixLayout L>
+TVec3<T> TMatrix4x4<T, L>::TransformPoint(const TVec3<T>& p) const
 {
-    Vec4 v4(p.x, p.y, p.z, 1.0f);
-    Vec4 res = Multiply(v4);
-    if (std::abs(res.w) > TOL && std::abs(res.w - 1.0f) > TOL) {
-        float div = 1.0f / res.w;
-        return Vec3(res.x * div, res.y * div, res.z * div);
-    }
-    Vec3 result = Vec3(res.x, res.y, res.z);
+    // Same rule as TransformPoints: an affine matrix never divides, any other one
+    // divides by w unless it is exactly 0
+    TVec4<T> v4(p.x, p.y, p.z, T(1));
+    TVec4<T> res = Multiply(v4);
+    if (!IsAffine() && res.w != T(0)) {
+        T div = T(1) / res.w;
+        return TVec3<T>(res.x * div, res.y * div, res.z * div);
+    }
+    TVec3<T> result = TVec3<T>(res.x, res.y, res.z);
     return result;
 }
 
-Vec3 Matrix4x4::TransformVector(const Vec3& v) const
+template<typename T, MatrixLayout L>
+TVec3<T> TMatrix4x4<T, L>::TransformVector(const TVec3<T>& v) const
 {
-    Vec4 v4(v.x, v.y, v.z, 0.0f);
+    TVec4<T> v4(v.x, v.y, v.z, T(0));
 
-    Vec4 result = this->Multiply(v4);
+    TVec4<T> result = this->Multiply(v4);
 
-    return Vec3(result.x, result.y, result.z);
+    return TVec3<T>(result.x, result.y, result.z);
 }
 
-Matrix4x4 Matrix4x4::Translate(const Vec3& t)
-{
-    Matrix4x4 M = Matrix4x4::Identity();
-
-    M.At(0,3) = t.x;
-    M.At(1,3) = t.y;
-    M.At(2,3) = t.z;
+// --------------------------------------------------------------------------
+// Transformacions en bloc
+// --------------------------------------------------------------------------
 
-    return M;
+static void CheckSizes(const char* name, std::size_t a, std::size_t b)
+{
+    if (a != b) throw std::invalid_argument(std::string(name) + ": input and output sizes differ");
 }
 
-Matrix4x4 Matrix4x4::Scale(const Vec3& s)
+template<typename T>
+static void CheckSizes(const char* name, std::span<const T> x, std::span<const T> y, std::span<const T> z,
+    std::span<T> ox, std::span<T> oy, std::span<T> oz)
 {
-    Matrix4x4 M = Matrix4x4::Identity();
+    const std::size_t n = x.size();
+    if (y.size() != n || z.size() != n || ox.size() != n || oy.size() != n || oz.size() != n) {
+        throw std::invalid_argument(std::string(name) + ": input and output sizes differ");
+    }
+}
 
-    M.At(0, 0) = s.x;  
-    M.At(1, 1) = s.y;  
-    M.At(2, 2) = s.z;  
+// The AoS kernels read Vec3 arrays as packed (x, y, z) triplets
+static_assert(sizeof(Vec3) == 3 * sizeof(double), "Vec3 must be tightly packed");
 
+static const double* Raw(std::span<const Vec3> v) { return reinterpret_cast<const double*>(v.data()); }
+static double* Raw(std::span<Vec3> v) { return reinterpret_cast<double*>(v.data()); }
 
-    return M;
+// Generic path for the layouts/precisions without a SIMD kernel
+template<typename T, MatrixLayout L>
+static void TransformGeneric(const TMatrix4x4<T, L>& M, const T* x, const T* y, const T* z,
+    T* ox, T* oy, T* oz, std::size_t n, std::size_t stride, bool projective, T w)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const T px = x[i * stride], py = y[i * stride], pz = z[i * stride];
+        T rx = M.At(0, 0) * px + M.At(0, 1) * py + M.At(0, 2) * pz + M.At(0, 3) * w;
+        T ry = M.At(1, 0) * px + M.At(1, 1) * py + M.At(1, 2) * pz + M.At(1, 3) * w;
+        T rz = M.At(2, 0) * px + M.At(2, 1) * py + M.At(2, 2) * pz + M.At(2, 3) * w;
+        if (projective) {
+            const T rw = M.At(3, 0) * px + M.At(3, 1) * py + M.At(3, 2) * pz + M.At(3, 3);
+            if (rw != T(0)) {
+                const T inv = T(1) / rw;
+                rx *= inv; ry *= inv; rz *= inv;
+            }
+        }
+        ox[i * stride] = rx;
+        oy[i * stride] = ry;
+        oz[i * stride] = rz;
+    }
 }
 
-Matrix4x4 Matrix4x4::Rotate(const Matrix3x3& R)
+template<typename T, MatrixLayout L>
+static void TransformAoS(const TMatrix4x4<T, L>& M, std::span<const TVec3<T>> in, std::span<TVec3<T>> out,
+    bool projective, T w)
 {
-    Matrix4x4 M = Matrix4x4::Identity();
+    if constexpr (IsRowMajorDouble<T, L>) {
+        if (projective) Simd::TransformProjectiveAoS(M.m, Raw(in), Raw(out), in.size());
+        else Simd::TransformAffineAoS(M.m, Raw(in), Raw(out), in.size(), w);
+    }
+    else {
+        const T* src = &in.data()->x;
+        T* dst = &out.data()->x;
+        TransformGeneric(M, src, src + 1, src + 2, dst, dst + 1, dst + 2, in.size(), 3, projective, w);
+    }
+}
 
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            M.At(i, j) = R.At(i, j);
-        }
+template<typename T, MatrixLayout L>
+static void TransformSoA(const TMatrix4x4<T, L>& M, std::span<const T> x, std::span<const T> y, std::span<const T> z,
+    std::span<T> ox, std::span<T> oy, std::span<T> oz, bool projective, T w)
+{
+    if constexpr (IsRowMajorDouble<T, L>) {
+        if (projective) Simd::TransformProjectiveSoA(M.m, x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), x.size());
+        else Simd::TransformAffineSoA(M.m, x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), x.size(), w);
     }
+    else {
+        TransformGeneric(M, x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), x.size(), 1, projective, w);
+    }
+}
 
-    return M;
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::TransformPoints(std::span<const TVec3<T>> in, std::span<TVec3<T>> out) const
+{
+    CheckSizes("TransformPoints", in.size(), out.size());
+    TransformAoS(*this, in, out, !IsAffine(), T(1));
 }
 
-Matrix4x4 Matrix4x4::Rotate(const Quat& q)
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::TransformVectors(std::span<const TVec3<T>> in, std::span<TVec3<T>> out) const
 {
-    Matrix4x4 M;
-    Matrix3x3 R;
-    R = q.ToMatrix3x3();
-    M = Rotate(R);
+    CheckSizes("TransformVectors", in.size(), out.size());
+    TransformAoS(*this, in, out, false, T(0));
+}
 
-    return M;
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::TransformPointsProjective(std::span<const TVec3<T>> in, std::span<TVec3<T>> out) const
+{
+    CheckSizes("TransformPointsProjective", in.size(), out.size());
+    TransformAoS(*this, in, out, true, T(1));
 }
 
-Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Matrix3x3& R, const Vec3& s)
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::TransformPoints(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+    std::span<T> ox, std::span<T> oy, std::span<T> oz) const
 {
-    Matrix4x4 M;
-    M = Rotate(R);
+    CheckSizes<T>("TransformPoints", x, y, z, ox, oy, oz);
+    TransformSoA(*this, x, y, z, ox, oy, oz, !IsAffine(), T(1));
+}
 
-    float scales[3] = { s.x, s.y, s.z };
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::TransformVectors(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+    std::span<T> ox, std::span<T> oy, std::span<T> oz) const
+{
+    CheckSizes<T>("TransformVectors", x, y, z, ox, oy, oz);
+    TransformSoA(*this, x, y, z, ox, oy, oz, false, T(0));
+}
 
-    for (int j = 0; j < 3; ++j)
-    {
-        for (int i = 0; i < 3; ++i)
-        {
-            M.At(i, j) = M.At(i, j) * scales[j];
-        }
-    }
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::TransformPointsProjective(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+    std::span<T> ox, std::span<T> oy, std::span<T> oz) const
+{
+    CheckSizes<T>("TransformPointsProjective", x, y, z, ox, oy, oz);
+    TransformSoA(*this, x, y, z, ox, oy, oz, true, T(1));
+}
 
-    M.At(0, 3) = t.x;
-    M.At(1, 3) = t.y;
-    M.At(2, 3) = t.z;
+template<typename T, MatrixLayout L>
+TMatrix4x4<T, L> TMatrix4x4<T, L>::Rotate(const TQuat<T>& q)
+{
+    TMatrix4x4 M;
+    TMatrix3x3<T> R;
+    R = q.ToMatrix3x3();
+    M = Rotate(R);
 
     return M;
 }
 
-Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Quat& q, const Vec3& s)
+template<typename T, MatrixLayout L>
+TMatrix4x4<T, L> TMatrix4x4<T, L>::FromTRS(const TVec3<T>& t, const TQuat<T>& q, const TVec3<T>& s)
 {
-    Matrix4x4 M;
+    TMatrix4x4 M;
     M = Rotate(q);
 
-    float scales[3] = { s.x, s.y, s.z };
+    T scales[3] = { s.x, s.y, s.z };
 
     for (int j = 0; j < 3; ++j)
     {
@@ -170,69 +223,71 @@ Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Quat& q, const Vec3& s)
     return M;
 }
 
-Matrix4x4 Matrix4x4::InverseTR() const
+template<typename T, MatrixLayout L>
+TMatrix4x4<T, L> TMatrix4x4<T, L>::InverseTR() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix4x4 M;
-    Matrix3x3 R;
+    TMatrix4x4 M;
+    TMatrix3x3<T> R;
     for (int i = 0; i < 3; ++i) {
         for (int j = 0; j < 3; ++j) {
             R.At(i, j) = At(j, i);
         }
     }
 
-    Vec3 p(At(0, 3), At(1, 3), At(2, 3));
-    Vec3 pi;
+    TVec3<T> p(At(0, 3), At(1, 3), At(2, 3));
+    TVec3<T> pi;
     pi.x = -(R.At(0, 0) * p.x + R.At(0, 1) * p.y + R.At(0, 2) * p.z);
     pi.y = -(R.At(1, 0) * p.x + R.At(1, 1) * p.y + R.At(1, 2) * p.z);
     pi.z = -(R.At(2, 0) * p.x + R.At(2, 1) * p.y + R.At(2, 2) * p.z);
 
-    M = FromTRS(pi, R, Vec3(1.0f, 1.0f, 1.0f));
+    M = FromTRS(pi, R, TVec3<T>(1, 1, 1));
     return M;
 }
 
-Matrix4x4 Matrix4x4::InverseTRS() const
+template<typename T, MatrixLayout L>
+TMatrix4x4<T, L> TMatrix4x4<T, L>::InverseTRS() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix4x4 M; 
-    Vec3 s = GetScale();
-    Matrix3x3 R = GetRotation();
-    Vec3 t = GetTranslation();
+    TMatrix4x4 M;
+    TVec3<T> s = GetScale();
+    TMatrix3x3<T> R = GetRotation();
+    TVec3<T> t = GetTranslation();
 
-    Vec3 inversaesc;
-    if (std::abs(s.x) > TOL) {
-        inversaesc.x = 1.0 / s.x;
+    TVec3<T> inversaesc;
+    if (std::abs(s.x) > TOL<T>) {
+        inversaesc.x = T(1) / s.x;
     }
     else {
-        inversaesc.x = 0.0;
+        inversaesc.x = T(0);
     }
-    if (std::abs(s.y) > TOL) {
-        inversaesc.y = 1.0 / s.y;
+    if (std::abs(s.y) > TOL<T>) {
+        inversaesc.y = T(1) / s.y;
     }
     else {
-        inversaesc.y = 0.0;
+        inversaesc.y = T(0);
     }
-    if (std::abs(s.z) > TOL) {
-        inversaesc.z = 1.0 / s.z;
+    if (std::abs(s.z) > TOL<T>) {
+        inversaesc.z = T(1) / s.z;
     }
     else {
-        inversaesc.z = 0.0;
+        inversaesc.z = T(0);
     }
 
-    Matrix3x3 inversarot = R.Transposed();
+    TMatrix3x3<T> inversarot = R.Transposed();
 
-    Matrix3x3 inversaRS;
+    TMatrix3x3<T> inversaRS;
     for (int i = 0; i < 3; ++i) {
         inversaRS.At(0, i) = inversarot.At(0, i) * inversaesc.x;
         inversaRS.At(1, i) = inversarot.At(1, i) * inversaesc.y;
         inversaRS.At(2, i) = inversarot.At(2, i) * inversaesc.z;
     }
 
-    Vec3 invTrans = inversaRS.Multiply(t);
+    TVec3<T> invTrans = inversaRS.Multiply(t);
     invTrans.x = -invTrans.x;
     invTrans.y = -invTrans.y;
     invTrans.z = -invTrans.z;
@@ -246,27 +301,104 @@ Matrix4x4 Matrix4x4::InverseTRS() const
     M.At(0, 3) = invTrans.x;
     M.At(1, 3) = invTrans.y;
     M.At(2, 3) = invTrans.z;
-    M.At(3, 3) = 1.0;
+    M.At(3, 3) = T(1);
 
     return M;
 }
 
-Vec3 Matrix4x4::GetTranslation() const
+// The kernels work on the raw storage: for column-major matrices they invert the
+// transpose, which is the transpose of the inverse, i.e. the same matrix.
+template<typename T>
+static T InverseKernel(const T* m, T* out)
+{
+    if constexpr (std::is_same_v<T, double>) return Simd::Mat4Inverse(m, out);
+    else return Simd::Mat4InverseScalar(m, out);
+}
+
+template<typename T, MatrixLayout L>
+bool TMatrix4x4<T, L>::TryInverse(TMatrix4x4& out, T* det) const
+{
+    TMatrix4x4 R;
+    const T d = InverseKernel(m, R.m);
+    if (det) *det = d;
+    if (!std::isfinite(T(1) / d)) return false;
+    out = R;
+    return true;
+}
+
+template<typename T, MatrixLayout L>
+TMatrix4x4<T, L> TMatrix4x4<T, L>::Inverse() const
+{
+    TMatrix4x4 R;
+    if (!TryInverse(R)) {
+        throw std::runtime_error("La matriu no s invertible");
+    }
+    return R;
+}
+
+template<typename T, MatrixLayout L>
+TMatrix4x4<T, L> TMatrix4x4<T, L>::InverseTransposed() const
+{
+    const TMatrix4x4 I = Inverse();
+    TMatrix4x4 R;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            R.At(i, j) = I.At(j, i);
+        }
+    }
+    return R;
+}
+
+template<typename T, MatrixLayout L>
+TMatrix3x3<T> TMatrix4x4<T, L>::NormalMatrix() const
+{
+    TMatrix3x3<T> M;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            M.At(i, j) = At(i, j);
+        }
+    }
+    return M.InverseTransposed();
+}
+
+template<typename T, MatrixLayout L>
+std::size_t TMatrix4x4<T, L>::InverseBatch(std::span<const TMatrix4x4> in, std::span<TMatrix4x4> out, std::span<T> det)
+{
+    if (out.size() != in.size() || (!det.empty() && det.size() != in.size())) {
+        throw std::invalid_argument("InverseBatch: input and output sizes differ");
+    }
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < in.size(); ++i)
+    {
+        T d = InverseKernel(in[i].m, out[i].m);
+        if (!std::isfinite(T(1) / d)) {
+            out[i] = TMatrix4x4{};
+            d = T(0);
+            ++failed;
+        }
+        if (!det.empty()) det[i] = d;
+    }
+    return failed;
+}
+
+template<typename T, MatrixLayout L>
+TVec3<T> TMatrix4x4<T, L>::GetTranslation() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Vec3 result;
+    TVec3<T> result;
     result = { At(0, 3), At(1, 3), At(2, 3) };
     return result;
 }
 
-Matrix3x3 Matrix4x4::GetRotationScale() const
+template<typename T, MatrixLayout L>
+TMatrix3x3<T> TMatrix4x4<T, L>::GetRotationScale() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix3x3 M;
+    TMatrix3x3<T> M;
     for (int i = 0; i < 3; ++i) {
         for (int j = 0; j < 3; ++j) {
             M.At(i, j) = At(i, j);
@@ -275,39 +407,41 @@ Matrix3x3 Matrix4x4::GetRotationScale() const
     return M;
 }
 
-Vec3 Matrix4x4::GetScale() const
+template<typename T, MatrixLayout L>
+TVec3<T> TMatrix4x4<T, L>::GetScale() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Vec3 X(At(0, 0), At(1, 0), At(2, 0));
-    Vec3 Y(At(0, 1), At(1, 1), At(2, 1));
-    Vec3 Z(At(0, 2), At(1, 2), At(2, 2));
-    Vec3 result(X.Norm(), Y.Norm(), Z.Norm());
+    TVec3<T> X(At(0, 0), At(1, 0), At(2, 0));
+    TVec3<T> Y(At(0, 1), At(1, 1), At(2, 1));
+    TVec3<T> Z(At(0, 2), At(1, 2), At(2, 2));
+    TVec3<T> result(X.Norm(), Y.Norm(), Z.Norm());
 	return result;
 }
 
-Matrix3x3 Matrix4x4::GetRotation() const
+template<typename T, MatrixLayout L>
+TMatrix3x3<T> TMatrix4x4<T, L>::GetRotation() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix3x3 M;
-    Vec3 s = GetScale();
+    TMatrix3x3<T> M;
+    TVec3<T> s = GetScale();
 
-    if (std::abs(s.x) > TOL) {
+    if (std::abs(s.x) > TOL<T>) {
         M.At(0, 0) = At(0, 0) / s.x;
         M.At(1, 0) = At(1, 0) / s.x;
         M.At(2, 0) = At(2, 0) / s.x;
     }
 
-    if (std::abs(s.y) > TOL) {
+    if (std::abs(s.y) > TOL<T>) {
         M.At(0, 1) = At(0, 1) / s.y;
         M.At(1, 1) = At(1, 1) / s.y;
         M.At(2, 1) = At(2, 1) / s.y;
     }
 
-    if (std::abs(s.z) > TOL) {
+    if (std::abs(s.z) > TOL<T>) {
         M.At(0, 2) = At(0, 2) / s.z;
         M.At(1, 2) = At(1, 2) / s.z;
         M.At(2, 2) = At(2, 2) / s.z;
@@ -315,19 +449,44 @@ Matrix3x3 Matrix4x4::GetRotation() const
     return M;
 }
 
-Quat Matrix4x4::GetRotationQuat() const
+template<typename T, MatrixLayout L>
+TQuat<T> TMatrix4x4<T, L>::GetRotationQuat() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix3x3 M;
-    Quat R;
+    TMatrix3x3<T> M;
+    TQuat<T> R;
     M = GetRotation();
-    R = Quat::FromMatrix3x3(M);
+    R = TQuat<T>::FromMatrix3x3(M);
 	return R;
 }
 
-void Matrix4x4::SetTranslation(const Vec3& t)
+template<typename T, MatrixLayout L>
+bool TMatrix4x4<T, L>::Decompose(TVec3<T>& t, TQuat<T>& q, TVec3<T>& s, DecomposeMode mode, TVec3<T>* shear) const
+{
+    if (!IsAffine()) {
+        throw std::runtime_error("La matriu no s af");
+    }
+    return TAffine3x4<T>::FromMatrix4x4(*this).Decompose(t, q, s, mode, shear);
+}
+
+template<typename T, MatrixLayout L>
+std::size_t TMatrix4x4<T, L>::DecomposeBatch(std::span<const TMatrix4x4> m, std::span<TVec3<T>> t,
+    std::span<TQuat<T>> q, std::span<TVec3<T>> s, DecomposeMode mode)
+{
+    if (t.size() != m.size() || q.size() != m.size() || s.size() != m.size()) {
+        throw std::invalid_argument("DecomposeBatch: input and output sizes differ");
+    }
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < m.size(); ++i) {
+        if (!m[i].Decompose(t[i], q[i], s[i], mode)) ++failed;
+    }
+    return failed;
+}
+
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::SetTranslation(const TVec3<T>& t)
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
@@ -337,15 +496,16 @@ void Matrix4x4::SetTranslation(const Vec3& t)
     At(2, 3) = t.z;
 }
 
-void Matrix4x4::SetScale(const Vec3& s)
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::SetScale(const TVec3<T>& s)
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix3x3 M;
+    TMatrix3x3<T> M;
     M = GetRotation();
 
-    double escala[3] = { s.x, s.y, s.z };
+    T escala[3] = { s.x, s.y, s.z };
 
     for (int j = 0; j < 3; ++j) {
         for (int i = 0; i < 3; ++i) {
@@ -354,23 +514,25 @@ void Matrix4x4::SetScale(const Vec3& s)
     }
 }
 
-void Matrix4x4::SetRotation(const Matrix3x3& R)
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::SetRotation(const TMatrix3x3<T>& R)
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Vec3 s = GetScale();
-    double escala[3] = { s.x, s.y, s.z };
+    TVec3<T> s = GetScale();
+    T escala[3] = { s.x, s.y, s.z };
 
     for (int j = 0; j < 3; ++j) {
         for (int i = 0; i < 3; ++i) {
             At(i, j) = R.At(i, j) * escala[j];
         }
     }
-    
+
 }
 
-void Matrix4x4::SetRotation(const Quat& q)
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::SetRotation(const TQuat<T>& q)
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
@@ -378,7 +540,8 @@ void Matrix4x4::SetRotation(const Quat& q)
     SetRotation(q.ToMatrix3x3());
 }
 
-void Matrix4x4::SetRotationScale(const Matrix3x3& RS)
+template<typename T, MatrixLayout L>
+void TMatrix4x4<T, L>::SetRotationScale(const TMatrix3x3<T>& RS)
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
@@ -388,4 +551,9 @@ void Matrix4x4::SetRotationScale(const Matrix3x3& RS)
             At(i, j) = RS.At(i, j);
         }
     }
-}
\ No newline at end of file
+}
+
+template struct TMatrix4x4<double, MatrixLayout::RowMajor>;
+template struct TMatrix4x4<double, MatrixLayout::ColumnMajor>;
+template struct TMatrix4x4<float, MatrixLayout::RowMajor>;
+template struct TMatrix4x4<float, MatrixLayout::ColumnMajor>;
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "Picker.hpp"
+#include "Simd.hpp"
+#include <chrono>
+#include <stdexcept>
+
+PickMesh PickMesh::FromIndexed(std::span<const float> positions, std::span<const unsigned> indices)
+{
+    const std::size_t vertices = positions.size() / 3;
+    PickMesh mesh;
+    mesh.count = indices.size() / 3;
+    mesh.triangles.resize(9 * mesh.count);
+    const std::size_t n = mesh.count;
+    auto vertex = [&](unsigned k) {
+        if (k >= vertices) throw std::out_of_range("PickMesh::FromIndexed: vertex index out of range");
+        return Vec3{ positions[3 * k], positions[3 * k + 1], positions[3 * k + 2] };
+    };
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Vec3 v0 = vertex(indices[3 * i]), v1 = vertex(indices[3 * i + 1]), v2 = vertex(indices[3 * i + 2]);
+        const double values[9] = { v0.x, v0.y, v0.z,
+            v1.x - v0.x, v1.y - v0.y, v1.z - v0.z,
+            v2.x - v0.x, v2.y - v0.y, v2.z - v0.z };
+        for (int k = 0; k < 9; ++k) mesh.triangles[k * n + i] = values[k];
+        mesh.bounds = mesh.bounds.Merge(v0).Merge(v1).Merge(v2);
+    }
+    return mesh;
+}
+
+bool PickMesh::Raycast(const Ray& ray, double& t, std::size_t& triangle) const
+{
+    const double r[6] = { ray.origin.x, ray.origin.y, ray.origin.z, ray.direction.x, ray.direction.y, ray.direction.z };
+    const std::size_t i = Simd::IntersectRayTrianglesSoA(r, triangles.data(), count, t);
+    if (i == count) return false;
+    triangle = i;
+    return true;
+}
+
+Ray Picker::ScreenRay(const Matrix4x4& inverseViewProjection, double ndcX, double ndcY)
+{
+    const Vec3 nearPoint = inverseViewProjection.TransformPoint({ ndcX, ndcY, -1.0 });
+    const Vec3 farPoint = inverseViewProjection.TransformPoint({ ndcX, ndcY, 1.0 });
+    return Ray::FromOriginDirection(nearPoint,
+        { farPoint.x - nearPoint.x, farPoint.y - nearPoint.y, farPoint.z - nearPoint.z });
+}
+
+Ray Picker::ScreenRay(const Matrix4x4& inverseViewProjection, double x, double y, double width, double height)
+{
+    return ScreenRay(inverseViewProjection, 2.0 * x / width - 1.0, 1.0 - 2.0 * y / height);
+}
+
+bool Picker::Pick(const Scene& scene, const BVH& bvh, std::span<const PickMesh> meshes, const Ray& ray, double tMax,
+    Hit& hit)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    stats = {};
+    const std::span<const Affine3x4> world = scene.World();
+    const std::span<const uint32_t> mesh = scene.Meshes();
+    std::size_t nearestTriangle = 0;
+
+    auto exact = [&](GameObjectHandle object, double tNear, double& t) {
+        ++stats.objectsTested;
+        const GameObject* node = scene.Resolve(object);
+        if (!node) return false;
+        const std::size_t i = node->GetIndex();
+        const uint32_t m = mesh[i];
+        if (m >= meshes.size() || meshes[m].TriangleCount() == 0)
+        {
+            t = tNear;
+            nearestTriangle = 0;
+            return true;
+        }
+        // Same t in mesh space: the direction is transformed, not normalized
+        const Affine3x4 inverse = world[i].Inverse();
+        const Ray local = Ray::FromOriginDirection(inverse.TransformPoint(ray.origin),
+            inverse.TransformVector(ray.direction));
+        stats.trianglesTested += meshes[m].TriangleCount();
+        return meshes[m].Raycast(local, t, nearestTriangle);
+    };
+
+    BVH::RayHit found;
+    const bool any = bvh.Raycast(ray, tMax, found, exact);
+    if (any) hit = { found.object, found.t, ray.At(found.t), nearestTriangle };
+    stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return any;
+}
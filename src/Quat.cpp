@@ -1,127 +1,144 @@
 #include "Quat.hpp"
+#include "FastMath.hpp"
+#include <algorithm>
+#include <cassert>
 #include <stdexcept>
+#include <type_traits>
 
-#define TOL 1e-6
+// Tolerance scaled to the precision of T
+template<typename T>
+static constexpr T TOL = std::is_same_v<T, float> ? T(1e-4) : T(1e-6);
 #define PI 3.14159265358979323846
 
-Quat Quat::FromAxisAngle(const Vec3& u_in, double phi)
+#if !MATH_INLINE_CORE
+#include "Quat.inl"
+#endif
+
+template<typename T>
+TQuat<T> TQuat<T>::FromAxisAngle(const TVec3<T>& u_in, T phi)
 {
-    Vec3 u = u_in.Normalize();
-    double half = 0.5 * phi;
-    double c = std::cos(half);
-    double s = std::sin(half);
-    return Quat{ c, u.x * s, u.y * s, u.z * s };
+    TVec3<T> u = u_in.Normalize();
+    T s, c;
+    FastMath::SinCos(T(0.5) * phi, s, c);
+    return TQuat{ c, u.x * s, u.y * s, u.z * s };
 }
 
-Quat Quat::Normalized() const
+template<typename T>
+TQuat<T> TQuat<T>::Normalized() const
 {
-    double n2 = s * s + x * x + y * y + z * z;
-    double n = std::sqrt(n2);
-    if (n == 0) throw std::invalid_argument("Quat::Normalized: zero norm");
-    return { s / n, x / n, y / n, z / n };
+    T n2 = s * s + x * x + y * y + z * z;
+    if (n2 == 0) throw std::invalid_argument("Quat::Normalized: zero norm");
+    T inv = FastMath::Rsqrt(n2);
+    return { s * inv, x * inv, y * inv, z * inv };
 }
 
-Quat Quat::Multiply(const Quat& b) const
+template<typename T>
+TVec3<T> TQuat<T>::Rotate(const TVec3<T>& v) const
 {
-    const Quat& a = *this;
-    Quat q;
-    q.s = a.s * b.s - a.x * b.x - a.y * b.y - a.z * b.z;
-    q.x = a.s * b.x + a.x * b.s + a.y * b.z - a.z * b.y;
-    q.y = a.s * b.y - a.x * b.z + a.y * b.s + a.z * b.x;
-    q.z = a.s * b.z + a.x * b.y - a.y * b.x + a.z * b.s;
-    return q;
+    TVec3<T> qv{ x, y, z };
+    TVec3<T> t = TVec3<T>::Cross(qv, v);
+    t.x *= T(2); t.y *= T(2); t.z *= T(2);
+    TVec3<T> st{ s * t.x, s * t.y, s * t.z };
+    TVec3<T> cqt = TVec3<T>::Cross(qv, t);
+    TVec3<T> w{ v.x + st.x + cqt.x, v.y + st.y + cqt.y, v.z + st.z + cqt.z };
+    return w;
 }
 
-Vec3 Quat::Rotate(const Vec3& v) const
+template<typename T>
+TMatrix3x3<T> TQuat<T>::ToMatrix3x3() const
 {
-    Vec3 qv{ x, y, z };
-    Vec3 t = Vec3::Cross(qv, v);
-    t.x *= 2.0; t.y *= 2.0; t.z *= 2.0;
-    Vec3 st{ s * t.x, s * t.y, s * t.z };
-    Vec3 cqt = Vec3::Cross(qv, t);
-    Vec3 w{ v.x + st.x + cqt.x, v.y + st.y + cqt.y, v.z + st.z + cqt.z };
-    return w;
+    return Normalized().ToMatrix3x3Unchecked();
 }
 
-Matrix3x3 Quat::ToMatrix3x3() const
+template<typename T>
+TMatrix3x3<T> TQuat<T>::ToMatrix3x3Unchecked() const
 {
-    Quat q = this->Normalized();
-    const double ww = q.s, xx = q.x, yy = q.y, zz = q.z;
+    assert(std::fabs(s * s + x * x + y * y + z * z - T(1)) < T(100) * TOL<T> && "ToMatrix3x3Unchecked: quaternion not unit");
+    const T ww = s, xx = x, yy = y, zz = z;
 
-    Matrix3x3 R{};
-    const double xx2 = xx * xx, yy2 = yy * yy, zz2 = zz * zz;
-    const double xy2 = xx * yy, xz2 = xx * zz, yz2 = yy * zz;
-    const double sx2 = ww * xx, sy2 = ww * yy, sz2 = ww * zz;
+    TMatrix3x3<T> R{};
+    const T xx2 = xx * xx, yy2 = yy * yy, zz2 = zz * zz;
+    const T xy2 = xx * yy, xz2 = xx * zz, yz2 = yy * zz;
+    const T sx2 = ww * xx, sy2 = ww * yy, sz2 = ww * zz;
 
-    R.At(0, 0) = 1.0 - 2.0 * (yy2 + zz2);
-    R.At(0, 1) = 2.0 * (xy2 - sz2);
-    R.At(0, 2) = 2.0 * (xz2 + sy2);
+    R.At(0, 0) = T(1) - T(2) * (yy2 + zz2);
+    R.At(0, 1) = T(2) * (xy2 - sz2);
+    R.At(0, 2) = T(2) * (xz2 + sy2);
 
-    R.At(1, 0) = 2.0 * (xy2 + sz2);
-    R.At(1, 1) = 1.0 - 2.0 * (xx2 + zz2);
-    R.At(1, 2) = 2.0 * (yz2 - sx2);
+    R.At(1, 0) = T(2) * (xy2 + sz2);
+    R.At(1, 1) = T(1) - T(2) * (xx2 + zz2);
+    R.At(1, 2) = T(2) * (yz2 - sx2);
 
-    R.At(2, 0) = 2.0 * (xz2 - sy2);
-    R.At(2, 1) = 2.0 * (yz2 + sx2);
-    R.At(2, 2) = 1.0 - 2.0 * (xx2 + yy2);
+    R.At(2, 0) = T(2) * (xz2 - sy2);
+    R.At(2, 1) = T(2) * (yz2 + sx2);
+    R.At(2, 2) = T(1) - T(2) * (xx2 + yy2);
     return R;
 }
 
-Quat Quat::FromMatrix3x3(const Matrix3x3& R)
+template<typename T>
+TQuat<T> TQuat<T>::FromMatrix3x3(const TMatrix3x3<T>& R)
 {
     if (!R.IsRotation()) throw std::invalid_argument("FromMatrix3x3: input not rotation");
+    return FromMatrix3x3Unchecked(R);
+}
 
-    Quat q;
-    double tr = R.At(0, 0) + R.At(1, 1) + R.At(2, 2);
+template<typename T>
+TQuat<T> TQuat<T>::FromMatrix3x3Unchecked(const TMatrix3x3<T>& R)
+{
+    assert(R.IsRotation() && "FromMatrix3x3Unchecked: input not rotation");
+
+    TQuat q;
+    T tr = R.At(0, 0) + R.At(1, 1) + R.At(2, 2);
 
-    if (tr > 0.0)
+    if (tr > T(0))
     {
-        double S = std::sqrt(tr + 1.0) * 2.0;
-        q.s = 0.25 * S;
+        T S = std::sqrt(tr + T(1)) * T(2);
+        q.s = T(0.25) * S;
         q.x = (R.At(2, 1) - R.At(1, 2)) / S;
         q.y = (R.At(0, 2) - R.At(2, 0)) / S;
         q.z = (R.At(1, 0) - R.At(0, 1)) / S;
     }
     else if (R.At(0, 0) > R.At(1, 1) && R.At(0, 0) > R.At(2, 2))
     {
-        double S = std::sqrt(1.0 + R.At(0, 0) - R.At(1, 1) - R.At(2, 2)) * 2.0;
+        T S = std::sqrt(T(1) + R.At(0, 0) - R.At(1, 1) - R.At(2, 2)) * T(2);
         q.s = (R.At(2, 1) - R.At(1, 2)) / S;
-        q.x = 0.25 * S;
+        q.x = T(0.25) * S;
         q.y = (R.At(0, 1) + R.At(1, 0)) / S;
         q.z = (R.At(0, 2) + R.At(2, 0)) / S;
     }
     else if (R.At(1, 1) > R.At(2, 2))
     {
-        double S = std::sqrt(1.0 - R.At(0, 0) + R.At(1, 1) - R.At(2, 2)) * 2.0;
+        T S = std::sqrt(T(1) - R.At(0, 0) + R.At(1, 1) - R.At(2, 2)) * T(2);
         q.s = (R.At(0, 2) - R.At(2, 0)) / S;
         q.x = (R.At(0, 1) + R.At(1, 0)) / S;
-        q.y = 0.25 * S;
+        q.y = T(0.25) * S;
         q.z = (R.At(1, 2) + R.At(2, 1)) / S;
     }
     else
     {
-        double S = std::sqrt(1.0 - R.At(0, 0) - R.At(1, 1) + R.At(2, 2)) * 2.0;
+        T S = std::sqrt(T(1) - R.At(0, 0) - R.At(1, 1) + R.At(2, 2)) * T(2);
         q.s = (R.At(1, 0) - R.At(0, 1)) / S;
         q.x = (R.At(0, 2) + R.At(2, 0)) / S;
         q.y = (R.At(1, 2) + R.At(2, 1)) / S;
-        q.z = 0.25 * S;
+        q.z = T(0.25) * S;
     }
 
     return q.Normalized();
 }
 
-void Quat::ToAxisAngle(Vec3& axis, double& angle) const
+template<typename T>
+void TQuat<T>::ToAxisAngle(TVec3<T>& axis, T& angle) const
 {
-    Quat q = this->Normalized();
+    TQuat q = this->Normalized();
 
-    angle = 2.0 * std::acos(q.s);
+    angle = T(2) * FastMath::Acos(q.s);
 
-    double sin_half = std::sqrt(std::max(0.0, 1.0 - q.s * q.s));
+    T sin_half = std::sqrt(std::max(T(0), T(1) - q.s * q.s));
 
-    if (sin_half < TOL)
+    if (sin_half < TOL<T>)
     {
         axis = { 1, 0, 0 };
-        angle = 0.0;
+        angle = T(0);
         return;
     }
 
@@ -129,47 +146,259 @@ void Quat::ToAxisAngle(Vec3& axis, double& angle) const
     axis = axis.Normalize();
 }
 
-Quat Quat::RotateFromTo(const Vec3& u, const Vec3& v)
+template<typename T>
+TQuat<T> TQuat<T>::RotateFromTo(const TVec3<T>& u, const TVec3<T>& v)
 {
-    Vec3 a{ u.Normalize()};
-    Vec3 b{ v.Normalize()};
+    TVec3<T> a{ u.Normalize()};
+    TVec3<T> b{ v.Normalize()};
 
-    double dot = Vec3::Dot(a, b);
+    T dot = TVec3<T>::Dot(a, b);
 
-    if (std::fabs(dot - 1.0) < TOL) {
-        return Quat{}; // (1,0,0,0)
+    if (std::fabs(dot - T(1)) < TOL<T>) {
+        return TQuat{}; // (1,0,0,0)
     }
 
-    if (std::fabs(dot + 1.0) < TOL) {
-        Vec3 arbitrary = (std::fabs(a.x) < 0.9) ? Vec3{ 1,0,0 } : Vec3{ 0,1,0 };
-        Vec3 axis = Vec3::Cross(a, arbitrary).Normalize();
-        return FromAxisAngle(axis, PI);
+    if (std::fabs(dot + T(1)) < TOL<T>) {
+        TVec3<T> arbitrary = (std::fabs(a.x) < T(0.9)) ? TVec3<T>{ 1,0,0 } : TVec3<T>{ 0,1,0 };
+        TVec3<T> axis = TVec3<T>::Cross(a, arbitrary).Normalize();
+        return FromAxisAngle(axis, T(PI));
     }
 
-    Vec3 axis = Vec3::Cross(a, b).Normalize();
-    double angle = std::acos(dot);
+    TVec3<T> axis = TVec3<T>::Cross(a, b).Normalize();
+    T angle = FastMath::Acos(dot);
     return FromAxisAngle(axis, angle);
 }
 
-Quat Quat::RotateToTarget(const Quat& initialRot, const Quat& finalRot)
+template<typename T>
+TQuat<T> TQuat<T>::RotateToTarget(const TQuat& initialRot, const TQuat& finalRot)
 {
-    Quat qi = initialRot.Normalized();
-    Quat qf = finalRot.Normalized();
+    TQuat qi = initialRot.Normalized();
+    TQuat qf = finalRot.Normalized();
 
-    Quat qi_conj{ qi.s, -qi.x, -qi.y, -qi.z };
+    TQuat qi_conj{ qi.s, -qi.x, -qi.y, -qi.z };
 
-    Quat qdelta = qf.Multiply(qi_conj);
+    TQuat qdelta = qf.Multiply(qi_conj);
     return qdelta.Normalized();
 }
 
-Quat Quat::FromEulerZYX(double yaw, double pitch, double roll)
+template<typename T>
+TQuat<T> TQuat<T>::FromEulerZYX(T yaw, T pitch, T roll)
+{
+    // q = qz(yaw) * qy(pitch) * qx(roll)
+    T cy, sy, cp, sp, cr, sr;
+    FastMath::SinCos(yaw * T(0.5), sy, cy);
+    FastMath::SinCos(pitch * T(0.5), sp, cp);
+    FastMath::SinCos(roll * T(0.5), sr, cr);
+
+    TQuat q;
+    q.s = cr * cp * cy + sr * sp * sy;
+    q.x = sr * cp * cy - cr * sp * sy;
+    q.y = cr * sp * cy + sr * cp * sy;
+    q.z = cr * cp * sy - sr * sp * cy;
+    return q;
+}
+
+template<typename T>
+void TQuat<T>::ToEulerZYX(T& yaw, T& pitch, T& roll) const
+{
+    // Entries of ToMatrix3x3() scaled by |q|^2, so non-unit quaternions need no
+    // normalization: atan2 ignores the common factor and r20 is divided by n2.
+    const T n2 = s * s + x * x + y * y + z * z;
+    if (n2 == T(0)) throw std::invalid_argument("Quat::ToEulerZYX: zero norm");
+
+    const T r20 = T(2) * (x * z - s * y) / n2;
+
+    if (std::fabs(r20) < T(1) - TOL<T>)
+    {
+        pitch = std::asin(-r20);
+        yaw = std::atan2(T(2) * (x * y + s * z), s * s + x * x - y * y - z * z);
+        roll = std::atan2(T(2) * (y * z + s * x), s * s - x * x - y * y + z * z);
+    }
+    else
+    {
+        pitch = (r20 < T(0)) ? T(+PI / 2) : T(-PI / 2);
+        yaw = std::atan2(-T(2) * (x * y - s * z), s * s - x * x + y * y - z * z);
+        roll = T(0);
+    }
+}
+
+// ------------------ Slerp ----------------
+
+// Above this dot product Exact falls back to the normalized lerp (sin(theta) ~ 0).
+// For double that is theta < 5e-4 rad, where nlerp is off by less than 1e-11 rad.
+template<typename T>
+static constexpr T SLERP_DOT_THRESHOLD = std::is_same_v<T, float> ? T(0.9995) : T(1 - 1e-7);
+
+// Shortest path: flips b when the dot product is negative. Returns |dot|.
+template<typename T>
+static T AlignForSlerp(const TQuat<T>& a, TQuat<T>& b)
+{
+    T dot = a.s * b.s + a.x * b.x + a.y * b.y + a.z * b.z;
+    if (dot < T(0)) {
+        b = { -b.s, -b.x, -b.y, -b.z };
+        dot = -dot;
+    }
+    return dot;
+}
+
+template<typename T>
+static TQuat<T> Blend(const TQuat<T>& a, const TQuat<T>& b, T wa, T wb)
 {
-    Matrix3x3 R = Matrix3x3::FromEulerZYX(yaw, pitch, roll);
-    return FromMatrix3x3(R);
+    return { wa * a.s + wb * b.s, wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z };
 }
 
-void Quat::ToEulerZYX(double& yaw, double& pitch, double& roll) const
+template<typename T>
+static TQuat<T> NormalizedLerp(const TQuat<T>& a, const TQuat<T>& b, T t)
 {
-    Matrix3x3 R = ToMatrix3x3();
-    R.ToEulerZYX(yaw, pitch, roll);
-}
\ No newline at end of file
+    TQuat<T> q = Blend(a, b, T(1) - t, t);
+    const T inv = FastMath::Rsqrt(q.s * q.s + q.x * q.x + q.y * q.y + q.z * q.z);
+    return { q.s * inv, q.x * inv, q.y * inv, q.z * inv };
+}
+
+// Corrected nlerp (fit by A. Kapoulkine): nlerp runs ahead of slerp near the ends and
+// behind it in the middle; warping t with a polynomial in t and dot cancels most of it.
+template<typename T>
+static TQuat<T> CorrectedLerp(const TQuat<T>& a, const TQuat<T>& b, T dot, T t)
+{
+    const T A = T(1.0904) + dot * (T(-3.2452) + dot * (T(3.55645) - dot * T(1.43519)));
+    const T B = T(0.848013) + dot * (T(-1.06021) + dot * T(0.215638));
+    const T h = t - T(0.5);
+    const T k = A * h * h + B;
+    const T ot = t + t * h * (t - T(1)) * k;
+    return NormalizedLerp(a, b, ot);
+}
+
+template<typename T>
+static void AssertUnit(const TQuat<T>& q)
+{
+    (void)q;
+    assert(std::fabs(q.s * q.s + q.x * q.x + q.y * q.y + q.z * q.z - T(1)) < T(100) * TOL<T> && "Slerp: quaternion not unit");
+}
+
+template<typename T>
+TQuat<T> TQuat<T>::Slerp(const TQuat& a, const TQuat& b_in, T t, SlerpMode mode)
+{
+    AssertUnit(a);
+    AssertUnit(b_in);
+    TQuat b = b_in;
+    const T dot = AlignForSlerp(a, b);
+
+    if (mode == SlerpMode::Fast) return CorrectedLerp(a, b, dot, t);
+    if (dot > SLERP_DOT_THRESHOLD<T>) return NormalizedLerp(a, b, t);
+
+    const T theta = FastMath::Acos(dot);
+    T sinTheta, cosTheta, sinT, cosT;
+    FastMath::SinCos(theta, sinTheta, cosTheta);
+    FastMath::SinCos(theta * t, sinT, cosT);
+
+    const T wb = sinT / sinTheta;
+    return Blend(a, b, cosT - dot * wb, wb);
+}
+
+template<typename T, typename TAt>
+static void SlerpBatchImpl(std::span<const TQuat<T>> a, std::span<const TQuat<T>> b, TAt tAt,
+    std::span<TQuat<T>> out, SlerpMode mode)
+{
+    const std::size_t n = a.size();
+    if (mode == SlerpMode::Fast)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            TQuat<T> bi = b[i];
+            const T dot = AlignForSlerp(a[i], bi);
+            out[i] = CorrectedLerp(a[i], bi, dot, tAt(i));
+        }
+        return;
+    }
+
+    // Blocks: dot products, then acos and sin/cos of the whole block in bulk
+    constexpr std::size_t BLOCK = 256;
+    T dot[BLOCK], theta[BLOCK], angle[BLOCK], sinTheta[BLOCK], cosTheta[BLOCK], sinT[BLOCK], cosT[BLOCK];
+    TQuat<T> bb[BLOCK];
+    for (std::size_t i0 = 0; i0 < n; i0 += BLOCK)
+    {
+        const std::size_t m = std::min(BLOCK, n - i0);
+        for (std::size_t j = 0; j < m; ++j) {
+            bb[j] = b[i0 + j];
+            dot[j] = AlignForSlerp(a[i0 + j], bb[j]);
+        }
+        FastMath::Acos(std::span<const T>(dot, m), std::span<T>(theta, m));
+        for (std::size_t j = 0; j < m; ++j) angle[j] = theta[j] * tAt(i0 + j);
+        FastMath::SinCos(std::span<const T>(theta, m), std::span<T>(sinTheta, m), std::span<T>(cosTheta, m));
+        FastMath::SinCos(std::span<const T>(angle, m), std::span<T>(sinT, m), std::span<T>(cosT, m));
+
+        for (std::size_t j = 0; j < m; ++j)
+        {
+            const TQuat<T>& ai = a[i0 + j];
+            if (dot[j] > SLERP_DOT_THRESHOLD<T>) {
+                out[i0 + j] = NormalizedLerp(ai, bb[j], tAt(i0 + j));
+                continue;
+            }
+            const T wb = sinT[j] / sinTheta[j];
+            out[i0 + j] = Blend(ai, bb[j], cosT[j] - dot[j] * wb, wb);
+        }
+    }
+}
+
+template<typename T>
+void TQuat<T>::SlerpBatch(std::span<const TQuat> a, std::span<const TQuat> b, T t,
+    std::span<TQuat> out, SlerpMode mode)
+{
+    if (b.size() != a.size() || out.size() != a.size()) {
+        throw std::invalid_argument("SlerpBatch: input and output sizes differ");
+    }
+    SlerpBatchImpl<T>(a, b, [t](std::size_t) { return t; }, out, mode);
+}
+
+template<typename T>
+void TQuat<T>::SlerpBatch(std::span<const TQuat> a, std::span<const TQuat> b, std::span<const T> t,
+    std::span<TQuat> out, SlerpMode mode)
+{
+    if (b.size() != a.size() || t.size() != a.size() || out.size() != a.size()) {
+        throw std::invalid_argument("SlerpBatch: input and output sizes differ");
+    }
+    SlerpBatchImpl<T>(a, b, [t](std::size_t i) { return t[i]; }, out, mode);
+}
+
+template<typename T>
+TSlerpStepper<T>::TSlerpStepper(const TQuat<T>& a, const TQuat<T>& b, int steps_)
+    : current(a), end(b), step(0), steps(steps_)
+{
+    if (steps <= 0) throw std::invalid_argument("SlerpStepper: steps must be positive");
+    AssertUnit(a);
+    AssertUnit(b);
+
+    // rel = a^-1 b = (cos(theta/2), u sin(theta/2)), shortest path
+    TQuat<T> rel = TQuat<T>{ a.s, -a.x, -a.y, -a.z } * b;
+    if (rel.s < T(0)) rel = { -rel.s, -rel.x, -rel.y, -rel.z };
+
+    const T sinHalf = std::sqrt(rel.x * rel.x + rel.y * rel.y + rel.z * rel.z);
+    const T half = std::atan2(sinHalf, rel.s);
+    if (sinHalf == T(0)) {
+        delta = TQuat<T>{};
+        return;
+    }
+    T s, c;
+    FastMath::SinCos(half / T(steps), s, c);
+    const T k = s / sinHalf;
+    delta = { c, rel.x * k, rel.y * k, rel.z * k };
+}
+
+template<typename T>
+const TQuat<T>& TSlerpStepper<T>::Next()
+{
+    if (step >= steps) return current;
+    if (++step == steps) {
+        current = end;
+        return current;
+    }
+    TQuat<T> q = current * delta;
+    // One Newton step towards unit length: |q| is 1 + O(eps), so no sqrt is needed
+    const T k = T(0.5) * (T(3) - (q.s * q.s + q.x * q.x + q.y * q.y + q.z * q.z));
+    current = { q.s * k, q.x * k, q.y * k, q.z * k };
+    return current;
+}
+
+template struct TQuat<float>;
+template struct TQuat<double>;
+template struct TSlerpStepper<float>;
+template struct TSlerpStepper<double>;
\ No newline at end of file
@@ -0,0 +1,402 @@
+#include "QuatBatch.hpp"
+#include "FastMath.hpp"
+#include "Simd.hpp"
+#include <stdexcept>
+
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
+// The kernels work on raw component arrays and return how many elements they
+// processed (a multiple of the vector width); the scalar loop finishes the tail.
+// Every lane is loaded before its store, so outputs may alias the inputs.
+
+// ------------------ Scalar ----------------
+
+template<typename T>
+static void MultiplyScalar(const T* as, const T* ax, const T* ay, const T* az, bool broadcastA,
+    const T* bs, const T* bx, const T* by, const T* bz,
+    T* os, T* ox, T* oy, T* oz, std::size_t begin, std::size_t n)
+{
+    for (std::size_t i = begin; i < n; ++i)
+    {
+        const std::size_t k = broadcastA ? 0 : i;
+        const TQuat<T> q = TQuat<T>{ as[k], ax[k], ay[k], az[k] }.Multiply({ bs[i], bx[i], by[i], bz[i] });
+        os[i] = q.s; ox[i] = q.x; oy[i] = q.y; oz[i] = q.z;
+    }
+}
+
+template<typename T>
+static void RotateScalar(const T* qs, const T* qx, const T* qy, const T* qz,
+    const T* vx, const T* vy, const T* vz, T* ox, T* oy, T* oz, std::size_t begin, std::size_t n)
+{
+    for (std::size_t i = begin; i < n; ++i)
+    {
+        const T tx = T(2) * (qy[i] * vz[i] - qz[i] * vy[i]);
+        const T ty = T(2) * (qz[i] * vx[i] - qx[i] * vz[i]);
+        const T tz = T(2) * (qx[i] * vy[i] - qy[i] * vx[i]);
+        const T rx = vx[i] + qs[i] * tx + (qy[i] * tz - qz[i] * ty);
+        const T ry = vy[i] + qs[i] * ty + (qz[i] * tx - qx[i] * tz);
+        const T rz = vz[i] + qs[i] * tz + (qx[i] * ty - qy[i] * tx);
+        ox[i] = rx; oy[i] = ry; oz[i] = rz;
+    }
+}
+
+template<typename T>
+static void NormalizeScalar(const T* qs, const T* qx, const T* qy, const T* qz,
+    T* os, T* ox, T* oy, T* oz, std::size_t begin, std::size_t n)
+{
+    for (std::size_t i = begin; i < n; ++i)
+    {
+        const T n2 = qs[i] * qs[i] + qx[i] * qx[i] + qy[i] * qy[i] + qz[i] * qz[i];
+        if (n2 == T(0)) throw std::invalid_argument("QuatBatch::Normalize: zero norm");
+        const T inv = FastMath::Rsqrt(n2);
+        os[i] = qs[i] * inv; ox[i] = qx[i] * inv; oy[i] = qy[i] * inv; oz[i] = qz[i] * inv;
+    }
+}
+
+template<typename T>
+static void ToMatrix3x3Scalar(const T* qs, const T* qx, const T* qy, const T* qz,
+    TMatrix3x3<T>* out, std::size_t begin, std::size_t n)
+{
+    for (std::size_t i = begin; i < n; ++i) {
+        out[i] = TQuat<T>{ qs[i], qx[i], qy[i], qz[i] }.ToMatrix3x3Unchecked();
+    }
+}
+
+#if SIMD_X86
+// ------------------ AVX2 + FMA ----------------
+
+// Thin wrappers so each kernel is written once for double (4 lanes) and float (8 lanes)
+template<typename T> struct Avx2;
+
+template<> struct Avx2<double>
+{
+    using V = __m256d;
+    static constexpr std::size_t N = 4;
+    SIMD_TARGET("avx2,fma") static V Load(const double* p) { return _mm256_loadu_pd(p); }
+    SIMD_TARGET("avx2,fma") static void Store(double* p, V v) { _mm256_storeu_pd(p, v); }
+    SIMD_TARGET("avx2,fma") static V Set1(double a) { return _mm256_set1_pd(a); }
+    SIMD_TARGET("avx2,fma") static V Add(V a, V b) { return _mm256_add_pd(a, b); }
+    SIMD_TARGET("avx2,fma") static V Sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    SIMD_TARGET("avx2,fma") static V Mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    SIMD_TARGET("avx2,fma") static V FMAdd(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }     // a * b + c
+    SIMD_TARGET("avx2,fma") static V FNMAdd(V a, V b, V c) { return _mm256_fnmadd_pd(a, b, c); }   // c - a * b
+    SIMD_TARGET("avx2,fma") static V Neg(V a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+    SIMD_TARGET("avx2,fma") static V Rsqrt(V a) { return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(a)); }
+    SIMD_TARGET("avx2,fma") static bool AnyZero(V a) { return _mm256_movemask_pd(_mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_EQ_OQ)) != 0; }
+};
+
+template<> struct Avx2<float>
+{
+    using V = __m256;
+    static constexpr std::size_t N = 8;
+    SIMD_TARGET("avx2,fma") static V Load(const float* p) { return _mm256_loadu_ps(p); }
+    SIMD_TARGET("avx2,fma") static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    SIMD_TARGET("avx2,fma") static V Set1(float a) { return _mm256_set1_ps(a); }
+    SIMD_TARGET("avx2,fma") static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    SIMD_TARGET("avx2,fma") static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    SIMD_TARGET("avx2,fma") static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    SIMD_TARGET("avx2,fma") static V FMAdd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    SIMD_TARGET("avx2,fma") static V FNMAdd(V a, V b, V c) { return _mm256_fnmadd_ps(a, b, c); }
+    SIMD_TARGET("avx2,fma") static V Neg(V a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    // Estimate + one Newton step, as FastMath::Rsqrt<float>
+    SIMD_TARGET("avx2,fma") static V Rsqrt(V a)
+    {
+        const V y = _mm256_rsqrt_ps(a);
+        const V hy = _mm256_mul_ps(_mm256_mul_ps(a, _mm256_set1_ps(0.5f)), y);
+        return _mm256_mul_ps(y, _mm256_fnmadd_ps(hy, y, _mm256_set1_ps(1.5f)));
+    }
+    SIMD_TARGET("avx2,fma") static bool AnyZero(V a) { return _mm256_movemask_ps(_mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_EQ_OQ)) != 0; }
+};
+
+template<typename T>
+SIMD_TARGET("avx2,fma")
+static std::size_t MultiplyAVX2(const T* as, const T* ax, const T* ay, const T* az, bool broadcastA,
+    const T* bs, const T* bx, const T* by, const T* bz,
+    T* os, T* ox, T* oy, T* oz, std::size_t n)
+{
+    using A = Avx2<T>;
+    using V = typename A::V;
+    V As{}, Ax{}, Ay{}, Az{};
+    if (broadcastA) {
+        As = A::Set1(as[0]); Ax = A::Set1(ax[0]); Ay = A::Set1(ay[0]); Az = A::Set1(az[0]);
+    }
+
+    std::size_t i = 0;
+    for (; i + A::N <= n; i += A::N)
+    {
+        if (!broadcastA) {
+            As = A::Load(as + i); Ax = A::Load(ax + i); Ay = A::Load(ay + i); Az = A::Load(az + i);
+        }
+        const V Bs = A::Load(bs + i), Bx = A::Load(bx + i), By = A::Load(by + i), Bz = A::Load(bz + i);
+
+        const V s = A::FNMAdd(Az, Bz, A::FNMAdd(Ay, By, A::FNMAdd(Ax, Bx, A::Mul(As, Bs))));
+        const V x = A::FNMAdd(Az, By, A::FMAdd(Ay, Bz, A::FMAdd(Ax, Bs, A::Mul(As, Bx))));
+        const V y = A::FMAdd(Az, Bx, A::FMAdd(Ay, Bs, A::FNMAdd(Ax, Bz, A::Mul(As, By))));
+        const V z = A::FMAdd(Az, Bs, A::FNMAdd(Ay, Bx, A::FMAdd(Ax, By, A::Mul(As, Bz))));
+        A::Store(os + i, s); A::Store(ox + i, x); A::Store(oy + i, y); A::Store(oz + i, z);
+    }
+    return i;
+}
+
+template<typename T>
+SIMD_TARGET("avx2,fma")
+static std::size_t RotateAVX2(const T* qs, const T* qx, const T* qy, const T* qz,
+    const T* vx, const T* vy, const T* vz, T* ox, T* oy, T* oz, std::size_t n)
+{
+    using A = Avx2<T>;
+    using V = typename A::V;
+    const V two = A::Set1(T(2));
+
+    std::size_t i = 0;
+    for (; i + A::N <= n; i += A::N)
+    {
+        const V S = A::Load(qs + i), X = A::Load(qx + i), Y = A::Load(qy + i), Z = A::Load(qz + i);
+        const V Vx = A::Load(vx + i), Vy = A::Load(vy + i), Vz = A::Load(vz + i);
+
+        // t = 2 (q.xyz x v)
+        const V tx = A::Mul(two, A::FNMAdd(Z, Vy, A::Mul(Y, Vz)));
+        const V ty = A::Mul(two, A::FNMAdd(X, Vz, A::Mul(Z, Vx)));
+        const V tz = A::Mul(two, A::FNMAdd(Y, Vx, A::Mul(X, Vy)));
+        // v + s t + q.xyz x t
+        const V rx = A::FMAdd(S, tx, A::Add(Vx, A::FNMAdd(Z, ty, A::Mul(Y, tz))));
+        const V ry = A::FMAdd(S, ty, A::Add(Vy, A::FNMAdd(X, tz, A::Mul(Z, tx))));
+        const V rz = A::FMAdd(S, tz, A::Add(Vz, A::FNMAdd(Y, tx, A::Mul(X, ty))));
+        A::Store(ox + i, rx); A::Store(oy + i, ry); A::Store(oz + i, rz);
+    }
+    return i;
+}
+
+template<typename T>
+SIMD_TARGET("avx2,fma")
+static std::size_t NormalizeAVX2(const T* qs, const T* qx, const T* qy, const T* qz,
+    T* os, T* ox, T* oy, T* oz, std::size_t n)
+{
+    using A = Avx2<T>;
+    using V = typename A::V;
+
+    std::size_t i = 0;
+    for (; i + A::N <= n; i += A::N)
+    {
+        const V S = A::Load(qs + i), X = A::Load(qx + i), Y = A::Load(qy + i), Z = A::Load(qz + i);
+        const V n2 = A::FMAdd(Z, Z, A::FMAdd(Y, Y, A::FMAdd(X, X, A::Mul(S, S))));
+        if (A::AnyZero(n2)) throw std::invalid_argument("QuatBatch::Normalize: zero norm");
+        const V inv = A::Rsqrt(n2);
+        A::Store(os + i, A::Mul(S, inv)); A::Store(ox + i, A::Mul(X, inv));
+        A::Store(oy + i, A::Mul(Y, inv)); A::Store(oz + i, A::Mul(Z, inv));
+    }
+    return i;
+}
+
+template<typename T>
+SIMD_TARGET("avx2,fma")
+static std::size_t ConjugateAVX2(const T* qs, const T* qx, const T* qy, const T* qz,
+    T* os, T* ox, T* oy, T* oz, std::size_t n)
+{
+    using A = Avx2<T>;
+
+    std::size_t i = 0;
+    for (; i + A::N <= n; i += A::N)
+    {
+        A::Store(os + i, A::Load(qs + i));
+        A::Store(ox + i, A::Neg(A::Load(qx + i)));
+        A::Store(oy + i, A::Neg(A::Load(qy + i)));
+        A::Store(oz + i, A::Neg(A::Load(qz + i)));
+    }
+    return i;
+}
+
+template<typename T>
+SIMD_TARGET("avx2,fma")
+static std::size_t ToMatrix3x3AVX2(const T* qs, const T* qx, const T* qy, const T* qz,
+    TMatrix3x3<T>* out, std::size_t n)
+{
+    using A = Avx2<T>;
+    using V = typename A::V;
+    const V one = A::Set1(T(1));
+    const V two = A::Set1(T(2));
+
+    std::size_t i = 0;
+    for (; i + A::N <= n; i += A::N)
+    {
+        const V S = A::Load(qs + i), X = A::Load(qx + i), Y = A::Load(qy + i), Z = A::Load(qz + i);
+        const V xx = A::Mul(X, X), yy = A::Mul(Y, Y), zz = A::Mul(Z, Z);
+        const V xy = A::Mul(X, Y), xz = A::Mul(X, Z), yz = A::Mul(Y, Z);
+        const V sx = A::Mul(S, X), sy = A::Mul(S, Y), sz = A::Mul(S, Z);
+
+        // Row-major R, one vector per element, transposed to AoS through a buffer
+        alignas(32) T r[9][A::N];
+        A::Store(r[0], A::FNMAdd(two, A::Add(yy, zz), one));
+        A::Store(r[1], A::Mul(two, A::Sub(xy, sz)));
+        A::Store(r[2], A::Mul(two, A::Add(xz, sy)));
+        A::Store(r[3], A::Mul(two, A::Add(xy, sz)));
+        A::Store(r[4], A::FNMAdd(two, A::Add(xx, zz), one));
+        A::Store(r[5], A::Mul(two, A::Sub(yz, sx)));
+        A::Store(r[6], A::Mul(two, A::Sub(xz, sy)));
+        A::Store(r[7], A::Mul(two, A::Add(yz, sx)));
+        A::Store(r[8], A::FNMAdd(two, A::Add(xx, yy), one));
+        for (std::size_t l = 0; l < A::N; ++l)
+            for (int k = 0; k < 9; ++k)
+                out[i + l].m[k] = r[k][l];
+    }
+    return i;
+}
+#endif
+
+static bool UseAVX2()
+{
+#if SIMD_X86
+    return Simd::Active() >= Simd::Level::AVX2;
+#else
+    return false;
+#endif
+}
+
+// ------------------ Vec3Batch ----------------
+
+template<typename T>
+void TVec3Batch<T>::Resize(std::size_t n)
+{
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+}
+
+template<typename T>
+TVec3Batch<T> TVec3Batch<T>::Gather(std::span<const TVec3<T>> v)
+{
+    TVec3Batch b(v.size());
+    for (std::size_t i = 0; i < v.size(); ++i) b.Set(i, v[i]);
+    return b;
+}
+
+template<typename T>
+void TVec3Batch<T>::Scatter(std::span<TVec3<T>> v) const
+{
+    if (v.size() != Size()) throw std::invalid_argument("Vec3Batch::Scatter: sizes differ");
+    for (std::size_t i = 0; i < v.size(); ++i) v[i] = Get(i);
+}
+
+// ------------------ QuatBatch ----------------
+
+template<typename T>
+void TQuatBatch<T>::Resize(std::size_t n)
+{
+    s.resize(n, T(1));
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+}
+
+template<typename T>
+TQuatBatch<T> TQuatBatch<T>::Gather(std::span<const TQuat<T>> q)
+{
+    TQuatBatch b(q.size());
+    for (std::size_t i = 0; i < q.size(); ++i) b.Set(i, q[i]);
+    return b;
+}
+
+template<typename T>
+void TQuatBatch<T>::Scatter(std::span<TQuat<T>> q) const
+{
+    if (q.size() != Size()) throw std::invalid_argument("QuatBatch::Scatter: sizes differ");
+    for (std::size_t i = 0; i < q.size(); ++i) q[i] = Get(i);
+}
+
+template<typename T>
+void TQuatBatch<T>::Multiply(const TQuatBatch& b, TQuatBatch& out) const
+{
+    if (b.Size() != Size()) throw std::invalid_argument("QuatBatch::Multiply: sizes differ");
+    const std::size_t n = Size();
+    out.Resize(n);
+    std::size_t i = 0;
+#if SIMD_X86
+    if (UseAVX2()) {
+        i = MultiplyAVX2(s.data(), x.data(), y.data(), z.data(), false, b.s.data(), b.x.data(), b.y.data(), b.z.data(),
+            out.s.data(), out.x.data(), out.y.data(), out.z.data(), n);
+    }
+#endif
+    MultiplyScalar(s.data(), x.data(), y.data(), z.data(), false, b.s.data(), b.x.data(), b.y.data(), b.z.data(),
+        out.s.data(), out.x.data(), out.y.data(), out.z.data(), i, n);
+}
+
+template<typename T>
+void TQuatBatch<T>::Multiply(const TQuat<T>& a, const TQuatBatch& b, TQuatBatch& out)
+{
+    const std::size_t n = b.Size();
+    out.Resize(n);
+    std::size_t i = 0;
+#if SIMD_X86
+    if (UseAVX2()) {
+        i = MultiplyAVX2(&a.s, &a.x, &a.y, &a.z, true, b.s.data(), b.x.data(), b.y.data(), b.z.data(),
+            out.s.data(), out.x.data(), out.y.data(), out.z.data(), n);
+    }
+#endif
+    MultiplyScalar(&a.s, &a.x, &a.y, &a.z, true, b.s.data(), b.x.data(), b.y.data(), b.z.data(),
+        out.s.data(), out.x.data(), out.y.data(), out.z.data(), i, n);
+}
+
+template<typename T>
+void TQuatBatch<T>::Rotate(const TVec3Batch<T>& v, TVec3Batch<T>& out) const
+{
+    if (v.Size() != Size()) throw std::invalid_argument("QuatBatch::Rotate: sizes differ");
+    const std::size_t n = Size();
+    out.Resize(n);
+    std::size_t i = 0;
+#if SIMD_X86
+    if (UseAVX2()) {
+        i = RotateAVX2(s.data(), x.data(), y.data(), z.data(), v.x.data(), v.y.data(), v.z.data(),
+            out.x.data(), out.y.data(), out.z.data(), n);
+    }
+#endif
+    RotateScalar(s.data(), x.data(), y.data(), z.data(), v.x.data(), v.y.data(), v.z.data(),
+        out.x.data(), out.y.data(), out.z.data(), i, n);
+}
+
+template<typename T>
+void TQuatBatch<T>::Normalize(TQuatBatch& out) const
+{
+    const std::size_t n = Size();
+    out.Resize(n);
+    std::size_t i = 0;
+#if SIMD_X86
+    if (UseAVX2()) {
+        i = NormalizeAVX2(s.data(), x.data(), y.data(), z.data(), out.s.data(), out.x.data(), out.y.data(), out.z.data(), n);
+    }
+#endif
+    NormalizeScalar(s.data(), x.data(), y.data(), z.data(), out.s.data(), out.x.data(), out.y.data(), out.z.data(), i, n);
+}
+
+template<typename T>
+void TQuatBatch<T>::Conjugate(TQuatBatch& out) const
+{
+    const std::size_t n = Size();
+    out.Resize(n);
+    std::size_t i = 0;
+#if SIMD_X86
+    if (UseAVX2()) {
+        i = ConjugateAVX2(s.data(), x.data(), y.data(), z.data(), out.s.data(), out.x.data(), out.y.data(), out.z.data(), n);
+    }
+#endif
+    for (; i < n; ++i) {
+        out.s[i] = s[i]; out.x[i] = -x[i]; out.y[i] = -y[i]; out.z[i] = -z[i];
+    }
+}
+
+template<typename T>
+void TQuatBatch<T>::ToMatrix3x3(std::span<TMatrix3x3<T>> out) const
+{
+    if (out.size() != Size()) throw std::invalid_argument("QuatBatch::ToMatrix3x3: sizes differ");
+    const std::size_t n = Size();
+    std::size_t i = 0;
+#if SIMD_X86
+    if (UseAVX2()) i = ToMatrix3x3AVX2(s.data(), x.data(), y.data(), z.data(), out.data(), n);
+#endif
+    ToMatrix3x3Scalar(s.data(), x.data(), y.data(), z.data(), out.data(), i, n);
+}
+
+template struct TVec3Batch<float>;
+template struct TVec3Batch<double>;
+template struct TQuatBatch<float>;
+template struct TQuatBatch<double>;
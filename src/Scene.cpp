@@ -0,0 +1,608 @@
+#include "Scene.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+// GameObject
+
+void GameObject::AddChild(GameObject* child)
+{
+    scene->SetParent(child, this);
+}
+
+void GameObject::RemoveChild(GameObject* child)
+{
+    if (child && child->GetParent() == this) scene->SetParent(child, nullptr);
+}
+
+GameObject* GameObject::GetParent() const
+{
+    const int32_t p = scene->parent[index];
+    return (p < 0) ? nullptr : scene->object[p];
+}
+
+NodeRange GameObject::GetChildren() const
+{
+    return { scene, index + 1, index + scene->subtreeSize[index] };
+}
+
+const Transform& GameObject::GetTransform() const
+{
+    return scene->transform[index];
+}
+
+void GameObject::SetTransform(const Transform& t)
+{
+    scene->transform[index] = t;
+    scene->MarkDirty(index);
+}
+
+void GameObject::SetPosition(const Vec3& position)
+{
+    scene->transform[index].position = position;
+    scene->MarkDirty(index);
+}
+
+void GameObject::SetRotation(const Vec3& eulerDegrees)
+{
+    scene->transform[index].rotation = eulerDegrees;
+    scene->MarkDirty(index);
+}
+
+void GameObject::SetScale(const Vec3& scale)
+{
+    scene->transform[index].scale = scale;
+    scene->MarkDirty(index);
+}
+
+const Affine3x4& GameObject::GetLocalAffine()
+{
+    if (scene->localDirty[index])
+    {
+        scene->local[index] = scene->transform[index].GetLocalAffine();
+        scene->localDirty[index] = 0;
+    }
+    return scene->local[index];
+}
+
+const Affine3x4& GameObject::GetGlobalAffine()
+{
+    scene->UpdateWorld();
+    return scene->world[index];
+}
+
+bool GameObject::IsLocalDirty() const
+{
+    return scene->localDirty[index] != 0;
+}
+
+bool GameObject::IsWorldDirty() const
+{
+    return scene->worldDirty[index] != 0;
+}
+
+uint32_t GameObject::GetMesh() const
+{
+    return scene->mesh[index];
+}
+
+void GameObject::SetMesh(uint32_t m)
+{
+    scene->mesh[index] = m;
+    ++scene->layoutVersion;
+}
+
+std::string_view GameObject::GetName() const
+{
+    return scene->strings.Get(name.id);
+}
+
+void GameObject::SetName(std::string_view n)
+{
+    scene->Relabel(scene->byName, this, &GameObject::name, scene->strings.Intern(n));
+}
+
+std::string_view GameObject::GetTag() const
+{
+    return scene->strings.Get(tag.id);
+}
+
+void GameObject::SetTag(std::string_view t)
+{
+    scene->Relabel(scene->byTag, this, &GameObject::tag, scene->strings.Intern(t));
+}
+
+// Scene
+
+GameObject* Scene::CreateObject(GameObject* parentNode)
+{
+    if (parentNode) CheckNode(parentNode, "CreateObject");
+    const std::size_t n = Size();
+
+    // Pre-order position: right after the parent's subtree. Inside the arrays it is an
+    // in-place insert, which moves the nodes after it up by one
+    const std::size_t pos = parentNode ? parentNode->index + subtreeSize[parentNode->index] : n;
+    if (pos != n)
+    {
+        const Transform identity;
+        const int32_t top = -1;
+        const uint32_t noMesh = 0;
+        return object[InsertNodes(parentNode, { &identity, 1 }, { &top, 1 }, { &noMesh, 1 })];
+    }
+
+    const int32_t p = parentNode ? static_cast<int32_t>(parentNode->index) : -1;
+    if (n == parent.capacity()) ++arrayAllocations;
+    ++layoutVersion;
+    object.push_back(AllocateObject(n));
+    transform.emplace_back();
+    parent.push_back(p);
+    subtreeSize.push_back(1);
+    mesh.push_back(0);
+    local.push_back(Affine3x4::Identity());
+    world.push_back(Affine3x4::Identity());
+    localDirty.push_back(0);
+    worldDirty.push_back(0);
+    worldStamp.push_back(0);
+    for (int32_t a = p; a >= 0; a = parent[a]) ++subtreeSize[a];
+
+    // Identity local: the world matrix is the parent's
+    MarkDirty(n);
+    return object[n];
+}
+
+void Scene::SetParent(GameObject* child, GameObject* newParent)
+{
+    CheckNode(child, "SetParent");
+    if (newParent) CheckNode(newParent, "SetParent");
+
+    const std::size_t c = child->index;
+    const std::size_t size = subtreeSize[c];
+    const uint8_t wasLocalDirty = localDirty[c];
+    if (newParent && newParent->index >= c && newParent->index < c + size)
+        throw std::invalid_argument("Scene::SetParent: a node cannot be moved under itself or its subtree");
+
+    // Destination: after the new parent's subtree, or after everything for a root
+    const std::size_t n = Size();
+    const std::size_t dest = newParent ? newParent->index + subtreeSize[newParent->index] : n;
+    parent[c] = newParent ? static_cast<int32_t>(newParent->index) : -1;
+
+    std::vector<std::size_t> order;
+    order.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (i == dest) for (std::size_t k = c; k < c + size; ++k) order.push_back(k);
+        if (i < c || i >= c + size) order.push_back(i);
+    }
+    if (dest == n) for (std::size_t k = c; k < c + size; ++k) order.push_back(k);
+    Reorder(order);
+
+    // The moved subtree has a new world transform (the local one is unchanged)
+    MarkDirty(child->index);
+    localDirty[child->index] = wasLocalDirty;
+}
+
+std::size_t Scene::InsertNodes(GameObject* parentNode, std::span<const Transform> transforms,
+    std::span<const int32_t> parents, std::span<const uint32_t> meshes)
+{
+    if (parentNode) CheckNode(parentNode, "InsertNodes");
+    const std::size_t m = transforms.size();
+    if (parents.size() != m || meshes.size() != m)
+        throw std::invalid_argument("Scene::InsertNodes: spans of different sizes");
+
+    // Pre-order: the parent of every node is on the path to the previous one
+    std::vector<uint32_t> size(m, 1);
+    std::vector<int32_t> path;
+    for (std::size_t k = 0; k < m; ++k)
+    {
+        const int32_t p = parents[k];
+        while (!path.empty() && path.back() != p) path.pop_back();
+        if (p >= 0 && path.empty())
+            throw std::invalid_argument("Scene::InsertNodes: block not in pre-order");
+        path.push_back(static_cast<int32_t>(k));
+    }
+    for (std::size_t k = m; k-- > 0; )
+        if (parents[k] >= 0) size[parents[k]] += size[k];
+    if (m == 0) return parentNode ? parentNode->index + subtreeSize[parentNode->index] : Size();
+
+    const std::size_t n = Size();
+    const int32_t top = parentNode ? static_cast<int32_t>(parentNode->index) : -1;
+    const std::size_t pos = parentNode ? parentNode->index + subtreeSize[parentNode->index] : n;
+    if (n + m > parent.capacity()) ++arrayAllocations;
+    ++layoutVersion;
+
+    for (int32_t a = top; a >= 0; a = parent[a]) subtreeSize[a] += static_cast<uint32_t>(m);
+    for (std::size_t k = pos; k < n; ++k)
+        if (parent[k] >= static_cast<int32_t>(pos)) parent[k] += static_cast<int32_t>(m);
+
+    std::vector<int32_t> newParent(m);
+    for (std::size_t k = 0; k < m; ++k)
+        newParent[k] = (parents[k] < 0) ? top : static_cast<int32_t>(pos) + parents[k];
+    transform.insert(transform.begin() + pos, transforms.begin(), transforms.end());
+    parent.insert(parent.begin() + pos, newParent.begin(), newParent.end());
+    subtreeSize.insert(subtreeSize.begin() + pos, size.begin(), size.end());
+    mesh.insert(mesh.begin() + pos, meshes.begin(), meshes.end());
+    local.insert(local.begin() + pos, m, Affine3x4::Identity());
+    world.insert(world.begin() + pos, m, Affine3x4::Identity());
+    localDirty.insert(localDirty.begin() + pos, m, uint8_t(1));
+    worldDirty.insert(worldDirty.begin() + pos, m, uint8_t(1));
+    worldStamp.insert(worldStamp.begin() + pos, m, 0u);
+    object.insert(object.begin() + pos, m, nullptr);
+    for (std::size_t k = pos; k < pos + m; ++k) object[k] = AllocateObject(k);
+    for (std::size_t k = pos + m; k < n + m; ++k) object[k]->index = k;
+
+    if (dirtyBegin == dirtyEnd) { dirtyBegin = pos; dirtyEnd = pos + m; }
+    else
+    {
+        dirtyBegin = std::min((dirtyBegin >= pos) ? dirtyBegin + m : dirtyBegin, pos);
+        dirtyEnd = std::max((dirtyEnd > pos) ? dirtyEnd + m : dirtyEnd, pos + m);
+    }
+    return pos;
+}
+
+void Scene::Destroy(GameObject* node)
+{
+    CheckNode(node, "Destroy");
+    const std::size_t c = node->index;
+    const std::size_t size = subtreeSize[c];
+    const std::size_t end = c + size;
+    ++layoutVersion;
+
+    for (int32_t a = parent[c]; a >= 0; a = parent[a]) subtreeSize[a] -= static_cast<uint32_t>(size);
+    for (std::size_t k = c; k < end; ++k) FreeObject(object[k]);
+
+    auto erase = [&](auto& v) { v.erase(v.begin() + c, v.begin() + end); };
+    erase(transform);
+    erase(parent);
+    erase(subtreeSize);
+    erase(mesh);
+    erase(local);
+    erase(world);
+    erase(localDirty);
+    erase(worldDirty);
+    erase(worldStamp);
+    erase(object);
+
+    // Nodes after the subtree moved down by size (their parents are outside it)
+    for (std::size_t k = c; k < Size(); ++k)
+    {
+        if (parent[k] >= static_cast<int32_t>(end)) parent[k] -= static_cast<int32_t>(size);
+        object[k]->index = k;
+    }
+
+    auto shift = [&](std::size_t x) { return (x <= c) ? x : (x >= end) ? x - size : c; };
+    dirtyBegin = shift(dirtyBegin);
+    dirtyEnd = shift(dirtyEnd);
+    if (dirtyBegin == dirtyEnd) dirtyBegin = dirtyEnd = 0;
+}
+
+GameObject* Scene::Resolve(GameObjectHandle handle) const
+{
+    if (handle.slot >= slotCount) return nullptr;
+    GameObject* node = &pool[handle.slot / POOL_CHUNK][handle.slot % POOL_CHUNK];
+    return (node->generation == handle.generation && node->index != GameObject::FREE) ? node : nullptr;
+}
+
+GameObject* Scene::FindByName(std::string_view name) const
+{
+    StringTable::Id id;
+    if (!strings.Find(name, id) || id >= byName.size() || byName[id].empty()) return nullptr;
+    return byName[id].front();
+}
+
+void Scene::FindAllByName(std::string_view name, std::vector<GameObjectHandle>& out) const
+{
+    StringTable::Id id;
+    if (!strings.Find(name, id) || id >= byName.size()) return;
+    for (const GameObject* node : byName[id]) out.push_back(node->GetHandle());
+}
+
+void Scene::FindAllByTag(std::string_view tag, std::vector<GameObjectHandle>& out) const
+{
+    StringTable::Id id;
+    if (!strings.Find(tag, id) || id >= byTag.size()) return;
+    for (const GameObject* node : byTag[id]) out.push_back(node->GetHandle());
+}
+
+void Scene::SearchByName(std::string_view prefix, std::vector<GameObjectHandle>& out, std::size_t limit) const
+{
+    Search(byName, prefix, out, limit);
+}
+
+void Scene::SearchByTag(std::string_view prefix, std::vector<GameObjectHandle>& out, std::size_t limit) const
+{
+    Search(byTag, prefix, out, limit);
+}
+
+void Scene::Search(const std::vector<std::vector<GameObject*>>& index, std::string_view prefix,
+    std::vector<GameObjectHandle>& out, std::size_t limit) const
+{
+    // Strings only used by the other index, or by no node any more, have no list here
+    std::size_t found = 0;
+    strings.ForEachWithPrefix(prefix, [&](StringTable::Id id) {
+        if (id >= index.size()) return true;
+        for (const GameObject* node : index[id])
+        {
+            if (found == limit) return false;
+            out.push_back(node->GetHandle());
+            ++found;
+        }
+        return true;
+    });
+}
+
+void Scene::Reserve(std::size_t n)
+{
+    if (n > parent.capacity()) ++arrayAllocations;
+    transform.reserve(n);
+    parent.reserve(n);
+    subtreeSize.reserve(n);
+    mesh.reserve(n);
+    local.reserve(n);
+    world.reserve(n);
+    localDirty.reserve(n);
+    worldDirty.reserve(n);
+    worldStamp.reserve(n);
+    object.reserve(n);
+    while (slotCount < n) AddPoolChunk();
+}
+
+bool Scene::ReserveStep(std::size_t n)
+{
+    auto step = [n](auto& v) {
+        if (v.capacity() >= n) return false;
+        v.reserve(n);
+        return true;
+    };
+    // parent last: its capacity is the one InsertNodes and Reserve check
+    if (step(transform) || step(subtreeSize) || step(mesh) || step(local) || step(world) || step(localDirty)
+        || step(worldDirty) || step(worldStamp) || step(object))
+        return true;
+    if (!step(parent)) return false;
+    ++arrayAllocations;
+    return true;
+}
+
+std::size_t Scene::Capacity() const
+{
+    return std::min({ transform.capacity(), parent.capacity(), subtreeSize.capacity(), mesh.capacity(),
+        local.capacity(), world.capacity(), localDirty.capacity(), worldDirty.capacity(), worldStamp.capacity(),
+        object.capacity() });
+}
+
+void Scene::Clear()
+{
+    for (GameObject* node : object) FreeObject(node);
+    ++layoutVersion;
+    transform.clear();
+    parent.clear();
+    subtreeSize.clear();
+    mesh.clear();
+    local.clear();
+    world.clear();
+    localDirty.clear();
+    worldDirty.clear();
+    worldStamp.clear();
+    object.clear();
+    dirtyBegin = dirtyEnd = 0;
+    ClearLabels();
+}
+
+void Scene::ClearLabels()
+{
+    strings.Clear();
+    byName.clear();
+    byTag.clear();
+}
+
+Scene::MemoryStats Scene::GetMemoryStats() const
+{
+    MemoryStats m;
+    m.nodes = Size();
+    m.slots = slotCount;
+    m.bytesPerNode = sizeof(Transform) + sizeof(int32_t) + 2 * sizeof(uint32_t) + 2 * sizeof(Affine3x4)
+        + 2 * sizeof(uint8_t) + sizeof(uint32_t) + sizeof(GameObject*) + sizeof(GameObject);
+    m.reservedBytes = transform.capacity() * sizeof(Transform) + parent.capacity() * sizeof(int32_t)
+        + (subtreeSize.capacity() + mesh.capacity()) * sizeof(uint32_t) + (local.capacity() + world.capacity()) * sizeof(Affine3x4)
+        + localDirty.capacity() + worldDirty.capacity() + worldStamp.capacity() * sizeof(uint32_t)
+        + object.capacity() * sizeof(GameObject*)
+        + std::size_t(slotCount) * sizeof(GameObject);
+    m.poolAllocations = pool.size();
+    m.arrayAllocations = arrayAllocations;
+    return m;
+}
+
+void Scene::UpdateWorld()
+{
+    if (dirtyBegin < dirtyEnd) ++worldVersion;
+    UpdateRange(dirtyBegin, dirtyEnd);
+    dirtyBegin = dirtyEnd = 0;
+}
+
+void Scene::UpdateWorld(JobSystem& jobs)
+{
+    // Below this many nodes per thread the jobs cost more than they save
+    constexpr std::size_t MIN_PIECE = 2048;
+    const std::size_t count = dirtyEnd - dirtyBegin;
+    if (jobs.ThreadCount() == 1 || count < 2 * MIN_PIECE)
+    {
+        UpdateWorld();
+        return;
+    }
+
+    ++worldVersion;
+
+    // Walk the dirty range in pre-order: a subtree that fits in a piece becomes one;
+    // a bigger one has its root updated here and is split among its children.
+    const std::size_t piece = std::max(MIN_PIECE, count / (8 * jobs.ThreadCount()));
+    std::vector<std::size_t> bounds;    // begin, end, begin, end, ...
+    for (std::size_t i = dirtyBegin; i < dirtyEnd; )
+    {
+        const std::size_t end = std::min<std::size_t>(i + subtreeSize[i], dirtyEnd);
+        if (end - i <= piece)
+        {
+            // Merge consecutive small subtrees into one piece
+            if (!bounds.empty() && bounds.back() == i && end - bounds[bounds.size() - 2] <= piece)
+                bounds.back() = end;
+            else { bounds.push_back(i); bounds.push_back(end); }
+            i = end;
+        }
+        else
+        {
+            UpdateNode(i);
+            ++i;
+        }
+    }
+
+    jobs.ParallelFor(bounds.size() / 2, 1, [&](std::size_t b, std::size_t e) {
+        for (std::size_t k = b; k < e; ++k) UpdateRange(bounds[2 * k], bounds[2 * k + 1]);
+    });
+    dirtyBegin = dirtyEnd = 0;
+}
+
+void Scene::UpdateNode(std::size_t i)
+{
+    if (!worldDirty[i]) return;
+    if (localDirty[i])
+    {
+        local[i] = transform[i].GetLocalAffine();
+        localDirty[i] = 0;
+    }
+    world[i] = (parent[i] < 0) ? local[i] : world[parent[i]].Multiply(local[i]);
+    worldDirty[i] = 0;
+    worldStamp[i] = worldVersion;
+}
+
+void Scene::UpdateRange(std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; ++i) UpdateNode(i);
+}
+
+Affine3x4 Scene::ComputeWorld(std::size_t i) const
+{
+    if (!worldDirty[i]) return world[i];
+    // Up to the first ancestor whose world matrix is up to date
+    auto localOf = [&](std::size_t k) { return localDirty[k] ? transform[k].GetLocalAffine() : local[k]; };
+    Affine3x4 w = localOf(i);
+    int32_t a = parent[i];
+    for (; a >= 0 && worldDirty[a]; a = parent[a]) w = localOf(a).Multiply(w);
+    return (a < 0) ? w : world[a].Multiply(w);
+}
+
+void Scene::CheckNode(const GameObject* node, const char* what) const
+{
+    if (!node || node->scene != this)
+        throw std::invalid_argument(std::string("Scene::") + what + ": node of another scene");
+    if (node->index == GameObject::FREE)
+        throw std::invalid_argument(std::string("Scene::") + what + ": destroyed node");
+}
+
+void Scene::AddPoolChunk()
+{
+    // Its slots go to the front of the free list, in order
+    pool.push_back(std::unique_ptr<GameObject[]>(new GameObject[POOL_CHUNK]));
+    for (uint32_t k = POOL_CHUNK; k-- > 0; )
+    {
+        GameObject& o = pool.back()[k];
+        o.slot = slotCount + k;
+        o.nextFree = freeSlot;
+        freeSlot = o.slot;
+    }
+    slotCount += POOL_CHUNK;
+}
+
+GameObject* Scene::AllocateObject(std::size_t index)
+{
+    if (freeSlot == UINT32_MAX) AddPoolChunk();
+    GameObject* node = &pool[freeSlot / POOL_CHUNK][freeSlot % POOL_CHUNK];
+    freeSlot = node->nextFree;
+    node->scene = this;
+    node->index = index;
+    return node;
+}
+
+void Scene::FreeObject(GameObject* node)
+{
+    Relabel(byName, node, &GameObject::name, StringTable::EMPTY);
+    Relabel(byTag, node, &GameObject::tag, StringTable::EMPTY);
+    node->index = GameObject::FREE;
+    ++node->generation;
+    node->nextFree = freeSlot;
+    freeSlot = node->slot;
+}
+
+void Scene::Relabel(std::vector<std::vector<GameObject*>>& index, GameObject* node, GameObject::Label GameObject::* label,
+    StringTable::Id id)
+{
+    GameObject::Label& l = node->*label;
+    if (l.id == id) return;
+    if (l.id != StringTable::EMPTY)
+    {
+        // Swap with the last of the list
+        std::vector<GameObject*>& list = index[l.id];
+        GameObject* last = list.back();
+        list[l.position] = last;
+        (last->*label).position = l.position;
+        list.pop_back();
+    }
+    l.id = id;
+    if (id != StringTable::EMPTY)
+    {
+        if (index.size() <= id) index.resize(strings.Size());
+        l.position = static_cast<uint32_t>(index[id].size());
+        index[id].push_back(node);
+    }
+}
+
+void Scene::MarkDirty(std::size_t i)
+{
+    localDirty[i] = 1;
+    const std::size_t end = i + subtreeSize[i];
+    std::fill(worldDirty.begin() + i, worldDirty.begin() + end, uint8_t(1));
+    if (dirtyBegin == dirtyEnd) { dirtyBegin = i; dirtyEnd = end; }
+    else { dirtyBegin = std::min(dirtyBegin, i); dirtyEnd = std::max(dirtyEnd, end); }
+}
+
+template<typename V>
+static void Permute(V& v, const std::vector<std::size_t>& order)
+{
+    V r;
+    r.reserve(v.size());
+    for (std::size_t k : order) r.push_back(std::move(v[k]));
+    v = std::move(r);
+}
+
+void Scene::Reorder(const std::vector<std::size_t>& order)
+{
+    const std::size_t n = order.size();
+    std::vector<int32_t> newIndex(Size(), -1);
+    ++arrayAllocations;
+    ++layoutVersion;
+    for (std::size_t k = 0; k < n; ++k) newIndex[order[k]] = static_cast<int32_t>(k);
+
+    Permute(transform, order);
+    Permute(parent, order);
+    Permute(mesh, order);
+    Permute(local, order);
+    Permute(world, order);
+    Permute(localDirty, order);
+    Permute(worldDirty, order);
+    Permute(worldStamp, order);
+    Permute(object, order);
+
+    dirtyBegin = dirtyEnd = 0;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        if (parent[k] >= 0) parent[k] = newIndex[parent[k]];
+        object[k]->index = k;
+        if (worldDirty[k])
+        {
+            if (dirtyBegin == dirtyEnd) dirtyBegin = k;
+            dirtyEnd = k + 1;
+        }
+    }
+
+    subtreeSize.assign(n, 1);
+    for (std::size_t k = n; k-- > 0; )
+        if (parent[k] >= 0) subtreeSize[parent[k]] += subtreeSize[k];
+}
@@ -0,0 +1,30 @@
+#include "SceneBuilder.hpp"
+#include <random>
+#include <vector>
+
+void RandomHierarchy(Scene& scene, std::size_t n, unsigned seed, const HierarchyShape& shape)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    std::vector<GameObject*> path;
+    scene.Reserve(scene.Size() + n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const std::size_t up = rng() % 3;
+        for (std::size_t k = 0; k < up && !path.empty(); ++k) path.pop_back();
+        if (path.size() > shape.maxDepth) path.resize(shape.maxDepth);
+        GameObject* node = scene.CreateObject(path.empty() ? nullptr : path.back());
+        if (shape.transforms)
+        {
+            Transform t;
+            const double spread = path.empty() ? shape.rootSpread : shape.childSpread;
+            t.position = { spread * u(rng), spread * u(rng), spread * u(rng) };
+            t.rotation = { shape.rotation * u(rng), shape.rotation * u(rng), shape.rotation * u(rng) };
+            const double s = (path.empty() ? shape.rootScale : shape.childScale) * (1.0 + shape.scaleJitter * u(rng));
+            t.scale = { s, s, s };
+            node->SetTransform(t);
+        }
+        if (shape.meshes) node->SetMesh(static_cast<uint32_t>(rng() % shape.meshes));
+        path.push_back(node);
+    }
+}
@@ -0,0 +1,258 @@
+#include "SceneEdit.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+SceneEdit::SceneEdit(Scene& s) : scene(s)
+{
+}
+
+SceneEdit::~SceneEdit()
+{
+    Discard();
+}
+
+GameObjectHandle SceneEdit::Insert(GameObjectHandle parent, const Transform& transform, uint32_t mesh,
+    std::string_view name, std::string_view tag)
+{
+    // The slot is taken now so that the handle is known; with index FREE it does not
+    // resolve until Apply puts the node in the arrays
+    GameObject* object = scene.AllocateObject(GameObject::FREE);
+    addedBySlot[object->slot] = static_cast<uint32_t>(added.size());
+    added.push_back({ object, transform, mesh, std::string(name), std::string(tag) });
+    edits.push_back({ Kind::Insert, Keep::Local, object->GetHandle(), parent });
+    return object->GetHandle();
+}
+
+void SceneEdit::Destroy(GameObjectHandle node)
+{
+    edits.push_back({ Kind::Destroy, Keep::Local, node, {} });
+}
+
+void SceneEdit::Reparent(GameObjectHandle node, GameObjectHandle parent, Keep keep)
+{
+    edits.push_back({ Kind::Reparent, keep, node, parent });
+}
+
+void SceneEdit::MoveBefore(GameObjectHandle node, GameObjectHandle sibling, Keep keep)
+{
+    edits.push_back({ Kind::MoveBefore, keep, node, sibling });
+}
+
+void SceneEdit::Clear()
+{
+    Discard();
+}
+
+void SceneEdit::Discard()
+{
+    for (const Added& a : added)
+        if (a.object->index == GameObject::FREE) scene.FreeObject(a.object);
+    edits.clear();
+    added.clear();
+    addedBySlot.clear();
+}
+
+uint32_t SceneEdit::Node(const Links& links, GameObjectHandle handle, bool nullIsRoot) const
+{
+    if (nullIsRoot && handle == GameObjectHandle{}) return links.root;
+    uint32_t node = NONE;
+    if (const GameObject* object = scene.Resolve(handle))
+        node = static_cast<uint32_t>(object->index);
+    else if (const auto it = addedBySlot.find(handle.slot);
+        it != addedBySlot.end() && added[it->second].object->GetHandle() == handle)
+        node = static_cast<uint32_t>(scene.Size() + it->second);
+    if (node == NONE) throw std::invalid_argument("SceneEdit::Apply: stale handle");
+    if (links.dead[node]) throw std::invalid_argument("SceneEdit::Apply: node destroyed by the batch");
+    return node;
+}
+
+void SceneEdit::Unlink(Links& l, uint32_t node)
+{
+    const uint32_t p = l.parent[node];
+    if (p == NONE) return;
+    if (l.prev[node] != NONE) l.next[l.prev[node]] = l.next[node];
+    else l.firstChild[p] = l.next[node];
+    if (l.next[node] != NONE) l.prev[l.next[node]] = l.prev[node];
+    else l.lastChild[p] = l.prev[node];
+    l.parent[node] = l.prev[node] = l.next[node] = NONE;
+}
+
+void SceneEdit::Link(Links& l, uint32_t node, uint32_t parent, uint32_t before)
+{
+    const uint32_t after = (before == NONE) ? l.lastChild[parent] : l.prev[before];
+    l.parent[node] = parent;
+    l.prev[node] = after;
+    l.next[node] = before;
+    if (after != NONE) l.next[after] = node;
+    else l.firstChild[parent] = node;
+    if (before != NONE) l.prev[before] = node;
+    else l.lastChild[parent] = node;
+}
+
+bool SceneEdit::IsAncestor(const Links& l, uint32_t ancestor, uint32_t node)
+{
+    for (uint32_t a = node; a != NONE; a = l.parent[a])
+        if (a == ancestor) return true;
+    return false;
+}
+
+void SceneEdit::Kill(Links& l, uint32_t node)
+{
+    // Pre-order walk of the subtree, which is still linked below node
+    for (uint32_t k = node; ; )
+    {
+        l.dead[k] = 1;
+        if (l.firstChild[k] != NONE) { k = l.firstChild[k]; continue; }
+        while (k != node && l.next[k] == NONE) k = l.parent[k];
+        if (k == node) return;
+        k = l.next[k];
+    }
+}
+
+void SceneEdit::Apply()
+{
+    if (edits.empty()) return;
+    const std::size_t n = scene.Size();
+    const std::size_t count = n + added.size();
+
+    Links l;
+    l.root = static_cast<uint32_t>(count);
+    for (auto* v : { &l.parent, &l.firstChild, &l.lastChild, &l.next, &l.prev }) v->assign(count + 1, NONE);
+    l.dead.assign(count, 0);
+    l.moved.assign(count, 0);
+    l.keepWorld.assign(count, 0);
+    // Pre-order: the children of a node come in their order
+    for (std::size_t i = 0; i < n; ++i)
+        Link(l, static_cast<uint32_t>(i), scene.parent[i] < 0 ? l.root : static_cast<uint32_t>(scene.parent[i]), NONE);
+
+    // Replay on the links only: a failed edit leaves the scene as it was
+    try
+    {
+        for (const Edit& e : edits)
+        {
+            const uint32_t node = Node(l, e.node, false);
+            switch (e.kind)
+            {
+            case Kind::Insert:
+                Link(l, node, Node(l, e.target, true), NONE);
+                break;
+            case Kind::Destroy:
+                Unlink(l, node);
+                Kill(l, node);
+                break;
+            case Kind::Reparent:
+            case Kind::MoveBefore:
+            {
+                const uint32_t sibling = (e.kind == Kind::MoveBefore) ? Node(l, e.target, false) : NONE;
+                if (sibling == node)
+                    throw std::invalid_argument("SceneEdit::Apply: a node cannot be moved before itself");
+                const uint32_t parent = (e.kind == Kind::MoveBefore) ? l.parent[sibling] : Node(l, e.target, true);
+                if (IsAncestor(l, node, parent))
+                    throw std::invalid_argument("SceneEdit::Apply: a node cannot be moved under itself or its subtree");
+                Unlink(l, node);
+                Link(l, node, parent, sibling);
+                if (node < n)
+                {
+                    l.moved[node] = 1;
+                    l.keepWorld[node] = (e.keep == Keep::World);
+                }
+                break;
+            }
+            }
+        }
+    }
+    catch (...)
+    {
+        Discard();
+        throw;
+    }
+
+    // Nodes that changed parent, with the world matrix they keep when they keep it
+    struct Moved {
+        GameObject* object;
+        bool keepWorld;
+        uint8_t localDirty;
+    };
+    std::vector<Moved> moved;
+    bool keepWorld = false;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const int32_t p = (l.parent[i] == l.root) ? -1 : static_cast<int32_t>(l.parent[i]);
+        if (!l.moved[i] || l.dead[i] || p == scene.parent[i]) continue;
+        moved.push_back({ scene.object[i], l.keepWorld[i] != 0, scene.localDirty[i] });
+        keepWorld = keepWorld || l.keepWorld[i];
+    }
+    if (keepWorld) scene.UpdateWorld();
+
+    // New pre-order over the links
+    std::vector<std::size_t> order;
+    order.reserve(count);
+    for (uint32_t k = l.firstChild[l.root]; k != NONE; )
+    {
+        order.push_back(k);
+        if (l.firstChild[k] != NONE) { k = l.firstChild[k]; continue; }
+        while (l.next[k] == NONE && l.parent[k] != l.root) k = l.parent[k];
+        k = l.next[k];
+    }
+
+    // Destroyed nodes give their slots back; added ones go to the end of the arrays,
+    // dirty, and every node gets its new parent (still as an index before the reorder)
+    for (std::size_t i = 0; i < count; ++i)
+        if (l.dead[i]) scene.FreeObject(i < n ? scene.object[i] : added[i - n].object);
+    for (std::size_t k = 0; k < added.size(); ++k)
+    {
+        const Added& a = added[k];
+        scene.transform.push_back(a.transform);
+        scene.parent.push_back(-1);
+        scene.subtreeSize.push_back(1);
+        scene.mesh.push_back(a.mesh);
+        scene.local.push_back(Affine3x4::Identity());
+        scene.world.push_back(Affine3x4::Identity());
+        scene.localDirty.push_back(1);
+        scene.worldDirty.push_back(1);
+        scene.worldStamp.push_back(0);
+        scene.object.push_back(a.object);
+        if (l.dead[n + k]) continue;
+        a.object->index = n + k;
+        scene.Relabel(scene.byName, a.object, &GameObject::name, scene.strings.Intern(a.name));
+        scene.Relabel(scene.byTag, a.object, &GameObject::tag, scene.strings.Intern(a.tag));
+    }
+    for (std::size_t i = 0; i < count; ++i)
+        if (!l.dead[i]) scene.parent[i] = (l.parent[i] == l.root) ? -1 : static_cast<int32_t>(l.parent[i]);
+    scene.Reorder(order);
+
+    // The moved subtrees have a new world transform, or a new local one for Keep::World.
+    // In index order, so that a moved ancestor has its final transform first.
+    std::sort(moved.begin(), moved.end(), [](const Moved& a, const Moved& b) { return a.object->index < b.object->index; });
+    for (const Moved& m : moved)
+    {
+        const std::size_t i = m.object->index;
+        if (m.keepWorld)
+        {
+            const Affine3x4 target = scene.world[i];    // Moved with the node, not recomputed yet
+            const Affine3x4 local = (scene.parent[i] < 0) ? target
+                : scene.ComputeWorld(static_cast<std::size_t>(scene.parent[i])).InverseTRS().Multiply(target);
+            Vec3 t, s;
+            Quat q;
+            local.Decompose(t, q, s, DecomposeMode::NegativeScale);
+            double yaw, pitch, roll;
+            q.ToEulerZYX(yaw, pitch, roll);
+            const double deg = 180.0 / 3.14159265358979323846;
+            scene.transform[i] = Transform();
+            scene.transform[i].position = t;
+            scene.transform[i].rotation = { pitch * deg, yaw * deg, roll * deg };
+            scene.transform[i].scale = s;
+            scene.MarkDirty(i);
+        }
+        else
+        {
+            scene.MarkDirty(i);
+            scene.localDirty[i] = m.localDirty;
+        }
+    }
+
+    edits.clear();
+    added.clear();
+    addedBySlot.clear();
+}
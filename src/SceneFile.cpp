@@ -0,0 +1,297 @@
+// Scene::Save / Scene::Load: binary snapshot of the scene arrays.
+//
+// Layout (version 2, native byte order, checked on load):
+//
+//   SceneFileHeader                     176 bytes
+//   Transform[n]         position, rotation (degrees), scale: 9 doubles per node
+//   int32_t[n]           parent, -1 for roots (pre-order: parent < node)
+//   uint32_t[n]          subtree size, node included
+//   uint32_t[n]          mesh index
+//   uint32_t[n]          name, index in the file's strings (0: no name)
+//   uint32_t[n]          tag, same
+//   uint64_t[s + 1]      string k is characters [offset[k], offset[k + 1]); string 0 is
+//                        empty, the others are distinct
+//   char[c]              characters of the strings, without terminators
+//
+// Version 1 files (no names: a 96-byte header, the end of this one, and the first four
+// sections) still load.
+//
+// Every section starts at a multiple of SECTION_ALIGN from the start of the file, so
+// a mapping of the file can be read in place. Matrices are not stored: they are
+// rebuilt by the first UpdateWorld after the load.
+#include "Scene.hpp"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char SCENE_FILE_MAGIC[8] = { 'M', 'S', 'C', 'E', 'N', 'E', '\r', '\n' };
+constexpr uint32_t SCENE_FILE_VERSION = 2;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr std::size_t SECTION_ALIGN = 64;
+
+enum Section { TRANSFORMS, PARENTS, SUBTREE_SIZES, MESHES, NAMES, TAGS, STRING_OFFSETS, STRING_CHARS, SECTION_COUNT };
+
+// The version 1 header is the first 96 bytes, with the first four sections
+constexpr std::size_t HEADER_V1_BYTES = 96;
+constexpr int SECTIONS_V1 = NAMES;
+
+struct SceneFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t nodeCount;
+    uint64_t fileSize;
+    struct { uint64_t offset, bytes; } sections[SECTION_COUNT];
+    uint64_t stringCount;   // String 0 (empty) included
+    uint64_t charCount;
+};
+static_assert(sizeof(SceneFileHeader) == 176, "SceneFileHeader must not have padding");
+static_assert(std::is_trivially_copyable_v<Transform> && sizeof(Transform) == 9 * sizeof(double),
+    "Transform is stored as 9 doubles");
+
+SceneFileHeader MakeHeader(uint32_t version, std::size_t n, uint64_t strings, uint64_t chars)
+{
+    SceneFileHeader h{};
+    std::memcpy(h.magic, SCENE_FILE_MAGIC, sizeof(h.magic));
+    h.version = version;
+    h.byteOrder = BYTE_ORDER_MARK;
+    h.nodeCount = n;
+    const bool v1 = version == 1;
+    const int sections = v1 ? SECTIONS_V1 : SECTION_COUNT;
+    if (!v1)
+    {
+        h.stringCount = strings;
+        h.charCount = chars;
+    }
+    const uint64_t bytes[SECTION_COUNT] = { n * sizeof(Transform), n * sizeof(int32_t), n * sizeof(uint32_t),
+        n * sizeof(uint32_t), n * sizeof(uint32_t), n * sizeof(uint32_t), (strings + 1) * sizeof(uint64_t), chars };
+    uint64_t offset = v1 ? HEADER_V1_BYTES : sizeof(SceneFileHeader);
+    for (int s = 0; s < sections; ++s)
+    {
+        offset = (offset + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+        h.sections[s] = { offset, bytes[s] };
+        offset += h.sections[s].bytes;
+    }
+    h.fileSize = offset;
+    return h;
+}
+
+// Read-only mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Scene::Load: cannot open " + path);
+        LARGE_INTEGER sz;
+        GetFileSizeEx(file, &sz);
+        size = static_cast<std::size_t>(sz.QuadPart);
+        if (size == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) throw std::runtime_error("Scene::Load: cannot map " + path);
+        data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!data) throw std::runtime_error("Scene::Load: cannot map " + path);
+#else
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Scene::Load: cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0) throw std::runtime_error("Scene::Load: cannot stat " + path);
+        size = static_cast<std::size_t>(st.st_size);
+        if (size == 0) return;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("Scene::Load: cannot map " + path);
+        data = static_cast<const unsigned char*>(p);
+        madvise(p, size, MADV_SEQUENTIAL);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) munmap(const_cast<unsigned char*>(data), size);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+} // namespace
+
+void Scene::Save(const std::string& path) const
+{
+    const std::size_t n = Size();
+
+    // Strings used by the nodes, numbered from 1 in order of first use
+    std::vector<uint32_t> fileName(n), fileTag(n);
+    std::vector<uint32_t> fileString(strings.Size(), 0);    // String id -> index in the file
+    std::vector<uint64_t> offsets = { 0, 0 };
+    std::string chars;
+    auto add = [&](StringTable::Id id) {
+        if (id == StringTable::EMPTY) return uint32_t(0);
+        uint32_t& k = fileString[id];
+        if (k == 0)
+        {
+            k = static_cast<uint32_t>(offsets.size() - 1);
+            chars += strings.Get(id);
+            offsets.push_back(chars.size());
+        }
+        return k;
+    };
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        fileName[i] = add(object[i]->name.id);
+        fileTag[i] = add(object[i]->tag.id);
+    }
+
+    const SceneFileHeader h = MakeHeader(SCENE_FILE_VERSION, n, offsets.size() - 1, chars.size());
+    const void* data[SECTION_COUNT] = { transform.data(), parent.data(), subtreeSize.data(), mesh.data(),
+        fileName.data(), fileTag.data(), offsets.data(), chars.data() };
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) throw std::runtime_error("Scene::Save: cannot create " + path);
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1;
+    uint64_t at = sizeof(h);
+    const char zeros[SECTION_ALIGN] = {};
+    for (int s = 0; s < SECTION_COUNT && ok; ++s)
+    {
+        const std::size_t pad = static_cast<std::size_t>(h.sections[s].offset - at);
+        const std::size_t bytes = static_cast<std::size_t>(h.sections[s].bytes);
+        ok = (pad == 0 || std::fwrite(zeros, 1, pad, f) == pad) && (bytes == 0 || std::fwrite(data[s], 1, bytes, f) == bytes);
+        at = h.sections[s].offset + bytes;
+    }
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) throw std::runtime_error("Scene::Save: cannot write " + path);
+}
+
+void Scene::Load(const std::string& path)
+{
+    const MappedFile file(path);
+    auto fail = [&](const char* why) { throw std::runtime_error("Scene::Load: " + path + ": " + why); };
+
+    // Header (the version 1 one is the start of this one)
+    SceneFileHeader h{};
+    if (file.size < HEADER_V1_BYTES) fail("not a scene file");
+    std::memcpy(&h, file.data, HEADER_V1_BYTES);
+    if (std::memcmp(h.magic, SCENE_FILE_MAGIC, sizeof(h.magic)) != 0) fail("not a scene file");
+    if (h.byteOrder != BYTE_ORDER_MARK) fail("written with another byte order");
+    if (h.version != 1 && h.version != SCENE_FILE_VERSION) fail("unsupported version");
+    if (h.version != 1)
+    {
+        if (file.size < sizeof(h)) fail("truncated or inconsistent sections");
+        std::memcpy(&h, file.data, sizeof(h));
+    }
+    if (h.nodeCount > uint64_t(INT32_MAX)) fail("too many nodes");
+    if (h.stringCount == 0 && h.version != 1) fail("bad string table");
+    if (h.stringCount > uint64_t(UINT32_MAX) || h.charCount > file.size) fail("bad string table");
+    const std::size_t n = static_cast<std::size_t>(h.nodeCount);
+    const SceneFileHeader expected = MakeHeader(h.version, n, h.stringCount, h.charCount);
+    if (h.fileSize != file.size || std::memcmp(h.sections, expected.sections, sizeof(h.sections)) != 0)
+        fail("truncated or inconsistent sections");
+
+    const unsigned char* sections[SECTION_COUNT];
+    for (int s = 0; s < SECTION_COUNT; ++s) sections[s] = file.data + h.sections[s].offset;
+    const int32_t* fileParent = reinterpret_cast<const int32_t*>(sections[PARENTS]);
+    const uint32_t* fileSubtree = reinterpret_cast<const uint32_t*>(sections[SUBTREE_SIZES]);
+    const uint32_t* fileName = reinterpret_cast<const uint32_t*>(sections[NAMES]);
+    const uint32_t* fileTag = reinterpret_cast<const uint32_t*>(sections[TAGS]);
+    const uint64_t* fileOffsets = reinterpret_cast<const uint64_t*>(sections[STRING_OFFSETS]);
+    const char* fileChars = reinterpret_cast<const char*>(sections[STRING_CHARS]);
+    const std::size_t stringCount = static_cast<std::size_t>(h.stringCount);
+    const bool named = h.version != 1;
+
+    // Strings: increasing offsets inside the characters, and every node names one
+    if (named)
+    {
+        if (fileOffsets[0] != 0 || fileOffsets[1] != 0 || fileOffsets[stringCount] != h.charCount)
+            fail("bad string table");
+        for (std::size_t k = 0; k < stringCount; ++k)
+            if (fileOffsets[k + 1] < fileOffsets[k]) fail("bad string table");
+        for (std::size_t i = 0; i < n; ++i)
+            if (fileName[i] >= stringCount || fileTag[i] >= stringCount) fail("bad name or tag");
+    }
+
+    // Pre-order check before touching the scene: every node's parent is the innermost
+    // subtree still open, and every subtree ends inside its parent's
+    std::vector<std::size_t> openEnd;   // End of the open subtrees, innermost last
+    std::vector<int32_t> openNode;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        while (!openEnd.empty() && openEnd.back() <= i) { openEnd.pop_back(); openNode.pop_back(); }
+        const int32_t p = fileParent[i];
+        const std::size_t end = i + fileSubtree[i];
+        if (fileSubtree[i] == 0 || end > n) fail("bad subtree size");
+        if (p != (openNode.empty() ? -1 : openNode.back())) fail("hierarchy is not in pre-order");
+        if (!openEnd.empty() && end > openEnd.back()) fail("bad subtree size");
+        openEnd.push_back(end);
+        openNode.push_back(static_cast<int32_t>(i));
+    }
+
+    // Bulk copies of the flat arrays, then the handles. The matrices are all dirty, so
+    // the old ones are only resized, not cleared (a reload of a scene of the same size
+    // writes no matrix).
+    for (GameObject* node : object) FreeObject(node);
+    object.clear();
+    ClearLabels();
+    Reserve(n);
+    transform.resize(n);
+    parent.resize(n);
+    subtreeSize.resize(n);
+    mesh.resize(n);
+    if (n > 0)
+    {
+        std::memcpy(transform.data(), sections[TRANSFORMS], h.sections[TRANSFORMS].bytes);
+        std::memcpy(parent.data(), sections[PARENTS], h.sections[PARENTS].bytes);
+        std::memcpy(subtreeSize.data(), sections[SUBTREE_SIZES], h.sections[SUBTREE_SIZES].bytes);
+        std::memcpy(mesh.data(), sections[MESHES], h.sections[MESHES].bytes);
+    }
+    local.resize(n);
+    world.resize(n);
+    localDirty.assign(n, 1);
+    worldDirty.assign(n, 1);
+    worldStamp.resize(n);
+    ++layoutVersion;
+    for (std::size_t i = 0; i < n; ++i) object.push_back(AllocateObject(i));
+    dirtyBegin = 0;
+    dirtyEnd = n;
+
+    if (!named) return;
+    std::vector<StringTable::Id> ids(stringCount, StringTable::EMPTY);
+    for (std::size_t k = 1; k < stringCount; ++k)
+        ids[k] = strings.Intern({ fileChars + fileOffsets[k], static_cast<std::size_t>(fileOffsets[k + 1] - fileOffsets[k]) });
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (fileName[i]) Relabel(byName, object[i], &GameObject::name, ids[fileName[i]]);
+        if (fileTag[i]) Relabel(byTag, object[i], &GameObject::tag, ids[fileTag[i]]);
+    }
+}
@@ -0,0 +1,249 @@
+#include "SceneStreamer.hpp"
+#include <algorithm>
+#include <chrono>
+
+SceneStreamer::SceneStreamer(Scene& t) : target(t)
+{
+    loader = std::thread([this] { LoaderLoop(); });
+}
+
+SceneStreamer::~SceneStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        for (auto& r : queued) r->state.store(StreamRequest::State::Canceled, std::memory_order_release);
+        queued.clear();
+    }
+    wake.notify_all();
+    loader.join();
+}
+
+std::shared_ptr<const StreamRequest> SceneStreamer::Request(std::function<void(Scene&)> build, GameObject* parent)
+{
+    auto r = std::make_shared<StreamRequest>();
+    r->build = std::move(build);
+    r->toRoots = (parent == nullptr);
+    if (parent) r->parent = parent->GetHandle();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.push_back(r);
+    }
+    wake.notify_one();
+    return r;
+}
+
+std::shared_ptr<const StreamRequest> SceneStreamer::RequestFile(const std::string& path, GameObject* parent)
+{
+    return Request([path](Scene& scene) { scene.Load(path); }, parent);
+}
+
+void SceneStreamer::LoaderLoop()
+{
+    while (true)
+    {
+        std::shared_ptr<StreamRequest> r;
+        std::vector<std::unique_ptr<Scene>> old;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stop || !queued.empty() || !retired.empty(); });
+            if (stop) return;
+            old.swap(retired);
+            if (!queued.empty())
+            {
+                r = queued.front();
+                queued.pop_front();
+                ++building;
+            }
+        }
+        // The spliced sources are freed here rather than in Update
+        old.clear();
+        if (!r) continue;
+
+        r->state.store(StreamRequest::State::Building, std::memory_order_release);
+        try
+        {
+            auto source = std::make_unique<Scene>();
+            r->build(*source);
+            r->placed.resize(source->Size());
+            r->nodeCount.store(source->Size(), std::memory_order_release);
+            // Nothing to splice: done already
+            if (source->Size() > 0) r->source = std::move(source);
+            r->state.store(r->source ? StreamRequest::State::Splicing : StreamRequest::State::Done,
+                std::memory_order_release);
+        }
+        catch (const std::exception& e)
+        {
+            r->error = e.what();
+            r->state.store(StreamRequest::State::Failed, std::memory_order_release);
+        }
+        r->build = nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        --building;
+        if (r->GetState() == StreamRequest::State::Splicing) built.push_back(std::move(r));
+    }
+}
+
+double SceneStreamer::Update(double budgetMs)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    auto elapsedMs = [&] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& r : built) splicing.push_back(std::move(r));
+        built.clear();
+    }
+    // Room for the nodes to splice in blocks: the arrays double, one array per frame
+    std::size_t pending = 0;
+    for (const auto& r : splicing)
+        if (InBlocks(Tail(*r), budgetMs)) pending += r->NodeCount() - r->NodesSpliced();
+    if (growTo == 0 && target.Size() + pending > target.Capacity())
+        growTo = std::max(2 * target.Capacity(), target.Size() + BLOCK);
+    bool frameStart = true;
+    if (growTo > 0)
+    {
+        frameStart = !target.ReserveStep(growTo);
+        if (frameStart) growTo = 0;
+    }
+
+    while (!splicing.empty())
+    {
+        StreamRequest& r = *splicing.front();
+        const std::size_t tail = Tail(r);
+        const std::size_t count = PlanBlock(r, tail, budgetMs - elapsedMs(), frameStart);
+        if (count == 0) break;
+        const double start = elapsedMs();
+        const bool more = SpliceBlock(r, count);
+        frameStart = false;
+
+        // The block took count * insertNs + tail * moveNs: correct the larger term
+        const double ns = (elapsedMs() - start) * 1e6;
+        if (r.GetState() != StreamRequest::State::Canceled)
+        {
+            if (tail * moveNs <= count * insertNs)
+                insertNs = 0.5 * insertNs + 0.5 * std::max(1.0, (ns - tail * moveNs) / count);
+            else
+                moveNs = 0.5 * moveNs + 0.5 * std::max(0.1, (ns - count * insertNs) / tail);
+        }
+        if (!more) splicing.pop_front();
+    }
+
+    lastUpdateMs = elapsedMs();
+    maxUpdateMs = std::max(maxUpdateMs, lastUpdateMs);
+    return lastUpdateMs;
+}
+
+std::size_t SceneStreamer::Tail(const StreamRequest& r) const
+{
+    const int32_t anchor = r.source->Parents()[r.spliced.load(std::memory_order_relaxed)];
+    const GameObject* parent = (anchor >= 0) ? target.Resolve(r.placed[anchor])
+        : r.toRoots ? nullptr : target.Resolve(r.parent);
+    // Roots go at the end; a destroyed parent cancels the request in SpliceBlock
+    if (!parent) return 0;
+    const std::size_t i = parent->GetIndex();
+    return target.Size() - (i + target.SubtreeSize(i));
+}
+
+bool SceneStreamer::InBlocks(std::size_t tail, double budgetMs) const
+{
+    // Moving the tail in every block must leave most of the frame to the new nodes
+    return static_cast<double>(tail) * moveNs <= budgetMs * 1e6 / 4;
+}
+
+std::size_t SceneStreamer::PlanBlock(const StreamRequest& r, std::size_t tail, double budgetMs, bool frameStart) const
+{
+    const std::size_t left = r.source->Size() - r.spliced.load(std::memory_order_relaxed);
+    const double budgetNs = budgetMs * 1e6;
+    // The rest in one pass (InsertNodes grows the arrays itself if they are short)
+    if (!InBlocks(tail, budgetMs)) return frameStart ? left : 0;
+
+    // In blocks, within the room of the arrays so that no block reallocates them
+    const std::size_t room = target.Capacity() - target.Size();
+    const double fit = (budgetNs - static_cast<double>(tail) * moveNs) / insertNs;
+    const std::size_t count = std::min({ left, room, static_cast<std::size_t>(std::max(fit, 0.0)) });
+    if (count >= std::min(left, BLOCK)) return count;
+    return frameStart ? std::min({ left, room, BLOCK }) : 0;
+}
+
+bool SceneStreamer::SpliceBlock(StreamRequest& r, std::size_t count)
+{
+    using State = StreamRequest::State;
+    const Scene& src = *r.source;
+    const std::span<const int32_t> srcParent = src.Parents();
+    const std::size_t first = r.spliced.load(std::memory_order_relaxed);
+    const std::size_t end = std::min(src.Size(), first + count);
+
+    // The block is cut into runs that hang from one node already in the target (or from
+    // the request's parent): a run starts with a node whose parent is before it and
+    // goes on while the next nodes are its descendants or siblings
+    std::vector<int32_t> runParents;
+    for (std::size_t s = first; s < end; )
+    {
+        const int32_t anchor = srcParent[s];
+        std::size_t e = s + 1;
+        while (e < end && (srcParent[e] >= static_cast<int32_t>(s) || srcParent[e] == anchor)) ++e;
+
+        GameObject* parent = nullptr;
+        if (anchor >= 0) parent = target.Resolve(r.placed[anchor]);
+        else if (!r.toRoots) parent = target.Resolve(r.parent);
+        if (!parent && (anchor >= 0 || !r.toRoots))
+        {
+            // Its parent was destroyed: drop the rest
+            Retire(r);
+            r.state.store(State::Canceled, std::memory_order_release);
+            return false;
+        }
+
+        runParents.resize(e - s);
+        for (std::size_t k = s; k < e; ++k)
+            runParents[k - s] = (srcParent[k] >= static_cast<int32_t>(s)) ? srcParent[k] - static_cast<int32_t>(s) : -1;
+        const std::size_t pos = target.InsertNodes(parent, src.Transforms().subspan(s, e - s), runParents,
+            src.Meshes().subspan(s, e - s));
+        for (std::size_t k = s; k < e; ++k)
+        {
+            // Names and tags are not in the arrays: interned again in the target
+            GameObject* node = target.Object(pos + (k - s));
+            const GameObject* from = src.Object(k);
+            if (!from->GetName().empty()) node->SetName(from->GetName());
+            if (!from->GetTag().empty()) node->SetTag(from->GetTag());
+            r.placed[k] = node->GetHandle();
+        }
+        s = e;
+    }
+
+    r.spliced.store(end, std::memory_order_release);
+    if (end < src.Size()) return true;
+    Retire(r);
+    r.state.store(State::Done, std::memory_order_release);
+    return false;
+}
+
+void SceneStreamer::Retire(StreamRequest& r)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        retired.push_back(std::move(r.source));
+    }
+    wake.notify_one();
+    r.placed = {};
+}
+
+SceneStreamer::Progress SceneStreamer::GetProgress() const
+{
+    Progress p{};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        p.building = queued.size() + building;
+        for (const auto& r : built) p.nodesPending += r->NodeCount();
+        p.splicing = built.size();
+    }
+    p.splicing += splicing.size();
+    for (const auto& r : splicing) p.nodesPending += r->NodeCount() - r->NodesSpliced();
+    p.lastUpdateMs = lastUpdateMs;
+    p.maxUpdateMs = maxUpdateMs;
+    return p;
+}
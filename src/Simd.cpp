@@ -0,0 +1,1162 @@
+#include "Simd.hpp"
+#include <atomic>
+#include <cmath>
+
+#if SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace Simd
+{
+    // ------------------ CPU detection ----------------
+
+#if SIMD_X86
+    static void CpuId(int leaf, int subleaf, unsigned int r[4])
+    {
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuidex(regs, leaf, subleaf);
+        for (int i = 0; i < 4; ++i) r[i] = static_cast<unsigned int>(regs[i]);
+#else
+        __cpuid_count(leaf, subleaf, r[0], r[1], r[2], r[3]);
+#endif
+    }
+
+    static unsigned long long XGetBV()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned int lo, hi;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+    }
+#endif
+
+    Level Detect()
+    {
+#if SIMD_X86
+        unsigned int r[4];
+        CpuId(0, 0, r);
+        const unsigned int maxLeaf = r[0];
+
+        CpuId(1, 0, r);
+        const bool sse2 = (r[3] >> 26) & 1;
+        const bool fma = (r[2] >> 12) & 1;
+        const bool osxsave = (r[2] >> 27) & 1;
+        const bool avx = (r[2] >> 28) & 1;
+        if (!sse2) return Level::Scalar;
+        if (!osxsave || !avx || maxLeaf < 7) return Level::SSE2;
+
+        // The OS must save the YMM state (and ZMM state for AVX-512)
+        const unsigned long long xcr0 = XGetBV();
+        const bool ymmState = (xcr0 & 0x6) == 0x6;
+        const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+        if (!ymmState) return Level::SSE2;
+
+        CpuId(7, 0, r);
+        const bool avx2 = (r[1] >> 5) & 1;
+        const bool avx512f = (r[1] >> 16) & 1;
+
+        if (avx512f && fma && zmmState) return Level::AVX512;
+        if (avx2 && fma) return Level::AVX2;
+        return Level::SSE2;
+#else
+        return Level::Scalar;
+#endif
+    }
+
+    const char* Name(Level level)
+    {
+        switch (level)
+        {
+        case Level::Scalar: return "Scalar";
+        case Level::SSE2:   return "SSE2";
+        case Level::AVX2:   return "AVX2";
+        case Level::AVX512: return "AVX-512";
+        }
+        return "Unknown";
+    }
+
+    // ------------------ Scalar (reference) ----------------
+
+    void Mat4MulScalar(const double* a, const double* b, double* out)
+    {
+        double c[16];
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                double sum = 0.0;
+                for (int k = 0; k < 4; ++k) {
+                    sum += a[i * 4 + k] * b[k * 4 + j];
+                }
+                c[i * 4 + j] = sum;
+            }
+        }
+        for (int i = 0; i < 16; ++i) out[i] = c[i];
+    }
+
+    void Mat4MulVec4Scalar(const double* m, const double* v, double* out)
+    {
+        double r[4];
+        for (int i = 0; i < 4; ++i) {
+            r[i] = m[i * 4 + 0] * v[0] + m[i * 4 + 1] * v[1] + m[i * 4 + 2] * v[2] + m[i * 4 + 3] * v[3];
+        }
+        for (int i = 0; i < 4; ++i) out[i] = r[i];
+    }
+
+    void Affine3x4MulScalar(const double* a, const double* b, double* out)
+    {
+        double c[12];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                c[i * 4 + j] = a[i * 4 + 0] * b[0 * 4 + j] + a[i * 4 + 1] * b[1 * 4 + j] + a[i * 4 + 2] * b[2 * 4 + j];
+            }
+            c[i * 4 + 3] += a[i * 4 + 3];
+        }
+        for (int i = 0; i < 12; ++i) out[i] = c[i];
+    }
+
+    void Mat4MulFScalar(const float* a, const float* b, float* out)
+    {
+        float c[16];
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                float sum = 0.0f;
+                for (int k = 0; k < 4; ++k) {
+                    sum += a[i * 4 + k] * b[k * 4 + j];
+                }
+                c[i * 4 + j] = sum;
+            }
+        }
+        for (int i = 0; i < 16; ++i) out[i] = c[i];
+    }
+
+#if SIMD_X86
+    // ------------------ SSE2 ----------------
+
+    // Row i of C = a_i0 * B_0 + a_i1 * B_1 + a_i2 * B_2 + a_i3 * B_3, in the same
+    // order as the scalar loop.
+    static void Mat4MulSSE2(const double* a, const double* b, double* out)
+    {
+        __m128d b0l = _mm_loadu_pd(b + 0), b0h = _mm_loadu_pd(b + 2);
+        __m128d b1l = _mm_loadu_pd(b + 4), b1h = _mm_loadu_pd(b + 6);
+        __m128d b2l = _mm_loadu_pd(b + 8), b2h = _mm_loadu_pd(b + 10);
+        __m128d b3l = _mm_loadu_pd(b + 12), b3h = _mm_loadu_pd(b + 14);
+
+        __m128d rows[8];
+        for (int i = 0; i < 4; ++i)
+        {
+            __m128d a0 = _mm_set1_pd(a[i * 4 + 0]);
+            __m128d a1 = _mm_set1_pd(a[i * 4 + 1]);
+            __m128d a2 = _mm_set1_pd(a[i * 4 + 2]);
+            __m128d a3 = _mm_set1_pd(a[i * 4 + 3]);
+
+            __m128d lo = _mm_mul_pd(a0, b0l);
+            __m128d hi = _mm_mul_pd(a0, b0h);
+            lo = _mm_add_pd(lo, _mm_mul_pd(a1, b1l));
+            hi = _mm_add_pd(hi, _mm_mul_pd(a1, b1h));
+            lo = _mm_add_pd(lo, _mm_mul_pd(a2, b2l));
+            hi = _mm_add_pd(hi, _mm_mul_pd(a2, b2h));
+            lo = _mm_add_pd(lo, _mm_mul_pd(a3, b3l));
+            hi = _mm_add_pd(hi, _mm_mul_pd(a3, b3h));
+            rows[i * 2 + 0] = lo;
+            rows[i * 2 + 1] = hi;
+        }
+        for (int i = 0; i < 8; ++i) _mm_storeu_pd(out + i * 2, rows[i]);
+    }
+
+    // Column pairs (m0j, m1j) and (m2j, m3j) keep the scalar summation order
+    static void Mat4MulVec4SSE2(const double* m, const double* v, double* out)
+    {
+        __m128d r0l = _mm_loadu_pd(m + 0), r0h = _mm_loadu_pd(m + 2);
+        __m128d r1l = _mm_loadu_pd(m + 4), r1h = _mm_loadu_pd(m + 6);
+        __m128d r2l = _mm_loadu_pd(m + 8), r2h = _mm_loadu_pd(m + 10);
+        __m128d r3l = _mm_loadu_pd(m + 12), r3h = _mm_loadu_pd(m + 14);
+
+        __m128d vx = _mm_set1_pd(v[0]), vy = _mm_set1_pd(v[1]);
+        __m128d vz = _mm_set1_pd(v[2]), vw = _mm_set1_pd(v[3]);
+
+        __m128d xy = _mm_mul_pd(_mm_unpacklo_pd(r0l, r1l), vx);
+        xy = _mm_add_pd(xy, _mm_mul_pd(_mm_unpackhi_pd(r0l, r1l), vy));
+        xy = _mm_add_pd(xy, _mm_mul_pd(_mm_unpacklo_pd(r0h, r1h), vz));
+        xy = _mm_add_pd(xy, _mm_mul_pd(_mm_unpackhi_pd(r0h, r1h), vw));
+
+        __m128d zw = _mm_mul_pd(_mm_unpacklo_pd(r2l, r3l), vx);
+        zw = _mm_add_pd(zw, _mm_mul_pd(_mm_unpackhi_pd(r2l, r3l), vy));
+        zw = _mm_add_pd(zw, _mm_mul_pd(_mm_unpacklo_pd(r2h, r3h), vz));
+        zw = _mm_add_pd(zw, _mm_mul_pd(_mm_unpackhi_pd(r2h, r3h), vw));
+
+        _mm_storeu_pd(out + 0, xy);
+        _mm_storeu_pd(out + 2, zw);
+    }
+
+    // Same order as the scalar loop: bit-identical
+    static void Affine3x4MulSSE2(const double* a, const double* b, double* out)
+    {
+        __m128d b0l = _mm_loadu_pd(b + 0), b0h = _mm_loadu_pd(b + 2);
+        __m128d b1l = _mm_loadu_pd(b + 4), b1h = _mm_loadu_pd(b + 6);
+        __m128d b2l = _mm_loadu_pd(b + 8), b2h = _mm_loadu_pd(b + 10);
+
+        __m128d rows[6];
+        for (int i = 0; i < 3; ++i)
+        {
+            __m128d a0 = _mm_set1_pd(a[i * 4 + 0]);
+            __m128d a1 = _mm_set1_pd(a[i * 4 + 1]);
+            __m128d a2 = _mm_set1_pd(a[i * 4 + 2]);
+
+            __m128d lo = _mm_mul_pd(a0, b0l);
+            __m128d hi = _mm_mul_pd(a0, b0h);
+            lo = _mm_add_pd(lo, _mm_mul_pd(a1, b1l));
+            hi = _mm_add_pd(hi, _mm_mul_pd(a1, b1h));
+            lo = _mm_add_pd(lo, _mm_mul_pd(a2, b2l));
+            hi = _mm_add_pd(hi, _mm_mul_pd(a2, b2h));
+            // Translation: + (0, a_i3)
+            hi = _mm_add_pd(hi, _mm_set_pd(a[i * 4 + 3], 0.0));
+            rows[i * 2 + 0] = lo;
+            rows[i * 2 + 1] = hi;
+        }
+        for (int i = 0; i < 6; ++i) _mm_storeu_pd(out + i * 2, rows[i]);
+    }
+
+    // A float row fits in one register
+    static void Mat4MulFSSE2(const float* a, const float* b, float* out)
+    {
+        __m128 b0 = _mm_loadu_ps(b + 0);
+        __m128 b1 = _mm_loadu_ps(b + 4);
+        __m128 b2 = _mm_loadu_ps(b + 8);
+        __m128 b3 = _mm_loadu_ps(b + 12);
+
+        __m128 rows[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            __m128 r = _mm_mul_ps(_mm_set1_ps(a[i * 4 + 0]), b0);
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 1]), b1));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 2]), b2));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 3]), b3));
+            rows[i] = r;
+        }
+        for (int i = 0; i < 4; ++i) _mm_storeu_ps(out + i * 4, rows[i]);
+    }
+
+    // ------------------ AVX2 + FMA ----------------
+
+    SIMD_TARGET("avx2,fma")
+    static void Mat4MulAVX2(const double* a, const double* b, double* out)
+    {
+        __m256d b0 = _mm256_loadu_pd(b + 0);
+        __m256d b1 = _mm256_loadu_pd(b + 4);
+        __m256d b2 = _mm256_loadu_pd(b + 8);
+        __m256d b3 = _mm256_loadu_pd(b + 12);
+
+        __m256d rows[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            __m256d r = _mm256_mul_pd(_mm256_broadcast_sd(a + i * 4 + 0), b0);
+            r = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 4 + 1), b1, r);
+            r = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 4 + 2), b2, r);
+            r = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 4 + 3), b3, r);
+            rows[i] = r;
+        }
+        for (int i = 0; i < 4; ++i) _mm256_storeu_pd(out + i * 4, rows[i]);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void Mat4MulVec4AVX2(const double* m, const double* v, double* out)
+    {
+        __m256d r0 = _mm256_loadu_pd(m + 0);
+        __m256d r1 = _mm256_loadu_pd(m + 4);
+        __m256d r2 = _mm256_loadu_pd(m + 8);
+        __m256d r3 = _mm256_loadu_pd(m + 12);
+
+        // 4x4 transpose: c_j = column j
+        __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+        __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+        __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+        __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+        __m256d c0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+        __m256d c1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+        __m256d c2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+        __m256d c3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+
+        __m256d r = _mm256_mul_pd(c0, _mm256_broadcast_sd(v + 0));
+        r = _mm256_fmadd_pd(c1, _mm256_broadcast_sd(v + 1), r);
+        r = _mm256_fmadd_pd(c2, _mm256_broadcast_sd(v + 2), r);
+        r = _mm256_fmadd_pd(c3, _mm256_broadcast_sd(v + 3), r);
+        _mm256_storeu_pd(out, r);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void Affine3x4MulAVX2(const double* a, const double* b, double* out)
+    {
+        __m256d b0 = _mm256_loadu_pd(b + 0);
+        __m256d b1 = _mm256_loadu_pd(b + 4);
+        __m256d b2 = _mm256_loadu_pd(b + 8);
+
+        __m256d rows[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            // Start from (0, 0, 0, a_i3) so the translation is one more FMA input
+            __m256d r = _mm256_set_pd(a[i * 4 + 3], 0.0, 0.0, 0.0);
+            r = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 4 + 0), b0, r);
+            r = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 4 + 1), b1, r);
+            r = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 4 + 2), b2, r);
+            rows[i] = r;
+        }
+        for (int i = 0; i < 3; ++i) _mm256_storeu_pd(out + i * 4, rows[i]);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void Mat4MulFAVX2(const float* a, const float* b, float* out)
+    {
+        __m128 b0 = _mm_loadu_ps(b + 0);
+        __m128 b1 = _mm_loadu_ps(b + 4);
+        __m128 b2 = _mm_loadu_ps(b + 8);
+        __m128 b3 = _mm_loadu_ps(b + 12);
+
+        __m128 rows[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            __m128 r = _mm_mul_ps(_mm_broadcast_ss(a + i * 4 + 0), b0);
+            r = _mm_fmadd_ps(_mm_broadcast_ss(a + i * 4 + 1), b1, r);
+            r = _mm_fmadd_ps(_mm_broadcast_ss(a + i * 4 + 2), b2, r);
+            r = _mm_fmadd_ps(_mm_broadcast_ss(a + i * 4 + 3), b3, r);
+            rows[i] = r;
+        }
+        for (int i = 0; i < 4; ++i) _mm_storeu_ps(out + i * 4, rows[i]);
+    }
+
+    // ------------------ AVX-512 ----------------
+
+    // Two rows of C per register: [row i | row i+1]
+    SIMD_TARGET("avx512f")
+    static void Mat4MulAVX512(const double* a, const double* b, double* out)
+    {
+        __m512d b0 = _mm512_broadcast_f64x4(_mm256_loadu_pd(b + 0));
+        __m512d b1 = _mm512_broadcast_f64x4(_mm256_loadu_pd(b + 4));
+        __m512d b2 = _mm512_broadcast_f64x4(_mm256_loadu_pd(b + 8));
+        __m512d b3 = _mm512_broadcast_f64x4(_mm256_loadu_pd(b + 12));
+
+        __m512d A01 = _mm512_loadu_pd(a + 0);
+        __m512d A23 = _mm512_loadu_pd(a + 8);
+
+        // Indices that splat a_ik over the 4 lanes of each half
+        const __m512i k0 = _mm512_set_epi64(4, 4, 4, 4, 0, 0, 0, 0);
+        const __m512i k1 = _mm512_set_epi64(5, 5, 5, 5, 1, 1, 1, 1);
+        const __m512i k2 = _mm512_set_epi64(6, 6, 6, 6, 2, 2, 2, 2);
+        const __m512i k3 = _mm512_set_epi64(7, 7, 7, 7, 3, 3, 3, 3);
+
+        __m512d r01 = _mm512_mul_pd(_mm512_permutexvar_pd(k0, A01), b0);
+        r01 = _mm512_fmadd_pd(_mm512_permutexvar_pd(k1, A01), b1, r01);
+        r01 = _mm512_fmadd_pd(_mm512_permutexvar_pd(k2, A01), b2, r01);
+        r01 = _mm512_fmadd_pd(_mm512_permutexvar_pd(k3, A01), b3, r01);
+
+        __m512d r23 = _mm512_mul_pd(_mm512_permutexvar_pd(k0, A23), b0);
+        r23 = _mm512_fmadd_pd(_mm512_permutexvar_pd(k1, A23), b1, r23);
+        r23 = _mm512_fmadd_pd(_mm512_permutexvar_pd(k2, A23), b2, r23);
+        r23 = _mm512_fmadd_pd(_mm512_permutexvar_pd(k3, A23), b3, r23);
+
+        _mm512_storeu_pd(out + 0, r01);
+        _mm512_storeu_pd(out + 8, r23);
+    }
+
+    // A single 4-vector doesn't fill a ZMM register: the AVX2 kernel is used (same bound).
+#endif
+
+    // ------------------ Bulk transforms (SoA) ----------------
+
+    void TransformAffineSoAScalar(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n, double w)
+    {
+        const double tx = m[3] * w, ty = m[7] * w, tz = m[11] * w;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            // Locals first: the output may alias the input
+            const double px = x[i], py = y[i], pz = z[i];
+            ox[i] = m[0] * px + m[1] * py + m[2] * pz + tx;
+            oy[i] = m[4] * px + m[5] * py + m[6] * pz + ty;
+            oz[i] = m[8] * px + m[9] * py + m[10] * pz + tz;
+        }
+    }
+
+    void TransformProjectiveSoAScalar(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double px = x[i], py = y[i], pz = z[i];
+            const double rw = m[12] * px + m[13] * py + m[14] * pz + m[15];
+            const double inv = (rw != 0.0) ? 1.0 / rw : 1.0;
+            ox[i] = (m[0] * px + m[1] * py + m[2] * pz + m[3]) * inv;
+            oy[i] = (m[4] * px + m[5] * py + m[6] * pz + m[7]) * inv;
+            oz[i] = (m[8] * px + m[9] * py + m[10] * pz + m[11]) * inv;
+        }
+    }
+
+#if SIMD_X86
+    static void TransformAffineSoASSE2(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n, double w)
+    {
+        __m128d c[12];
+        for (int k = 0; k < 12; ++k) c[k] = _mm_set1_pd(m[k]);
+        const __m128d tx = _mm_set1_pd(m[3] * w), ty = _mm_set1_pd(m[7] * w), tz = _mm_set1_pd(m[11] * w);
+
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d X = _mm_loadu_pd(x + i), Y = _mm_loadu_pd(y + i), Z = _mm_loadu_pd(z + i);
+            __m128d rx = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c[0], X), _mm_mul_pd(c[1], Y)), _mm_mul_pd(c[2], Z)), tx);
+            __m128d ry = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c[4], X), _mm_mul_pd(c[5], Y)), _mm_mul_pd(c[6], Z)), ty);
+            __m128d rz = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c[8], X), _mm_mul_pd(c[9], Y)), _mm_mul_pd(c[10], Z)), tz);
+            _mm_storeu_pd(ox + i, rx);
+            _mm_storeu_pd(oy + i, ry);
+            _mm_storeu_pd(oz + i, rz);
+        }
+        TransformAffineSoAScalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, n - i, w);
+    }
+
+    static void TransformProjectiveSoASSE2(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n)
+    {
+        __m128d c[16];
+        for (int k = 0; k < 16; ++k) c[k] = _mm_set1_pd(m[k]);
+        const __m128d one = _mm_set1_pd(1.0), zero = _mm_setzero_pd();
+
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d X = _mm_loadu_pd(x + i), Y = _mm_loadu_pd(y + i), Z = _mm_loadu_pd(z + i);
+            __m128d rw = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c[12], X), _mm_mul_pd(c[13], Y)), _mm_mul_pd(c[14], Z)), c[15]);
+            __m128d nz = _mm_cmpneq_pd(rw, zero);
+            __m128d inv = _mm_or_pd(_mm_and_pd(nz, _mm_div_pd(one, rw)), _mm_andnot_pd(nz, one));
+            __m128d rx = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c[0], X), _mm_mul_pd(c[1], Y)), _mm_mul_pd(c[2], Z)), c[3]);
+            __m128d ry = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c[4], X), _mm_mul_pd(c[5], Y)), _mm_mul_pd(c[6], Z)), c[7]);
+            __m128d rz = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c[8], X), _mm_mul_pd(c[9], Y)), _mm_mul_pd(c[10], Z)), c[11]);
+            _mm_storeu_pd(ox + i, _mm_mul_pd(rx, inv));
+            _mm_storeu_pd(oy + i, _mm_mul_pd(ry, inv));
+            _mm_storeu_pd(oz + i, _mm_mul_pd(rz, inv));
+        }
+        TransformProjectiveSoAScalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, n - i);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void TransformAffineSoAAVX2(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n, double w)
+    {
+        __m256d c[12];
+        for (int k = 0; k < 12; ++k) c[k] = _mm256_set1_pd(m[k]);
+        const __m256d tx = _mm256_set1_pd(m[3] * w), ty = _mm256_set1_pd(m[7] * w), tz = _mm256_set1_pd(m[11] * w);
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d X = _mm256_loadu_pd(x + i), Y = _mm256_loadu_pd(y + i), Z = _mm256_loadu_pd(z + i);
+            __m256d rx = _mm256_fmadd_pd(c[2], Z, _mm256_fmadd_pd(c[1], Y, _mm256_mul_pd(c[0], X)));
+            __m256d ry = _mm256_fmadd_pd(c[6], Z, _mm256_fmadd_pd(c[5], Y, _mm256_mul_pd(c[4], X)));
+            __m256d rz = _mm256_fmadd_pd(c[10], Z, _mm256_fmadd_pd(c[9], Y, _mm256_mul_pd(c[8], X)));
+            _mm256_storeu_pd(ox + i, _mm256_add_pd(rx, tx));
+            _mm256_storeu_pd(oy + i, _mm256_add_pd(ry, ty));
+            _mm256_storeu_pd(oz + i, _mm256_add_pd(rz, tz));
+        }
+        TransformAffineSoAScalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, n - i, w);
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void TransformProjectiveSoAAVX2(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n)
+    {
+        __m256d c[16];
+        for (int k = 0; k < 16; ++k) c[k] = _mm256_set1_pd(m[k]);
+        const __m256d one = _mm256_set1_pd(1.0), zero = _mm256_setzero_pd();
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d X = _mm256_loadu_pd(x + i), Y = _mm256_loadu_pd(y + i), Z = _mm256_loadu_pd(z + i);
+            __m256d rw = _mm256_add_pd(_mm256_fmadd_pd(c[14], Z, _mm256_fmadd_pd(c[13], Y, _mm256_mul_pd(c[12], X))), c[15]);
+            __m256d nz = _mm256_cmp_pd(rw, zero, _CMP_NEQ_UQ);
+            __m256d inv = _mm256_blendv_pd(one, _mm256_div_pd(one, rw), nz);
+            __m256d rx = _mm256_add_pd(_mm256_fmadd_pd(c[2], Z, _mm256_fmadd_pd(c[1], Y, _mm256_mul_pd(c[0], X))), c[3]);
+            __m256d ry = _mm256_add_pd(_mm256_fmadd_pd(c[6], Z, _mm256_fmadd_pd(c[5], Y, _mm256_mul_pd(c[4], X))), c[7]);
+            __m256d rz = _mm256_add_pd(_mm256_fmadd_pd(c[10], Z, _mm256_fmadd_pd(c[9], Y, _mm256_mul_pd(c[8], X))), c[11]);
+            _mm256_storeu_pd(ox + i, _mm256_mul_pd(rx, inv));
+            _mm256_storeu_pd(oy + i, _mm256_mul_pd(ry, inv));
+            _mm256_storeu_pd(oz + i, _mm256_mul_pd(rz, inv));
+        }
+        TransformProjectiveSoAScalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, n - i);
+    }
+
+    SIMD_TARGET("avx512f")
+    static void TransformAffineSoAAVX512(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n, double w)
+    {
+        __m512d c[12];
+        for (int k = 0; k < 12; ++k) c[k] = _mm512_set1_pd(m[k]);
+        const __m512d tx = _mm512_set1_pd(m[3] * w), ty = _mm512_set1_pd(m[7] * w), tz = _mm512_set1_pd(m[11] * w);
+
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m512d X = _mm512_loadu_pd(x + i), Y = _mm512_loadu_pd(y + i), Z = _mm512_loadu_pd(z + i);
+            __m512d rx = _mm512_fmadd_pd(c[2], Z, _mm512_fmadd_pd(c[1], Y, _mm512_mul_pd(c[0], X)));
+            __m512d ry = _mm512_fmadd_pd(c[6], Z, _mm512_fmadd_pd(c[5], Y, _mm512_mul_pd(c[4], X)));
+            __m512d rz = _mm512_fmadd_pd(c[10], Z, _mm512_fmadd_pd(c[9], Y, _mm512_mul_pd(c[8], X)));
+            _mm512_storeu_pd(ox + i, _mm512_add_pd(rx, tx));
+            _mm512_storeu_pd(oy + i, _mm512_add_pd(ry, ty));
+            _mm512_storeu_pd(oz + i, _mm512_add_pd(rz, tz));
+        }
+        TransformAffineSoAScalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, n - i, w);
+    }
+
+    SIMD_TARGET("avx512f")
+    static void TransformProjectiveSoAAVX512(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n)
+    {
+        __m512d c[16];
+        for (int k = 0; k < 16; ++k) c[k] = _mm512_set1_pd(m[k]);
+        const __m512d one = _mm512_set1_pd(1.0), zero = _mm512_setzero_pd();
+
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m512d X = _mm512_loadu_pd(x + i), Y = _mm512_loadu_pd(y + i), Z = _mm512_loadu_pd(z + i);
+            __m512d rw = _mm512_add_pd(_mm512_fmadd_pd(c[14], Z, _mm512_fmadd_pd(c[13], Y, _mm512_mul_pd(c[12], X))), c[15]);
+            __mmask8 nz = _mm512_cmp_pd_mask(rw, zero, _CMP_NEQ_UQ);
+            __m512d inv = _mm512_mask_div_pd(one, nz, one, rw);
+            __m512d rx = _mm512_add_pd(_mm512_fmadd_pd(c[2], Z, _mm512_fmadd_pd(c[1], Y, _mm512_mul_pd(c[0], X))), c[3]);
+            __m512d ry = _mm512_add_pd(_mm512_fmadd_pd(c[6], Z, _mm512_fmadd_pd(c[5], Y, _mm512_mul_pd(c[4], X))), c[7]);
+            __m512d rz = _mm512_add_pd(_mm512_fmadd_pd(c[10], Z, _mm512_fmadd_pd(c[9], Y, _mm512_mul_pd(c[8], X))), c[11]);
+            _mm512_storeu_pd(ox + i, _mm512_mul_pd(rx, inv));
+            _mm512_storeu_pd(oy + i, _mm512_mul_pd(ry, inv));
+            _mm512_storeu_pd(oz + i, _mm512_mul_pd(rz, inv));
+        }
+        TransformProjectiveSoAScalar(m, x + i, y + i, z + i, ox + i, oy + i, oz + i, n - i);
+    }
+#endif
+
+    // ------------------ Bulk transforms (AoS, stride of 3 doubles) ----------------
+
+    void TransformAffineAoSScalar(const double* m, const double* in, double* out, std::size_t n, double w)
+    {
+        const double tx = m[3] * w, ty = m[7] * w, tz = m[11] * w;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double px = in[i * 3 + 0], py = in[i * 3 + 1], pz = in[i * 3 + 2];
+            out[i * 3 + 0] = m[0] * px + m[1] * py + m[2] * pz + tx;
+            out[i * 3 + 1] = m[4] * px + m[5] * py + m[6] * pz + ty;
+            out[i * 3 + 2] = m[8] * px + m[9] * py + m[10] * pz + tz;
+        }
+    }
+
+    void TransformProjectiveAoSScalar(const double* m, const double* in, double* out, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double px = in[i * 3 + 0], py = in[i * 3 + 1], pz = in[i * 3 + 2];
+            const double rw = m[12] * px + m[13] * py + m[14] * pz + m[15];
+            const double inv = (rw != 0.0) ? 1.0 / rw : 1.0;
+            out[i * 3 + 0] = (m[0] * px + m[1] * py + m[2] * pz + m[3]) * inv;
+            out[i * 3 + 1] = (m[4] * px + m[5] * py + m[6] * pz + m[7]) * inv;
+            out[i * 3 + 2] = (m[8] * px + m[9] * py + m[10] * pz + m[11]) * inv;
+        }
+    }
+
+#if SIMD_X86
+    // (x, y) of each point in one register, z in scalar code. Same order as the scalar loop.
+    static void TransformAffineAoSSSE2(const double* m, const double* in, double* out, std::size_t n, double w)
+    {
+        const __m128d c0 = _mm_setr_pd(m[0], m[4]), c1 = _mm_setr_pd(m[1], m[5]), c2 = _mm_setr_pd(m[2], m[6]);
+        const __m128d t = _mm_setr_pd(m[3] * w, m[7] * w);
+        const double tz = m[11] * w;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double px = in[i * 3 + 0], py = in[i * 3 + 1], pz = in[i * 3 + 2];
+            __m128d r = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(c0, _mm_set1_pd(px)), _mm_mul_pd(c1, _mm_set1_pd(py))),
+                _mm_mul_pd(c2, _mm_set1_pd(pz))), t);
+            _mm_storeu_pd(out + i * 3, r);
+            out[i * 3 + 2] = m[8] * px + m[9] * py + m[10] * pz + tz;
+        }
+    }
+
+    // One point per iteration: the columns of M are scaled by the broadcast x, y, z.
+    // Lane 3 is unused by the affine kernel and holds w in the projective one.
+    SIMD_TARGET("avx2,fma")
+    static void TransformAffineAoSAVX2(const double* m, const double* in, double* out, std::size_t n, double w)
+    {
+        const __m256d c0 = _mm256_setr_pd(m[0], m[4], m[8], 0.0);
+        const __m256d c1 = _mm256_setr_pd(m[1], m[5], m[9], 0.0);
+        const __m256d c2 = _mm256_setr_pd(m[2], m[6], m[10], 0.0);
+        const __m256d t = _mm256_setr_pd(m[3] * w, m[7] * w, m[11] * w, 0.0);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double* p = in + i * 3;
+            __m256d r = _mm256_mul_pd(c0, _mm256_broadcast_sd(p + 0));
+            r = _mm256_fmadd_pd(c1, _mm256_broadcast_sd(p + 1), r);
+            r = _mm256_fmadd_pd(c2, _mm256_broadcast_sd(p + 2), r);
+            r = _mm256_add_pd(r, t);
+            _mm_storeu_pd(out + i * 3, _mm256_castpd256_pd128(r));
+            _mm_store_sd(out + i * 3 + 2, _mm256_extractf128_pd(r, 1));
+        }
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static void TransformProjectiveAoSAVX2(const double* m, const double* in, double* out, std::size_t n)
+    {
+        const __m256d c0 = _mm256_setr_pd(m[0], m[4], m[8], m[12]);
+        const __m256d c1 = _mm256_setr_pd(m[1], m[5], m[9], m[13]);
+        const __m256d c2 = _mm256_setr_pd(m[2], m[6], m[10], m[14]);
+        const __m256d c3 = _mm256_setr_pd(m[3], m[7], m[11], m[15]);
+        const __m256d one = _mm256_set1_pd(1.0), zero = _mm256_setzero_pd();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double* p = in + i * 3;
+            __m256d r = _mm256_mul_pd(c0, _mm256_broadcast_sd(p + 0));
+            r = _mm256_fmadd_pd(c1, _mm256_broadcast_sd(p + 1), r);
+            r = _mm256_fmadd_pd(c2, _mm256_broadcast_sd(p + 2), r);
+            r = _mm256_add_pd(r, c3);
+            __m256d rw = _mm256_permute4x64_pd(r, 0xFF);
+            __m256d nz = _mm256_cmp_pd(rw, zero, _CMP_NEQ_UQ);
+            r = _mm256_mul_pd(r, _mm256_blendv_pd(one, _mm256_div_pd(one, rw), nz));
+            _mm_storeu_pd(out + i * 3, _mm256_castpd256_pd128(r));
+            _mm_store_sd(out + i * 3 + 2, _mm256_extractf128_pd(r, 1));
+        }
+    }
+#endif
+
+    // ------------------ Inverse ----------------
+
+    // Cofactors from the 2x2 sub-determinants of the top (s) and bottom (c) row pairs.
+    // Works on either storage order: inverting the transpose gives the transposed inverse.
+    template<typename T>
+    static T Mat4InverseCofactor(const T* a, T* out)
+    {
+        const T s0 = a[0] * a[5] - a[4] * a[1];
+        const T s1 = a[0] * a[6] - a[4] * a[2];
+        const T s2 = a[0] * a[7] - a[4] * a[3];
+        const T s3 = a[1] * a[6] - a[5] * a[2];
+        const T s4 = a[1] * a[7] - a[5] * a[3];
+        const T s5 = a[2] * a[7] - a[6] * a[3];
+
+        const T c5 = a[10] * a[15] - a[14] * a[11];
+        const T c4 = a[9] * a[15] - a[13] * a[11];
+        const T c3 = a[9] * a[14] - a[13] * a[10];
+        const T c2 = a[8] * a[15] - a[12] * a[11];
+        const T c1 = a[8] * a[14] - a[12] * a[10];
+        const T c0 = a[8] * a[13] - a[12] * a[9];
+
+        const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        const T inv = T(1) / det;
+
+        T b[16];
+        b[0] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * inv;
+        b[1] = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * inv;
+        b[2] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * inv;
+        b[3] = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * inv;
+
+        b[4] = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * inv;
+        b[5] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * inv;
+        b[6] = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * inv;
+        b[7] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * inv;
+
+        b[8] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * inv;
+        b[9] = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * inv;
+        b[10] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * inv;
+        b[11] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * inv;
+
+        b[12] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * inv;
+        b[13] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * inv;
+        b[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * inv;
+        b[15] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * inv;
+
+        for (int i = 0; i < 16; ++i) out[i] = b[i];
+        return det;
+    }
+
+    double Mat4InverseScalar(const double* m, double* out)
+    {
+        return Mat4InverseCofactor(m, out);
+    }
+
+    float Mat4InverseScalar(const float* m, float* out)
+    {
+        return Mat4InverseCofactor(m, out);
+    }
+
+#if SIMD_X86
+    // Blockwise inverse on 2x2 sub-matrices, one block [a b; c d] per register
+    // (row-major lanes a, b, c, d). Uses only the adjugates of the blocks, so the
+    // single division is 1 / det(M).
+
+#define SIMD_SWZ(v, a, b, c, d) _mm256_permute4x64_pd((v), (a) | ((b) << 2) | ((c) << 4) | ((d) << 6))
+
+    // A * B
+    SIMD_TARGET("avx2,fma")
+    static inline __m256d Mat2Mul(__m256d a, __m256d b)
+    {
+        return _mm256_fmadd_pd(a, SIMD_SWZ(b, 0, 3, 0, 3), _mm256_mul_pd(SIMD_SWZ(a, 1, 0, 3, 2), SIMD_SWZ(b, 2, 1, 2, 1)));
+    }
+
+    // adj(A) * B
+    SIMD_TARGET("avx2,fma")
+    static inline __m256d Mat2AdjMul(__m256d a, __m256d b)
+    {
+        return _mm256_fmsub_pd(SIMD_SWZ(a, 3, 3, 0, 0), b, _mm256_mul_pd(SIMD_SWZ(a, 1, 1, 2, 2), SIMD_SWZ(b, 2, 3, 0, 1)));
+    }
+
+    // A * adj(B)
+    SIMD_TARGET("avx2,fma")
+    static inline __m256d Mat2MulAdj(__m256d a, __m256d b)
+    {
+        return _mm256_fmsub_pd(a, SIMD_SWZ(b, 3, 0, 3, 0), _mm256_mul_pd(SIMD_SWZ(a, 1, 0, 3, 2), SIMD_SWZ(b, 2, 1, 2, 1)));
+    }
+
+    SIMD_TARGET("avx2,fma")
+    static double Mat4InverseAVX2(const double* m, double* out)
+    {
+        const __m256d r0 = _mm256_loadu_pd(m + 0);
+        const __m256d r1 = _mm256_loadu_pd(m + 4);
+        const __m256d r2 = _mm256_loadu_pd(m + 8);
+        const __m256d r3 = _mm256_loadu_pd(m + 12);
+
+        // M = [A B; C D]
+        const __m256d A = _mm256_permute2f128_pd(r0, r1, 0x20);
+        const __m256d B = _mm256_permute2f128_pd(r0, r1, 0x31);
+        const __m256d C = _mm256_permute2f128_pd(r2, r3, 0x20);
+        const __m256d D = _mm256_permute2f128_pd(r2, r3, 0x31);
+
+        // (det A, det B, det C, det D)
+        const __m256d even = _mm256_blend_pd(SIMD_SWZ(r0, 0, 2, 0, 2), SIMD_SWZ(r2, 0, 2, 0, 2), 0xC);
+        const __m256d odd = _mm256_blend_pd(SIMD_SWZ(r1, 1, 3, 1, 3), SIMD_SWZ(r3, 1, 3, 1, 3), 0xC);
+        const __m256d evenB = _mm256_blend_pd(SIMD_SWZ(r0, 1, 3, 1, 3), SIMD_SWZ(r2, 1, 3, 1, 3), 0xC);
+        const __m256d oddB = _mm256_blend_pd(SIMD_SWZ(r1, 0, 2, 0, 2), SIMD_SWZ(r3, 0, 2, 0, 2), 0xC);
+        const __m256d detSub = _mm256_fmsub_pd(even, odd, _mm256_mul_pd(evenB, oddB));
+        const __m256d detA = SIMD_SWZ(detSub, 0, 0, 0, 0);
+        const __m256d detB = SIMD_SWZ(detSub, 1, 1, 1, 1);
+        const __m256d detC = SIMD_SWZ(detSub, 2, 2, 2, 2);
+        const __m256d detD = SIMD_SWZ(detSub, 3, 3, 3, 3);
+
+        const __m256d DC = Mat2AdjMul(D, C);
+        const __m256d AB = Mat2AdjMul(A, B);
+
+        __m256d X = _mm256_fmsub_pd(detD, A, Mat2Mul(B, DC));
+        __m256d W = _mm256_fmsub_pd(detA, D, Mat2Mul(C, AB));
+        __m256d Y = _mm256_fmsub_pd(detB, C, Mat2MulAdj(D, AB));
+        __m256d Z = _mm256_fmsub_pd(detC, B, Mat2MulAdj(A, DC));
+
+        // det M = det A det D + det B det C - tr(adj(A) B adj(D) C)
+        const __m256d tr = _mm256_mul_pd(AB, SIMD_SWZ(DC, 0, 2, 1, 3));
+        const __m128d trh = _mm_add_pd(_mm256_castpd256_pd128(tr), _mm256_extractf128_pd(tr, 1));
+        const double trace = _mm_cvtsd_f64(_mm_add_sd(trh, _mm_unpackhi_pd(trh, trh)));
+        const double det = _mm_cvtsd_f64(_mm256_castpd256_pd128(detA)) * _mm_cvtsd_f64(_mm256_castpd256_pd128(detD))
+            + _mm_cvtsd_f64(_mm256_castpd256_pd128(detB)) * _mm_cvtsd_f64(_mm256_castpd256_pd128(detC)) - trace;
+
+        // Blocks of the inverse are adj(X), adj(Y), ... / det: the adjugate swaps and negates
+        const __m256d scale = _mm256_div_pd(_mm256_setr_pd(1.0, -1.0, -1.0, 1.0), _mm256_set1_pd(det));
+        X = _mm256_mul_pd(X, scale);
+        Y = _mm256_mul_pd(Y, scale);
+        Z = _mm256_mul_pd(Z, scale);
+        W = _mm256_mul_pd(W, scale);
+
+        _mm256_storeu_pd(out + 0, _mm256_blend_pd(SIMD_SWZ(X, 3, 1, 3, 1), SIMD_SWZ(Y, 3, 1, 3, 1), 0xC));
+        _mm256_storeu_pd(out + 4, _mm256_blend_pd(SIMD_SWZ(X, 2, 0, 2, 0), SIMD_SWZ(Y, 2, 0, 2, 0), 0xC));
+        _mm256_storeu_pd(out + 8, _mm256_blend_pd(SIMD_SWZ(Z, 3, 1, 3, 1), SIMD_SWZ(W, 3, 1, 3, 1), 0xC));
+        _mm256_storeu_pd(out + 12, _mm256_blend_pd(SIMD_SWZ(Z, 2, 0, 2, 0), SIMD_SWZ(W, 2, 0, 2, 0), 0xC));
+        return det;
+    }
+
+#undef SIMD_SWZ
+#endif
+
+    // ------------------ Frustum tests (SoA boxes) ----------------
+    // Same expressions as TFrustum::Classify, without FMA, so every level gives its result
+
+    void ClassifyBoxesSoAScalar(const double* planes, const double* x0, const double* y0, const double* z0,
+        const double* x1, const double* y1, const double* z1, unsigned char* out, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double cx = 0.5 * (x0[i] + x1[i]), cy = 0.5 * (y0[i] + y1[i]), cz = 0.5 * (z0[i] + z1[i]);
+            const double ex = 0.5 * (x1[i] - x0[i]), ey = 0.5 * (y1[i] - y0[i]), ez = 0.5 * (z1[i] - z0[i]);
+            unsigned char result = 2;
+            for (int k = 0; k < 6; ++k)
+            {
+                const double* p = planes + 4 * k;
+                const double s = p[0] * cx + p[1] * cy + p[2] * cz + p[3];
+                const double r = std::fabs(p[0]) * ex + std::fabs(p[1]) * ey + std::fabs(p[2]) * ez;
+                if (s + r < 0) { result = 0; break; }
+                if (!(s - r >= 0)) result = 1;
+            }
+            out[i] = result;
+        }
+    }
+
+#if SIMD_X86
+    static void ClassifyBoxesSoASSE2(const double* planes, const double* x0, const double* y0, const double* z0,
+        const double* x1, const double* y1, const double* z1, unsigned char* out, std::size_t n)
+    {
+        __m128d pn[6][3], pa[6][3], pd[6];
+        for (int k = 0; k < 6; ++k)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                pn[k][j] = _mm_set1_pd(planes[4 * k + j]);
+                pa[k][j] = _mm_set1_pd(std::fabs(planes[4 * k + j]));
+            }
+            pd[k] = _mm_set1_pd(planes[4 * k + 3]);
+        }
+        const __m128d zero = _mm_setzero_pd(), half = _mm_set1_pd(0.5);
+
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d X0 = _mm_loadu_pd(x0 + i), Y0 = _mm_loadu_pd(y0 + i), Z0 = _mm_loadu_pd(z0 + i);
+            const __m128d X1 = _mm_loadu_pd(x1 + i), Y1 = _mm_loadu_pd(y1 + i), Z1 = _mm_loadu_pd(z1 + i);
+            const __m128d X = _mm_mul_pd(half, _mm_add_pd(X0, X1)), EX = _mm_mul_pd(half, _mm_sub_pd(X1, X0));
+            const __m128d Y = _mm_mul_pd(half, _mm_add_pd(Y0, Y1)), EY = _mm_mul_pd(half, _mm_sub_pd(Y1, Y0));
+            const __m128d Z = _mm_mul_pd(half, _mm_add_pd(Z0, Z1)), EZ = _mm_mul_pd(half, _mm_sub_pd(Z1, Z0));
+            __m128d outside = zero, straddle = zero;
+            for (int k = 0; k < 6; ++k)
+            {
+                const __m128d s = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(pn[k][0], X), _mm_mul_pd(pn[k][1], Y)),
+                    _mm_mul_pd(pn[k][2], Z)), pd[k]);
+                const __m128d r = _mm_add_pd(_mm_add_pd(_mm_mul_pd(pa[k][0], EX), _mm_mul_pd(pa[k][1], EY)),
+                    _mm_mul_pd(pa[k][2], EZ));
+                outside = _mm_or_pd(outside, _mm_cmplt_pd(_mm_add_pd(s, r), zero));
+                straddle = _mm_or_pd(straddle, _mm_cmpnge_pd(_mm_sub_pd(s, r), zero));
+            }
+            const int o = _mm_movemask_pd(outside), st = _mm_movemask_pd(straddle);
+            for (int l = 0; l < 2; ++l)
+                out[i + l] = ((o >> l) & 1) ? 0 : ((st >> l) & 1) ? 1 : 2;
+        }
+        ClassifyBoxesSoAScalar(planes, x0 + i, y0 + i, z0 + i, x1 + i, y1 + i, z1 + i, out + i, n - i);
+    }
+
+    SIMD_TARGET("avx2")
+    static void ClassifyBoxesSoAAVX2(const double* planes, const double* x0, const double* y0, const double* z0,
+        const double* x1, const double* y1, const double* z1, unsigned char* out, std::size_t n)
+    {
+        __m256d pn[6][3], pa[6][3], pd[6];
+        for (int k = 0; k < 6; ++k)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                pn[k][j] = _mm256_set1_pd(planes[4 * k + j]);
+                pa[k][j] = _mm256_set1_pd(std::fabs(planes[4 * k + j]));
+            }
+            pd[k] = _mm256_set1_pd(planes[4 * k + 3]);
+        }
+        const __m256d zero = _mm256_setzero_pd(), half = _mm256_set1_pd(0.5);
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d X0 = _mm256_loadu_pd(x0 + i), Y0 = _mm256_loadu_pd(y0 + i), Z0 = _mm256_loadu_pd(z0 + i);
+            const __m256d X1 = _mm256_loadu_pd(x1 + i), Y1 = _mm256_loadu_pd(y1 + i), Z1 = _mm256_loadu_pd(z1 + i);
+            const __m256d X = _mm256_mul_pd(half, _mm256_add_pd(X0, X1)), EX = _mm256_mul_pd(half, _mm256_sub_pd(X1, X0));
+            const __m256d Y = _mm256_mul_pd(half, _mm256_add_pd(Y0, Y1)), EY = _mm256_mul_pd(half, _mm256_sub_pd(Y1, Y0));
+            const __m256d Z = _mm256_mul_pd(half, _mm256_add_pd(Z0, Z1)), EZ = _mm256_mul_pd(half, _mm256_sub_pd(Z1, Z0));
+            __m256d outside = zero, straddle = zero;
+            for (int k = 0; k < 6; ++k)
+            {
+                const __m256d s = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(pn[k][0], X),
+                    _mm256_mul_pd(pn[k][1], Y)), _mm256_mul_pd(pn[k][2], Z)), pd[k]);
+                const __m256d r = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(pa[k][0], EX), _mm256_mul_pd(pa[k][1], EY)),
+                    _mm256_mul_pd(pa[k][2], EZ));
+                outside = _mm256_or_pd(outside, _mm256_cmp_pd(_mm256_add_pd(s, r), zero, _CMP_LT_OQ));
+                straddle = _mm256_or_pd(straddle, _mm256_cmp_pd(_mm256_sub_pd(s, r), zero, _CMP_NGE_UQ));
+            }
+            const int o = _mm256_movemask_pd(outside), st = _mm256_movemask_pd(straddle);
+            for (int l = 0; l < 4; ++l)
+                out[i + l] = ((o >> l) & 1) ? 0 : ((st >> l) & 1) ? 1 : 2;
+        }
+        ClassifyBoxesSoAScalar(planes, x0 + i, y0 + i, z0 + i, x1 + i, y1 + i, z1 + i, out + i, n - i);
+    }
+#endif
+
+    // ------------------ Ray / triangle tests (SoA triangles) ----------------
+    // Moller-Trumbore, both sides. Every test is written so that a NaN (a degenerate
+    // triangle or one parallel to the ray) is a miss. No FMA, as the frustum tests.
+
+    // Triangles [begin, n) of the n in tri; returns n when none is nearer than t
+    static std::size_t IntersectRayTrianglesSoAScalarTail(const double* ray, const double* tri, std::size_t n,
+        std::size_t begin, double& t)
+    {
+        const double* v0x = tri;         const double* v0y = tri + n;     const double* v0z = tri + 2 * n;
+        const double* e1x = tri + 3 * n; const double* e1y = tri + 4 * n; const double* e1z = tri + 5 * n;
+        const double* e2x = tri + 6 * n; const double* e2y = tri + 7 * n; const double* e2z = tri + 8 * n;
+        const double ox = ray[0], oy = ray[1], oz = ray[2], dx = ray[3], dy = ray[4], dz = ray[5];
+        std::size_t nearest = n;
+        for (std::size_t i = begin; i < n; ++i)
+        {
+            const double px = dy * e2z[i] - dz * e2y[i], py = dz * e2x[i] - dx * e2z[i], pz = dx * e2y[i] - dy * e2x[i];
+            const double inv = 1.0 / (e1x[i] * px + e1y[i] * py + e1z[i] * pz);
+            const double sx = ox - v0x[i], sy = oy - v0y[i], sz = oz - v0z[i];
+            const double u = (sx * px + sy * py + sz * pz) * inv;
+            const double qx = sy * e1z[i] - sz * e1y[i], qy = sz * e1x[i] - sx * e1z[i], qz = sx * e1y[i] - sy * e1x[i];
+            const double v = (dx * qx + dy * qy + dz * qz) * inv;
+            const double ti = (e2x[i] * qx + e2y[i] * qy + e2z[i] * qz) * inv;
+            if (u >= 0 && v >= 0 && u + v <= 1 && ti >= 0 && ti < t) { t = ti; nearest = i; }
+        }
+        return nearest;
+    }
+
+    std::size_t IntersectRayTrianglesSoAScalar(const double* ray, const double* tri, std::size_t n, double& t)
+    {
+        return IntersectRayTrianglesSoAScalarTail(ray, tri, n, 0, t);
+    }
+
+#if SIMD_X86
+    static std::size_t IntersectRayTrianglesSoASSE2(const double* ray, const double* tri, std::size_t n, double& t)
+    {
+        const double* v0x = tri;         const double* v0y = tri + n;     const double* v0z = tri + 2 * n;
+        const double* e1x = tri + 3 * n; const double* e1y = tri + 4 * n; const double* e1z = tri + 5 * n;
+        const double* e2x = tri + 6 * n; const double* e2y = tri + 7 * n; const double* e2z = tri + 8 * n;
+        const __m128d ox = _mm_set1_pd(ray[0]), oy = _mm_set1_pd(ray[1]), oz = _mm_set1_pd(ray[2]);
+        const __m128d dx = _mm_set1_pd(ray[3]), dy = _mm_set1_pd(ray[4]), dz = _mm_set1_pd(ray[5]);
+        const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0);
+        std::size_t nearest = n;
+
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d E1x = _mm_loadu_pd(e1x + i), E1y = _mm_loadu_pd(e1y + i), E1z = _mm_loadu_pd(e1z + i);
+            const __m128d E2x = _mm_loadu_pd(e2x + i), E2y = _mm_loadu_pd(e2y + i), E2z = _mm_loadu_pd(e2z + i);
+            const __m128d px = _mm_sub_pd(_mm_mul_pd(dy, E2z), _mm_mul_pd(dz, E2y));
+            const __m128d py = _mm_sub_pd(_mm_mul_pd(dz, E2x), _mm_mul_pd(dx, E2z));
+            const __m128d pz = _mm_sub_pd(_mm_mul_pd(dx, E2y), _mm_mul_pd(dy, E2x));
+            const __m128d inv = _mm_div_pd(one,
+                _mm_add_pd(_mm_add_pd(_mm_mul_pd(E1x, px), _mm_mul_pd(E1y, py)), _mm_mul_pd(E1z, pz)));
+            const __m128d sx = _mm_sub_pd(ox, _mm_loadu_pd(v0x + i));
+            const __m128d sy = _mm_sub_pd(oy, _mm_loadu_pd(v0y + i));
+            const __m128d sz = _mm_sub_pd(oz, _mm_loadu_pd(v0z + i));
+            const __m128d u = _mm_mul_pd(
+                _mm_add_pd(_mm_add_pd(_mm_mul_pd(sx, px), _mm_mul_pd(sy, py)), _mm_mul_pd(sz, pz)), inv);
+            const __m128d qx = _mm_sub_pd(_mm_mul_pd(sy, E1z), _mm_mul_pd(sz, E1y));
+            const __m128d qy = _mm_sub_pd(_mm_mul_pd(sz, E1x), _mm_mul_pd(sx, E1z));
+            const __m128d qz = _mm_sub_pd(_mm_mul_pd(sx, E1y), _mm_mul_pd(sy, E1x));
+            const __m128d v = _mm_mul_pd(
+                _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, qx), _mm_mul_pd(dy, qy)), _mm_mul_pd(dz, qz)), inv);
+            const __m128d ti = _mm_mul_pd(
+                _mm_add_pd(_mm_add_pd(_mm_mul_pd(E2x, qx), _mm_mul_pd(E2y, qy)), _mm_mul_pd(E2z, qz)), inv);
+            __m128d hit = _mm_and_pd(_mm_cmpge_pd(u, zero), _mm_cmpge_pd(v, zero));
+            hit = _mm_and_pd(hit, _mm_cmple_pd(_mm_add_pd(u, v), one));
+            hit = _mm_and_pd(hit, _mm_and_pd(_mm_cmpge_pd(ti, zero), _mm_cmplt_pd(ti, _mm_set1_pd(t))));
+            int mask = _mm_movemask_pd(hit);
+            if (!mask) continue;
+            alignas(16) double lanes[2];
+            _mm_store_pd(lanes, ti);
+            for (int l = 0; l < 2; ++l)
+                if (((mask >> l) & 1) && lanes[l] < t) { t = lanes[l]; nearest = i + l; }
+        }
+        const std::size_t rest = IntersectRayTrianglesSoAScalarTail(ray, tri, n, i, t);
+        return (rest != n) ? rest : nearest;
+    }
+
+    SIMD_TARGET("avx2")
+    static std::size_t IntersectRayTrianglesSoAAVX2(const double* ray, const double* tri, std::size_t n, double& t)
+    {
+        const double* v0x = tri;         const double* v0y = tri + n;     const double* v0z = tri + 2 * n;
+        const double* e1x = tri + 3 * n; const double* e1y = tri + 4 * n; const double* e1z = tri + 5 * n;
+        const double* e2x = tri + 6 * n; const double* e2y = tri + 7 * n; const double* e2z = tri + 8 * n;
+        const __m256d ox = _mm256_set1_pd(ray[0]), oy = _mm256_set1_pd(ray[1]), oz = _mm256_set1_pd(ray[2]);
+        const __m256d dx = _mm256_set1_pd(ray[3]), dy = _mm256_set1_pd(ray[4]), dz = _mm256_set1_pd(ray[5]);
+        const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+        std::size_t nearest = n;
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d E1x = _mm256_loadu_pd(e1x + i), E1y = _mm256_loadu_pd(e1y + i), E1z = _mm256_loadu_pd(e1z + i);
+            const __m256d E2x = _mm256_loadu_pd(e2x + i), E2y = _mm256_loadu_pd(e2y + i), E2z = _mm256_loadu_pd(e2z + i);
+            const __m256d px = _mm256_sub_pd(_mm256_mul_pd(dy, E2z), _mm256_mul_pd(dz, E2y));
+            const __m256d py = _mm256_sub_pd(_mm256_mul_pd(dz, E2x), _mm256_mul_pd(dx, E2z));
+            const __m256d pz = _mm256_sub_pd(_mm256_mul_pd(dx, E2y), _mm256_mul_pd(dy, E2x));
+            const __m256d inv = _mm256_div_pd(one,
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(E1x, px), _mm256_mul_pd(E1y, py)), _mm256_mul_pd(E1z, pz)));
+            const __m256d sx = _mm256_sub_pd(ox, _mm256_loadu_pd(v0x + i));
+            const __m256d sy = _mm256_sub_pd(oy, _mm256_loadu_pd(v0y + i));
+            const __m256d sz = _mm256_sub_pd(oz, _mm256_loadu_pd(v0z + i));
+            const __m256d u = _mm256_mul_pd(
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(sx, px), _mm256_mul_pd(sy, py)), _mm256_mul_pd(sz, pz)), inv);
+            const __m256d qx = _mm256_sub_pd(_mm256_mul_pd(sy, E1z), _mm256_mul_pd(sz, E1y));
+            const __m256d qy = _mm256_sub_pd(_mm256_mul_pd(sz, E1x), _mm256_mul_pd(sx, E1z));
+            const __m256d qz = _mm256_sub_pd(_mm256_mul_pd(sx, E1y), _mm256_mul_pd(sy, E1x));
+            const __m256d v = _mm256_mul_pd(
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, qx), _mm256_mul_pd(dy, qy)), _mm256_mul_pd(dz, qz)), inv);
+            const __m256d ti = _mm256_mul_pd(
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(E2x, qx), _mm256_mul_pd(E2y, qy)), _mm256_mul_pd(E2z, qz)), inv);
+            __m256d hit = _mm256_and_pd(_mm256_cmp_pd(u, zero, _CMP_GE_OQ), _mm256_cmp_pd(v, zero, _CMP_GE_OQ));
+            hit = _mm256_and_pd(hit, _mm256_cmp_pd(_mm256_add_pd(u, v), one, _CMP_LE_OQ));
+            hit = _mm256_and_pd(hit, _mm256_and_pd(_mm256_cmp_pd(ti, zero, _CMP_GE_OQ),
+                _mm256_cmp_pd(ti, _mm256_set1_pd(t), _CMP_LT_OQ)));
+            const int mask = _mm256_movemask_pd(hit);
+            if (!mask) continue;
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, ti);
+            for (int l = 0; l < 4; ++l)
+                if (((mask >> l) & 1) && lanes[l] < t) { t = lanes[l]; nearest = i + l; }
+        }
+        const std::size_t rest = IntersectRayTrianglesSoAScalarTail(ray, tri, n, i, t);
+        return (rest != n) ? rest : nearest;
+    }
+#endif
+
+    // ------------------ Dispatch ----------------
+
+    using Mat4MulFn = void (*)(const double*, const double*, double*);
+    using Mat4MulFFn = void (*)(const float*, const float*, float*);
+    using Mat4InverseFn = double (*)(const double*, double*);
+    using AffineSoAFn = void (*)(const double*, const double*, const double*, const double*,
+        double*, double*, double*, std::size_t, double);
+    using ProjectiveSoAFn = void (*)(const double*, const double*, const double*, const double*,
+        double*, double*, double*, std::size_t);
+    using AffineAoSFn = void (*)(const double*, const double*, double*, std::size_t, double);
+    using ProjectiveAoSFn = void (*)(const double*, const double*, double*, std::size_t);
+    using ClassifyBoxesFn = void (*)(const double*, const double*, const double*, const double*,
+        const double*, const double*, const double*, unsigned char*, std::size_t);
+    using RayTrianglesFn = std::size_t (*)(const double*, const double*, std::size_t, double&);
+
+    struct Kernels
+    {
+        Level level;
+        Mat4MulFn mat4Mul;
+        Mat4MulFn mat4MulVec4;
+        AffineSoAFn transformAffineSoA;
+        ProjectiveSoAFn transformProjectiveSoA;
+        AffineAoSFn transformAffineAoS;
+        ProjectiveAoSFn transformProjectiveAoS;
+        Mat4MulFFn mat4MulF;
+        Mat4MulFn affine3x4Mul;
+        Mat4InverseFn mat4Inverse;
+        ClassifyBoxesFn classifyBoxes;
+        RayTrianglesFn rayTriangles;
+    };
+
+    static Kernels Select(Level level)
+    {
+        switch (level)
+        {
+#if SIMD_X86
+        case Level::AVX512:
+            return { level, Mat4MulAVX512, Mat4MulVec4AVX2, TransformAffineSoAAVX512, TransformProjectiveSoAAVX512,
+                TransformAffineAoSAVX2, TransformProjectiveAoSAVX2, Mat4MulFAVX2, Affine3x4MulAVX2, Mat4InverseAVX2,
+                ClassifyBoxesSoAAVX2, IntersectRayTrianglesSoAAVX2 };
+        case Level::AVX2:
+            return { level, Mat4MulAVX2, Mat4MulVec4AVX2, TransformAffineSoAAVX2, TransformProjectiveSoAAVX2,
+                TransformAffineAoSAVX2, TransformProjectiveAoSAVX2, Mat4MulFAVX2, Affine3x4MulAVX2, Mat4InverseAVX2,
+                ClassifyBoxesSoAAVX2, IntersectRayTrianglesSoAAVX2 };
+        case Level::SSE2:
+            return { level, Mat4MulSSE2, Mat4MulVec4SSE2, TransformAffineSoASSE2, TransformProjectiveSoASSE2,
+                TransformAffineAoSSSE2, TransformProjectiveAoSScalar, Mat4MulFSSE2, Affine3x4MulSSE2, Mat4InverseScalar,
+                ClassifyBoxesSoASSE2, IntersectRayTrianglesSoASSE2 };
+#endif
+        default:
+            return { Level::Scalar, Mat4MulScalar, Mat4MulVec4Scalar, TransformAffineSoAScalar, TransformProjectiveSoAScalar,
+                TransformAffineAoSScalar, TransformProjectiveAoSScalar, Mat4MulFScalar, Affine3x4MulScalar, Mat4InverseScalar,
+                ClassifyBoxesSoAScalar, IntersectRayTrianglesSoAScalar };
+        }
+    }
+
+    // One table per level, built once (a function-local static is thread-safe), and
+    // the one in use. Kernels run on several threads at once (JobSystem, the streamer's
+    // loader), so the active table is swapped as a whole through an atomic pointer:
+    // SetActive never leaves a reader with half a table.
+    static const Kernels* Tables()
+    {
+        static const Kernels tables[] = { Select(Level::Scalar), Select(Level::SSE2), Select(Level::AVX2), Select(Level::AVX512) };
+        return tables;
+    }
+
+    static std::atomic<const Kernels*> g_active{ nullptr };
+
+    // Detection runs on first use, so there is no dependency on the static
+    // initialization order between translation units. Threads racing here all pick
+    // the same table.
+    static const Kernels& Table()
+    {
+        const Kernels* k = g_active.load(std::memory_order_acquire);
+        if (!k)
+        {
+            static const Kernels* const detected = &Tables()[static_cast<int>(Detect())];
+            const Kernels* expected = nullptr;
+            g_active.compare_exchange_strong(expected, detected, std::memory_order_acq_rel);
+            k = g_active.load(std::memory_order_acquire);
+        }
+        return *k;
+    }
+
+    Level Active()
+    {
+        return Table().level;
+    }
+
+    void SetActive(Level level)
+    {
+        static const Level best = Detect();
+        if (static_cast<int>(level) > static_cast<int>(best)) level = best;
+        g_active.store(&Tables()[static_cast<int>(level)], std::memory_order_release);
+    }
+
+    void Mat4Mul(const double* a, const double* b, double* out)
+    {
+        Table().mat4Mul(a, b, out);
+    }
+
+    void Mat4MulF(const float* a, const float* b, float* out)
+    {
+        Table().mat4MulF(a, b, out);
+    }
+
+    void Affine3x4Mul(const double* a, const double* b, double* out)
+    {
+        Table().affine3x4Mul(a, b, out);
+    }
+
+    double Mat4Inverse(const double* m, double* out)
+    {
+        return Table().mat4Inverse(m, out);
+    }
+
+    void Mat4MulVec4(const double* m, const double* v, double* out)
+    {
+        Table().mat4MulVec4(m, v, out);
+    }
+
+    void TransformAffineSoA(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n, double w)
+    {
+        Table().transformAffineSoA(m, x, y, z, ox, oy, oz, n, w);
+    }
+
+    void TransformProjectiveSoA(const double* m, const double* x, const double* y, const double* z,
+        double* ox, double* oy, double* oz, std::size_t n)
+    {
+        Table().transformProjectiveSoA(m, x, y, z, ox, oy, oz, n);
+    }
+
+    void TransformAffineAoS(const double* m, const double* in, double* out, std::size_t n, double w)
+    {
+        Table().transformAffineAoS(m, in, out, n, w);
+    }
+
+    void TransformProjectiveAoS(const double* m, const double* in, double* out, std::size_t n)
+    {
+        Table().transformProjectiveAoS(m, in, out, n);
+    }
+
+    void ClassifyBoxesSoA(const double* planes, const double* x0, const double* y0, const double* z0,
+        const double* x1, const double* y1, const double* z1, unsigned char* out, std::size_t n)
+    {
+        Table().classifyBoxes(planes, x0, y0, z0, x1, y1, z1, out, n);
+    }
+
+    std::size_t IntersectRayTrianglesSoA(const double* ray, const double* tri, std::size_t n, double& t)
+    {
+        return Table().rayTriangles(ray, tri, n, t);
+    }
+}
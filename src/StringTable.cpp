@@ -0,0 +1,124 @@
+#include "StringTable.hpp"
+#include <functional>
+
+StringTable::StringTable()
+{
+    Clear();
+}
+
+void StringTable::Clear()
+{
+    strings.clear();
+    keys.clear();
+    sorted.clear();
+    sortedCount = 0;
+    buckets.assign(16, Bucket{});
+    Intern({});
+    SortPending();
+}
+
+StringTable::Id StringTable::Intern(std::string_view s)
+{
+    const uint32_t hash = static_cast<uint32_t>(std::hash<std::string_view>()(s));
+    std::size_t b = Probe(s, hash);
+    if (buckets[b].id != FREE) return buckets[b].id;
+    if (2 * (strings.size() + 1) > buckets.size())
+    {
+        Grow();
+        b = Probe(s, hash);
+    }
+    const Id id = static_cast<Id>(strings.size());
+    strings.emplace_back(s);
+    keys.push_back(Key(s));
+    buckets[b] = { id, hash };
+    sorted.push_back(id);
+    return id;
+}
+
+bool StringTable::Find(std::string_view s, Id& id) const
+{
+    const std::size_t b = Probe(s, static_cast<uint32_t>(std::hash<std::string_view>()(s)));
+    if (buckets[b].id == FREE) return false;
+    id = buckets[b].id;
+    return true;
+}
+
+uint64_t StringTable::Key(std::string_view s)
+{
+    uint64_t key = 0;
+    for (std::size_t k = 0; k < 8; ++k)
+        key = (key << 8) | (k < s.size() ? static_cast<unsigned char>(s[k]) : 0u);
+    return key;
+}
+
+bool StringTable::Less(Id a, Id b) const
+{
+    return keys[a] != keys[b] ? keys[a] < keys[b] : strings[a] < strings[b];
+}
+
+std::size_t StringTable::Probe(std::string_view s, uint32_t hash) const
+{
+    const std::size_t mask = buckets.size() - 1;
+    for (std::size_t b = hash & mask; ; b = (b + 1) & mask)
+    {
+        const Bucket& e = buckets[b];
+        if (e.id == FREE || (e.hash == hash && strings[e.id] == s)) return b;
+    }
+}
+
+void StringTable::Grow()
+{
+    std::vector<Bucket> old(2 * buckets.size());
+    old.swap(buckets);
+    const std::size_t mask = buckets.size() - 1;
+    for (const Bucket& e : old)
+    {
+        if (e.id == FREE) continue;
+        std::size_t b = e.hash & mask;
+        while (buckets[b].id != FREE) b = (b + 1) & mask;
+        buckets[b] = e;
+    }
+}
+
+void StringTable::SortPending() const
+{
+    if (sortedCount == sorted.size()) return;
+    auto less = [this](Id a, Id b) { return Less(a, b); };
+    const auto pending = sorted.begin() + static_cast<std::ptrdiff_t>(sortedCount);
+
+    // Sorted with the first 16 bytes of their strings next to them: most comparisons
+    // touch no string
+    struct Entry {
+        uint64_t key0, key1;
+        Id id;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(static_cast<std::size_t>(sorted.end() - pending));
+    for (auto p = pending; p != sorted.end(); ++p)
+    {
+        const std::string_view str = strings[*p];
+        entries.push_back({ keys[*p], Key(str.size() > 8 ? str.substr(8) : std::string_view()), *p });
+    }
+    std::sort(entries.begin(), entries.end(), [this](const Entry& a, const Entry& b) {
+        if (a.key0 != b.key0) return a.key0 < b.key0;
+        if (a.key1 != b.key1) return a.key1 < b.key1;
+        return strings[a.id] < strings[b.id];
+    });
+    for (std::size_t k = 0; k < entries.size(); ++k) pending[static_cast<std::ptrdiff_t>(k)] = entries[k].id;
+
+    // Each pending id goes after the sorted ones that are not greater: a binary search
+    // per id (they are in order, so each one starts at the last position) and one copy
+    std::vector<Id> merged;
+    merged.reserve(sorted.size());
+    auto from = sorted.begin();
+    for (auto p = pending; p != sorted.end(); ++p)
+    {
+        const auto to = std::upper_bound(from, pending, *p, less);
+        merged.insert(merged.end(), from, to);
+        merged.push_back(*p);
+        from = to;
+    }
+    merged.insert(merged.end(), from, pending);
+    sorted = std::move(merged);
+    sortedCount = sorted.size();
+}
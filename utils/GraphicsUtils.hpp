@@ -17,6 +17,20 @@ namespace GraphicsUtils {
         glUniformMatrix4fv(loc, 1, transpose ? GL_TRUE : GL_FALSE, matFloat);
     }
 
+    // Matrix4x4GL ja t el layout de GLSL: es puja tal qual, sense conversi ni transposici
+    inline void UploadMatrix4(GLuint programId, const char* uniformName, const Matrix4x4GL& mat) {
+        GLint loc = glGetUniformLocation(programId, uniformName);
+        if (loc == -1) return;
+
+        glUniformMatrix4fv(loc, 1, GL_FALSE, mat.m);
+    }
+
+    // View i Projection no canvien durant el frame: es pugen un cop abans del recorregut
+    inline void UploadViewProjection(GLuint programId, const Matrix4x4GL& view, const Matrix4x4GL& proj) {
+        UploadMatrix4(programId, "u_View", view);
+        UploadMatrix4(programId, "u_Projection", proj);
+    }
+
     inline void UploadMVP(GLuint programId, const Matrix4x4& model, const Matrix4x4& view, const Matrix4x4& proj) {
         UploadMatrix4(programId, "u_Model", model);
         UploadMatrix4(programId, "u_View", view);
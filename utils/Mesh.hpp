@@ -1,10 +1,12 @@
 #pragma once
 #include <GL/glew.h>
 #include <vector>
+#include "Picker.hpp"
 
 struct Mesh {
     GLuint vao = 0, vbo = 0, ebo = 0;
     int indexCount = 0;
+    PickMesh triangles; // Copia en CPU dels triangles (seleccio amb el ratoli) i la seva capsa (culling, BVH)
 
     void InitCube() {
         float vertices[] = {
@@ -60,6 +62,8 @@ struct Mesh {
             20, 21, 22, 22, 23, 20
         };
 
+        triangles = PickMesh::FromIndexed(vertices, indices);
+
         indexCount = 36; // 6 cares * 2 triangles * 3 vrtexs
 
         if (vao == 0) glGenVertexArrays(1, &vao);